@@ -0,0 +1,95 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonLog.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Log in the first 500 bytes of EEPROM: 50 records
+iButtonEepromStorage eeprom( 0, 500 );
+iButtonLog auditLog( eeprom );
+
+// Last code read, to log every tag only once while it touches the probe
+iButtonCode last;
+bool touching = false;
+
+/*
+ * Prints all records in the log, oldest first.
+ */
+void printLog( void ) {
+
+  iButtonCode code;
+  uint32_t time;
+
+  Serial.println( "Log:" );
+  auditLog.rewind();
+  while ( auditLog.next( code, &time ) ) {
+    Serial.print( "  " );
+    Serial.print( time );
+    Serial.print( " s: " );
+    ibutton.printCode( code );
+    Serial.println();
+  }
+
+}
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+
+  // Find the end of the log, start a new log if the EEPROM doesn't hold one
+  if ( !eeprom.begin() ) Serial.println( "EEPROM too small!" );
+  if ( !auditLog.begin() ) {
+    Serial.println( "Starting new log" );
+    auditLog.clear();
+  }
+
+  printLog();
+
+}
+
+/*
+ * Main function, read identification code of an iButton tag and add it to the
+ * log. Send any character over the serial port to print the log.
+ */
+void loop( void ) {
+
+  // Variable to store identification code
+  iButtonCode code;
+
+  int8_t status = ibutton.readCode( code );
+  if ( status > 0 ) {
+    if ( !touching || !ibutton.equalCode( code, last ) ) {
+      // Time in seconds since start, use the time of a real-time clock to keep
+      // it meaningful across power loss
+      auditLog.append( code, millis() / 1000 );
+      auditLog.flush();   // Write right away, or records still in RAM may be lost
+      for ( uint8_t i = 0; i < 8; i++ ) last[i] = code[i];
+      Serial.print( "Logged: " );
+      ibutton.printCode( code );
+      Serial.println();
+    }
+    touching = true;
+  } else if ( status == 0 ) {
+    touching = false;
+  }
+
+  if ( Serial.available() > 0 ) {
+    while ( Serial.available() > 0 ) Serial.read();
+    printLog();
+  }
+
+}
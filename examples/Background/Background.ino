@@ -0,0 +1,66 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonBackground.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Setup background reading on the pin
+iButtonBackground background( PIN_PROBE );
+
+// Timer2 interrupt handler for background reading, only on supported boards
+IBUTTON_BACKGROUND_ISR()
+
+// Number of times the main loop ran, while reading in the background
+unsigned long loops = 0;
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+
+  // Set up pin and Timer2
+  if ( !background.begin() ) {
+    Serial.println( "Background reading not supported on this board" );
+    while ( true ) yield();
+  }
+
+  background.startRead();
+
+}
+
+/*
+ * Main function, start reading in the background and continue with other work
+ * until reading is done.
+ */
+void loop(void)
+{
+
+  // Other work, like updating servos, LEDs or network connections
+  loops++;
+
+  if ( !background.done() ) return; // Reading in progress
+
+  int8_t status = background.status();
+  if ( status > 0 ) { // iButton code read successfully
+    Serial.print( "iButton code read: " );
+    iButtonTag::printCode( background.code() );
+    Serial.print( " - main loop ran " );
+    Serial.print( loops );
+    Serial.println( " times while reading" );
+  }
+
+  // Start next read
+  loops = 0;
+  background.startRead();
+
+}
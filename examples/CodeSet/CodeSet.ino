@@ -0,0 +1,130 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonCodeSet.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Number of generated codes for the benchmark, limited by available RAM
+#if defined(__AVR__)
+#define BENCHMARK_CODES 100
+#else
+#define BENCHMARK_CODES 1000
+#endif
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Pre-defined codes to match, change to the codes _you_ want to match! The
+// codes must be sorted, byte-by-byte as read from the data line. The table is
+// stored in flash memory (PROGMEM), so it uses no RAM at all.
+const iButtonCode allowed[] PROGMEM = {
+  { 0x01, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x9A },
+  { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C },
+  { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 }
+};
+iButtonCodeSet allowlist( allowed, sizeof( allowed ) / sizeof( iButtonCode ),
+                          true );
+
+// Table of generated codes for the benchmark
+iButtonCode generated[BENCHMARK_CODES];
+
+/*
+ * Compares lookups in a sorted iButtonCodeSet to a linear scan with equalCode.
+ */
+void benchmark( void ) {
+
+  // Generate codes, already sorted because serial is increasing
+  for ( uint16_t i = 0; i < BENCHMARK_CODES; i++ ) {
+    generated[i][0] = 0x01;
+    generated[i][1] = i >> 8;
+    generated[i][2] = i & 0xFF;
+    for ( uint8_t j = 3; j < 7; j++ ) generated[i][j] = 0x00;
+    ibutton.updateChecksum( generated[i] );
+  }
+  iButtonCodeSet set( generated, BENCHMARK_CODES );
+  set.buildIndex();
+
+  // Look up every code once with a linear scan
+  uint16_t found = 0;
+  unsigned long start = micros();
+  for ( uint16_t i = 0; i < BENCHMARK_CODES; i++ ) {
+    for ( uint16_t j = 0; j < BENCHMARK_CODES; j++ ) {
+      if ( ibutton.equalCode( generated[j], generated[i] ) ) {
+        found++;
+        break;
+      }
+    }
+  }
+  unsigned long linear = micros() - start;
+
+  // Look up every code once in the iButtonCodeSet
+  start = micros();
+  for ( uint16_t i = 0; i < BENCHMARK_CODES; i++ ) {
+    if ( set.contains( generated[i] ) ) found++;
+  }
+  unsigned long indexed = micros() - start;
+
+  Serial.print( "Benchmark, codes: " );
+  Serial.print( BENCHMARK_CODES );
+  Serial.print( ", found: " );
+  Serial.println( found );
+  Serial.print( "  equalCode scan  : " );
+  Serial.print( linear / BENCHMARK_CODES );
+  Serial.println( " us/lookup" );
+  Serial.print( "  iButtonCodeSet  : " );
+  Serial.print( indexed / BENCHMARK_CODES );
+  Serial.println( " us/lookup" );
+
+}
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+
+  // Build the family code index, fails if the table is not sorted
+  if ( !allowlist.buildIndex() ) Serial.println( "Allowlist not sorted!" );
+
+  benchmark();
+
+}
+
+/*
+ * Main function, read identification code of an iButton tag and look it up in
+ * the allowlist.
+ */
+void loop(void)
+{
+
+  // Variable to store identification code
+  iButtonCode code;
+
+  // Try to read an identification code from the probe
+  Serial.println( "Reading... " );
+  int8_t status = ibutton.readCode( code );
+
+  if ( status > 0 ) { // iButton code read successfully
+
+    Serial.print( "iButton code read: " );
+    ibutton.printCode( code ); // Variable _code_ contains the ID-code
+
+    // Look up identification code read from the probe in the allowlist
+    if ( allowlist.contains( code ) ) {
+      Serial.println( " - ALLOWED" );
+    } else {
+      Serial.println( " - not allowed" );
+    }
+
+  }
+
+}
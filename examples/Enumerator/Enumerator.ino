@@ -0,0 +1,81 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonEnumerator.h>
+
+// Data wire of multiple iButton probes is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Maximum number of iButtons on all probes at the same time
+#define MAX_IBUTTONS 8
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Codes of iButtons on the probes, kept by the enumerator
+iButtonCode present[MAX_IBUTTONS];
+
+// Enumerate the iButtons on the probes, using at most 20ms of bus time per scan
+iButtonEnumerator enumerator( ibutton, present, MAX_IBUTTONS, 20000 );
+
+/*
+ * Called once when an iButton is presented to one of the probes.
+ */
+void arrive( const uint8_t* code, int8_t status ) {
+  Serial.print( "iButton arrived: " );
+  ibutton.printCode( code ); // Variable _code_ contains the ID-code
+  Serial.println();
+}
+
+/*
+ * Called once when an iButton is taken off its probe.
+ */
+void depart( const uint8_t* code, int8_t status ) {
+  Serial.print( "iButton departed: " );
+  ibutton.printCode( code );
+  Serial.println();
+}
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+
+  // Set functions to be called on events
+  enumerator.onArrive( arrive );
+  enumerator.onDepart( depart );
+
+  // Only iButtons with family code 0x01 (DS1990A), other devices on the data
+  // line like temperature sensors are skipped
+  enumerator.setFamily( 0x01 );
+
+}
+
+/*
+ * Main function, scan the probes for iButtons arriving and departing. Unlike
+ * example Multiple, only changes are reported. Every scan takes a short time,
+ * however many iButtons there are: a scan may continue where the last one
+ * ended. Other work can be done here too.
+ */
+void loop(void)
+{
+
+  enumerator.scan();
+
+  // Number of iButtons on the probes, updated by scan
+  static uint8_t count = 0;
+  if ( enumerator.count() != count ) {
+    count = enumerator.count();
+    Serial.print( count );
+    Serial.println( " iButton(s) present" );
+  }
+
+}
@@ -0,0 +1,71 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonWatcher.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Watch the probe for iButtons arriving and departing. A code must be read the
+// same 3 times in a row before it counts, the probe is checked every 10ms.
+iButtonWatcher watcher( ibutton, 3, 10 );
+
+/*
+ * Called once when an iButton is presented to the probe.
+ */
+void arrive( const uint8_t* code, int8_t status ) {
+  Serial.print( "iButton arrived: " );
+  ibutton.printCode( code ); // Variable _code_ contains the ID-code
+  Serial.println();
+}
+
+/*
+ * Called once when the iButton is taken off the probe.
+ */
+void depart( const uint8_t* code, int8_t status ) {
+  Serial.print( "iButton departed: " );
+  ibutton.printCode( code );
+  Serial.println();
+}
+
+/*
+ * Called once when an iButton is presented, but its code can't be read.
+ */
+void invalid( const uint8_t* code, int8_t status ) {
+  Serial.println( "iButton code invalid" );
+}
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+
+  // Set functions to be called on events
+  watcher.onArrive( arrive );
+  watcher.onDepart( depart );
+  watcher.onInvalid( invalid );
+
+}
+
+/*
+ * Main function, let the watcher check the probe. Apart from a short presence
+ * check, nothing happens on the data line until an iButton arrives. Other work
+ * can be done here too.
+ */
+void loop(void)
+{
+
+  watcher.poll();
+
+}
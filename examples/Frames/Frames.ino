@@ -0,0 +1,74 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonFrame.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Number of this reader, sent in every frame
+#define READER 1
+
+// Application defined status event: iButton removed from the probe
+#define EVENT_REMOVED 1
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Parser for frames sent by the gateway
+iButtonFrameParser parser;
+
+// Code to be written to the next iButton, sent by the gateway
+iButtonCode pending;
+bool writing = false;
+
+// iButton on the probe at last read
+bool present = false;
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port, the link to the gateway: binary frames only
+  Serial.begin( 115200 );
+
+}
+
+/*
+ * Main function, send identification codes read to the gateway and write codes
+ * received from the gateway.
+ */
+void loop( void ) {
+
+  // Frames sent by the gateway: a write frame holds a code to be written
+  while ( Serial.available() > 0 ) {
+    if ( parser.feed( Serial.read() ) == 1 &&
+         parser.type() == IBUTTON_FRAME_WRITE && parser.code( pending ) ) {
+      writing = true;
+    }
+  }
+
+  // Variable to store identification code
+  iButtonCode code;
+
+  int8_t status = ibutton.readCode( code );
+  if ( status != 0 && !present ) { // iButton arrived, maybe with a read error
+    iButtonFrame::writeCode( Serial, IBUTTON_FRAME_READ, code, status, READER );
+    if ( writing ) {
+      int8_t result = ibutton.writeCode( pending );
+      iButtonFrame::writeCode( Serial, IBUTTON_FRAME_WRITE, pending, result, READER );
+      writing = false;
+    }
+  } else if ( status == 0 && present ) { // iButton removed
+    iButtonFrame::writeStatus( Serial, EVENT_REMOVED, 0, READER );
+  }
+  present = status != 0;
+
+  delay( 100 );
+
+}
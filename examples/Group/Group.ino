@@ -0,0 +1,64 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonTagGroup.h>
+
+// Data wires of four iButton probes are connected to pins 4 to 7, all on port D
+// of an Arduino Uno
+#define PROBES 4
+const uint8_t pins[PROBES] = { 4, 5, 6, 7 };
+
+// Setup iButtonTagGroup on the pins
+iButtonTagGroup group( pins, PROBES );
+
+// Variables to store iButton identification codes and statuses, one per probe
+iButtonCode codes[PROBES];
+int8_t statuses[PROBES];
+int8_t previous[PROBES];
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+  if ( group.count() == 0 ) Serial.println( "Pins not on the same port" );
+
+}
+
+/*
+ * Main function, read all probes at once and report every probe that changes:
+ * an iButton presented or removed.
+ */
+void loop(void)
+{
+
+  // One reset and one READ ROM for all probes, as long as reading a single one
+  group.readCode( codes, statuses );
+
+  for ( uint8_t i = 0; i < group.count(); i++ ) {
+    if ( statuses[i] == previous[i] ) continue;
+    previous[i] = statuses[i];
+    Serial.print( "Probe " );
+    Serial.print( i );
+    if ( statuses[i] == 1 ) {
+      Serial.print( ": " );
+      iButtonTag::printCode( codes[i] );
+      Serial.println();
+    } else if ( statuses[i] == 0 ) {
+      Serial.println( ": removed" );
+    } else {
+      Serial.print( ": read error " );
+      Serial.println( statuses[i] );
+    }
+  }
+
+  delay( 100 );
+
+}
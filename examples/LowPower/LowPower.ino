@@ -0,0 +1,54 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonLowPower.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino, a pin
+// that can interrupt (pin 2 or 3 on Arduino Uno)
+#define PIN_PROBE 2
+
+// Setup iButtonTag on the pin, and low-power waiting for iButtons on it
+iButtonTag ibutton( PIN_PROBE );
+iButtonLowPower sleeper( ibutton, PIN_PROBE );
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+
+  // Sleep until woken by an iButton, or check presence every 250 ms if the pin
+  // can't interrupt
+  if ( sleeper.begin() == IBUTTON_WAKE_INTERRUPT ) {
+    Serial.println( "Sleeping until an iButton touches the probe" );
+  } else {
+    Serial.println( "Checking presence every 250 ms" );
+  }
+
+}
+
+/*
+ * Main function, sleep until an iButton arrives and print its code.
+ */
+void loop( void ) {
+
+  // Variable to store identification code
+  iButtonCode code;
+
+  Serial.flush();                     // Send all output before sleeping
+  sleeper.waitCode( code );
+
+  Serial.print( "iButton code read: " );
+  ibutton.printCode( code );
+  Serial.print( " - " );
+  Serial.print( sleeper.latency() );
+  Serial.println( " us after waking" );
+
+}
@@ -5,6 +5,7 @@
 
 // Include the library
 #include <iButtonTag.h>
+#include <iButtonId.h>
 
 // Data wire of the iButton probe is connected to pin 2 on the Arduino
 #define PIN_PROBE 2
@@ -12,6 +13,12 @@
 // Setup iButtonTag on the pin
 iButtonTag ibutton( PIN_PROBE );
 
+// Pre-defined code to match, change to the code _you_ want to match! The
+// checksum (last byte) is checked when compiling: a typo in the code gives an
+// error. Leave the checksum out to have it filled in.
+constexpr iButtonId matchcode( 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C );
+static_assert( matchcode.valid(), "Checksum of matchcode incorrect" );
+
 /*
  * The setup function.
  */
@@ -32,9 +39,6 @@ void loop(void)
   // Variable to store identification code
   iButtonCode code;
 
-  // Pre-defined code to match, change to the code _you_ want to match!
-  iButtonCode matchcode = { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C };
-
   // Try to read an identification code from the probe
   Serial.println( "Reading... " );
   int8_t status = ibutton.readCode( code );
@@ -44,8 +48,9 @@ void loop(void)
     Serial.print( "iButton code read: " );
     ibutton.printCode( code ); // Variable _code_ contains the ID-code
     
-    // Compare identification code read from the probe to the pre-defined code
-    if ( ibutton.equalCode( code, matchcode ) ) {
+    // Compare identification code read from the probe to the pre-defined code,
+    // a single comparison of the packed codes
+    if ( iButtonId( code ) == matchcode ) {
       Serial.println( " - MATCH FOUND!" );
     } else {
       Serial.println( " - not a match" );
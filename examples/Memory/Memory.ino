@@ -0,0 +1,87 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonMemory.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Variable to store iButton identification code
+iButtonCode code;
+
+/*
+ * Called for every page of memory read, prints it as hexadecimal values.
+ */
+bool printPage( uint16_t address, const uint8_t* data, uint8_t length ) {
+  Serial.print( address, HEX );
+  Serial.print( ":" );
+  for ( uint8_t i = 0; i < length; i++ ) {
+    Serial.print( data[i] < 0x10 ? " 0" : " " );
+    Serial.print( data[i], HEX );
+  }
+  Serial.println();
+  return true;                    // Continue with next page
+}
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+
+}
+
+/*
+ * Main function, read a memory iButton: print all of its memory, one page at
+ * a time without a buffer for all of it, and count the visits of this iButton
+ * in the first two bytes of its memory.
+ */
+void loop(void)
+{
+
+  if ( ibutton.readCode( code ) != 1 ) return;
+
+  iButtonMemory memory( ibutton, code );
+  if ( memory.type() == IBUTTON_MEMORY_NONE ) {
+    Serial.println( "No memory iButton" );
+    delay( 1000 );
+    return;
+  }
+
+  Serial.print( memory.size() );
+  Serial.println( " bytes of memory" );
+  int8_t status = memory.read( 0, memory.size(), printPage );
+  Serial.print( "Read status " );
+  Serial.print( status );
+  Serial.print( ", bus time per KiB: " );
+  Serial.print( memory.busTimePerKiB() / 1000 );
+  Serial.println( "ms" );
+
+  // Visit counter, in NVRAM only
+  if ( memory.type() == IBUTTON_MEMORY_NVRAM ) {
+    uint8_t visits[2];
+    if ( memory.read( 0, visits, 2 ) == 1 ) {
+      uint16_t count = ( visits[0] | visits[1] << 8 ) + 1;
+      visits[0] = count;
+      visits[1] = count >> 8;
+      if ( memory.write( 0, visits, 2 ) == 1 ) {
+        Serial.print( "Visit number " );
+        Serial.println( count );
+      }
+    }
+  }
+
+  // Wait for the iButton to be removed
+  while ( ibutton.checkPresence() == 1 ) delay( 100 );
+
+}
@@ -0,0 +1,82 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonProgrammer.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Codes to write, one per blank tag, change to the codes _you_ want to write!
+// The table is stored in flash memory (PROGMEM), so it uses no RAM at all.
+const iButtonCode batch[] PROGMEM = {
+  { 0x01, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x9A },
+  { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C },
+  { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 }
+};
+
+// Program the codes to blank tags presented one after the other. The type of
+// the blanks is detected on the first tag.
+iButtonProgrammer programmer( ibutton, batch,
+                              sizeof( batch ) / sizeof( iButtonCode ), true );
+
+// Batch finished
+bool finished = false;
+
+/*
+ * Called once for every tag written, or failed to write.
+ */
+void result( uint16_t index, const uint8_t* code, int8_t status ) {
+  Serial.print( "Code " );
+  Serial.print( index + 1 );
+  Serial.print( ": " );
+  ibutton.printCode( code );
+  if ( status == 1 ) {
+    Serial.println( " - written, remove tag" );
+  } else {
+    Serial.print( " - failed with status " );
+    Serial.print( status );
+    Serial.println( ", try next tag" );
+  }
+}
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+  Serial.println( "Present blank tags one after the other" );
+
+  // Set function to be called on results
+  programmer.onResult( result );
+
+}
+
+/*
+ * Main function, let the programmer wait for tags and write them.
+ */
+void loop(void)
+{
+
+  if ( finished ) return;
+
+  if ( programmer.poll() == 1 ) {
+    finished = true;
+    Serial.print( "Batch finished, written: " );
+    Serial.print( programmer.written() );
+    Serial.print( ", failed: " );
+    Serial.print( programmer.failed() );
+    Serial.print( ", tags/minute: " );
+    Serial.println( programmer.tagsPerMinute() );
+  }
+
+}
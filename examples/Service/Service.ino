@@ -0,0 +1,89 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonService.h>
+
+// Data wires of two iButton probes are connected to pins 4 and 5 on the ESP32
+#define PIN_PROBE_DOOR 4
+#define PIN_PROBE_DESK 5
+
+// Setup iButtonTag on each pin
+iButtonTag door( PIN_PROBE_DOOR );
+iButtonTag desk( PIN_PROBE_DESK );
+
+#if IBUTTON_SERVICE_SUPPORTED
+// Read both probes in threads of their own, every 20ms
+iButtonService service( 20 );
+#endif
+
+// New code for iButtons presented to the desk probe, checksum set in setup
+iButtonCode newcode = { 0x01, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x00 };
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 115200 );
+  Serial.println( "iButtonTag Library Demo" );
+  iButtonTag::updateChecksum( newcode );
+
+#if IBUTTON_SERVICE_SUPPORTED
+  // Only arrive, depart and write events by default, not every read
+  service.addReader( door );  // Reader 0
+  service.addReader( desk );  // Reader 1
+  service.start();
+#else
+  Serial.println( "Reader service not supported on this board" );
+  while ( true ) yield();
+#endif
+
+}
+
+/*
+ * Main function, handle the events of both readers. Reading is done by the
+ * reader threads, the main loop never waits for the bus: other work can be
+ * done here too.
+ */
+void loop(void)
+{
+
+#if IBUTTON_SERVICE_SUPPORTED
+  iButtonEvent event;
+  while ( service.poll( event ) ) {
+    Serial.print( event.reader == 0 ? "Door: " : "Desk: " );
+    switch ( event.type ) {
+
+      case IBUTTON_EVENT_ARRIVE:
+        Serial.print( "iButton arrived " );
+        iButtonTag::printCode( event.code );
+        Serial.println();
+        if ( event.reader == 1 && !iButtonTag::equalCode( event.code, newcode ) ) {
+          // Write done by the reader thread, result comes as an event. The
+          // iButton departs and arrives again with the new code.
+          service.requestWrite( 1, newcode );
+        }
+        break;
+
+      case IBUTTON_EVENT_DEPART:
+        Serial.print( "iButton departed " );
+        iButtonTag::printCode( event.code );
+        Serial.println();
+        break;
+
+      case IBUTTON_EVENT_WRITE:
+        Serial.print( "Code written with status " );
+        Serial.println( event.status );
+        break;
+
+    }
+  }
+  delay( 10 );
+#endif
+
+}
@@ -0,0 +1,78 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonStore.h>
+
+// Data wire of the iButton probe is connected to pin 2 on the Arduino
+#define PIN_PROBE 2
+
+// Setup iButtonTag on the pin
+iButtonTag ibutton( PIN_PROBE );
+
+// Allowlist in the first 608 bytes of EEPROM: header and 100 slots, room for
+// 75 codes
+iButtonEepromStorage eeprom( 0, 608 );
+iButtonStore allowlist( eeprom );
+
+// Action for the next code read, changed by sending a character
+char action = ' ';
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // Start serial port
+  Serial.begin( 9600 );
+  Serial.println( "iButtonTag Library Demo" );
+  Serial.println( "Send 'a' to add or 'r' to remove the next iButton read" );
+
+  // Start a new allowlist if the EEPROM doesn't hold one
+  if ( !eeprom.begin() ) Serial.println( "EEPROM too small!" );
+  if ( !allowlist.begin() ) {
+    Serial.println( "Starting new allowlist" );
+    allowlist.clear();
+  }
+  Serial.print( "Codes in allowlist: " );
+  Serial.println( allowlist.count() );
+
+}
+
+/*
+ * Main function, read identification code of an iButton tag and look it up in
+ * the allowlist, or add it to or remove it from the allowlist.
+ */
+void loop( void ) {
+
+  // Variable to store identification code
+  iButtonCode code;
+
+  if ( Serial.available() > 0 ) action = Serial.read();
+
+  int8_t status = ibutton.readCode( code );
+  if ( status > 0 ) { // iButton code read successfully
+
+    ibutton.printCode( code );
+    if ( action == 'a' ) {
+      int8_t result = allowlist.insert( code );
+      if ( result == 1 ) Serial.println( " - added" );
+      else if ( result == 0 ) Serial.println( " - already in allowlist" );
+      else Serial.println( " - can't add" );
+    } else if ( action == 'r' ) {
+      if ( allowlist.remove( code ) ) Serial.println( " - removed" );
+      else Serial.println( " - not in allowlist" );
+    } else if ( allowlist.contains( code ) ) {
+      Serial.println( " - ALLOWED" );
+    } else {
+      Serial.println( " - not allowed" );
+    }
+    action = ' ';
+    delay( 1000 );
+
+  }
+
+}
@@ -0,0 +1,45 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+// Include the library
+#include <iButtonTag.h>
+#include <iButtonUartBus.h>
+
+// Serial port connected to the data line: RX directly, TX through a Schottky
+// diode with its cathode to TX. On boards with a second serial port, like
+// Arduino Mega or Leonardo, use Serial1 and keep Serial for messages.
+#define SERIAL_PROBE Serial
+
+// Setup the UART bus backend on the serial port, and iButtonTag on the backend
+iButtonUartBus uart( SERIAL_PROBE );
+iButtonTag ibutton( uart );
+
+/*
+ * The setup function.
+ */
+void setup( void ) {
+
+  // The serial port is in use by the data line, show results on the LED
+  pinMode( LED_BUILTIN, OUTPUT );
+
+}
+
+/*
+ * Main function, read identification code of an iButton tag and switch on the
+ * LED while a valid code is read.
+ */
+void loop( void ) {
+
+  // Variable to store identification code
+  iButtonCode code;
+
+  // Try to read an identification code from the probe, the time slots are
+  // generated by the UART
+  int8_t status = ibutton.readCode( code );
+
+  digitalWrite( LED_BUILTIN, status > 0 ? HIGH : LOW );
+  delay( 100 );
+
+}
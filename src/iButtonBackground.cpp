@@ -0,0 +1,348 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonBackground.h"
+
+
+// TIMER2 SETTINGS
+
+#if IBUTTON_BACKGROUND_SUPPORTED
+// Prescaler keeps the longest interval, 480 microseconds, within 8 bits
+#if F_CPU > 16000000UL
+#define TIMER_PRESCALER 64
+#define TIMER_CLOCK_SELECT ( _BV( CS22 ) )
+#else
+#define TIMER_PRESCALER 32
+#define TIMER_CLOCK_SELECT ( _BV( CS21 ) | _BV( CS20 ) )
+#endif
+
+// Timer ticks for an interval in microseconds, at least one: short intervals
+// round down to zero at a low clock
+#define TICKS_EXACT( us ) ( (uint32_t) ( us ) * ( F_CPU / 1000000UL ) / TIMER_PRESCALER )
+#define TICKS( us ) ( TICKS_EXACT( us ) > 0 ? TICKS_EXACT( us ) : 1 )
+
+// Data line: drive low or release to pull-up resistor, and read
+#define LINE_LOW()     { *_output &= ~_mask; *_mode |= _mask; }
+#define LINE_RELEASE() { *_mode &= ~_mask; }
+#define LINE_READ()    ( ( *_input & _mask ) ? 1 : 0 )
+#endif
+
+// Time slot values
+#define SLOT_DONE  -1
+#define SLOT_READ   2
+
+
+// Object with transaction in progress
+iButtonBackground* volatile iButtonBackground::_active = NULL;
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonBackground object linked to the supplied pin.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBackground
+ */
+iButtonBackground::iButtonBackground( uint8_t pin ) {
+  _pin = pin;
+  _mode = NULL;
+  _output = NULL;
+  _input = NULL;
+  _mask = 0;
+  _status = 0;
+  _lastDiscrepancy = 0;
+  _lastDevice = false;
+  for ( uint8_t i = 0; i < 8; i++ ) _code[i] = 0x00;
+}
+
+/*
+ * Sets up the pin and Timer2 for background transactions.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginBackground
+ */
+bool iButtonBackground::begin() {
+#if IBUTTON_BACKGROUND_SUPPORTED
+  // Resolve registers and bitmask of the pin once, the interrupt handler uses
+  // them directly
+  uint8_t port = digitalPinToPort( _pin );
+  if ( port == NOT_A_PIN ) return false;
+  _mode = portModeRegister( port );
+  _output = portOutputRegister( port );
+  _input = portInputRegister( port );
+  _mask = digitalPinToBitMask( _pin );
+  LINE_RELEASE();
+
+  // Timer2 in CTC mode, interrupt enabled only during transactions
+  TIMSK2 &= ~_BV( OCIE2A );
+  TCCR2A = _BV( WGM21 );
+  TCCR2B = TIMER_CLOCK_SELECT;
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*
+ * Starts reading one single iButtonCode in the background.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#startRead
+ */
+int8_t iButtonBackground::startRead( bool old /* = false */ ) {
+  // READ ROM command, 0x0F for compatibility with DS1990
+  return start( TRANSACTION_READ, old ? 0x0F : 0x33 );
+}
+
+/*
+ * Starts the search for multiple iButtonCode's in the background.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#startSearch
+ */
+int8_t iButtonBackground::startSearch() {
+  if ( _active ) return 0;
+  _lastDiscrepancy = 0;
+  _lastDevice = false;
+  return startNext();
+}
+
+/*
+ * Continues the search for multiple iButtonCode's in the background.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#startNext
+ */
+int8_t iButtonBackground::startNext() {
+  if ( _active ) return 0;
+  if ( _lastDevice ) {                     // No more iButtons, no transaction
+    _lastDevice = false;
+    _lastDiscrepancy = 0;
+    _status = 0;
+    return 0;
+  }
+  return start( TRANSACTION_SEARCH, 0xF0 );
+}
+
+/*
+ * Handles the Timer2 compare interrupt for the object with a transaction in
+ * progress.
+ */
+void iButtonBackground::handleInterrupt() {
+  if ( _active ) _active -> interrupt();
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Starts a transaction, the first interrupt follows right away.
+ *
+ * Return values:
+ *   IBUTTON_BUSY - Transaction started
+ *   0            - Not started: not supported, begin not called or another
+ *                  transaction in progress
+ */
+int8_t iButtonBackground::start( uint8_t transaction, uint8_t command ) {
+#if IBUTTON_BACKGROUND_SUPPORTED
+  if ( _active || _mode == NULL ) return 0;
+  _transaction = transaction;
+  _command = command;
+  _phase = PHASE_RESET;
+  _slot = 0;
+  _lastZero = 0;
+  if ( transaction == TRANSACTION_READ )
+    for ( uint8_t i = 0; i < 8; i++ ) _code[i] = 0x00;
+  _status = IBUTTON_BUSY;
+  _active = this;
+
+  noInterrupts();
+  TCNT2 = 0;
+  OCR2A = 1;
+  TIFR2 = _BV( OCF2A );
+  TIMSK2 |= _BV( OCIE2A );
+  interrupts();
+  return IBUTTON_BUSY;
+#else
+  (void) transaction;
+  (void) command;
+  return 0;
+#endif
+}
+
+/*
+ * Takes the next step of the transaction, called from the interrupt handler.
+ *
+ * Each step sets the time of the next interrupt first: the timer restarts at
+ * every compare match, so the time spent in this function is part of it. Only
+ * the short parts of time slots are timed with busy waiting, the CPU is free
+ * for the application during reset, recovery and most of every time slot.
+ */
+void iButtonBackground::interrupt() {
+#if IBUTTON_BACKGROUND_SUPPORTED
+  switch ( _phase ) {
+
+    case PHASE_RESET:
+      // RESET pulse: data line low for 480 microseconds
+      next( TICKS( 480 ) );
+      LINE_LOW();
+      _phase = PHASE_PRESENCE;
+      return;
+
+    case PHASE_PRESENCE:
+      // Release data line, devices assert presence within 70 microseconds
+      next( TICKS( 70 ) );
+      LINE_RELEASE();
+      _phase = PHASE_RECOVER;
+      return;
+
+    case PHASE_RECOVER:
+      // Sample presence, then wait for the end of the presence pulse
+      if ( LINE_READ() ) {                 // No device asserted presence
+        if ( _transaction == TRANSACTION_SEARCH ) {  // Search starts over
+          _lastDiscrepancy = 0;
+          _lastDevice = false;
+        }
+        finish( 0 );
+        return;
+      }
+      next( TICKS( 410 ) );
+      _phase = PHASE_SLOT;
+      return;
+
+    case PHASE_SLOT: {
+      int8_t value = slotValue();
+      if ( value == SLOT_DONE ) {
+        if ( _transaction == TRANSACTION_SEARCH ) {
+          _lastDiscrepancy = _lastZero;
+          _lastDevice = _lastZero == 0;
+        }
+        finish( iButtonTag::testCode( _code ) );
+        return;
+      }
+      if ( value == 0 ) {
+        // Write 0: data line low for 60 microseconds, released next step
+        next( TICKS( 60 ) );
+        LINE_LOW();
+        _phase = PHASE_RELEASE;
+        return;
+      }
+      // Write 1 or read: short low pulse, a device holds the line low to
+      // read a 0. Sample within 15 microseconds from the start of the slot.
+      next( TICKS( 70 ) );
+      LINE_LOW();
+      delayMicroseconds( 3 );
+      LINE_RELEASE();
+      if ( value == SLOT_READ ) {
+        delayMicroseconds( 8 );
+        if ( !slotSample( LINE_READ() ) ) return;
+      }
+      _slot++;
+      return;
+    }
+
+    case PHASE_RELEASE:
+      // End of write 0, recovery time before next time slot
+      next( TICKS( 10 ) );
+      LINE_RELEASE();
+      _slot++;
+      _phase = PHASE_SLOT;
+      return;
+
+  }
+#endif
+}
+
+/*
+ * Returns what to do in the current time slot.
+ *
+ * Return values:
+ *   0 or 1    - Write this bit
+ *   SLOT_READ - Read a bit
+ *   SLOT_DONE - Transaction complete
+ */
+int8_t iButtonBackground::slotValue() {
+  // ROM command, LSB-first
+  if ( _slot < 8 ) return ( _command >> _slot ) & 0x01;
+
+  // READ ROM: 64 bits read
+  if ( _transaction == TRANSACTION_READ ) return _slot < 72 ? SLOT_READ : SLOT_DONE;
+
+  // SEARCH ROM: for each of 64 bits read bit, read complement, write direction
+  uint8_t k = _slot - 8;
+  if ( k >= 192 ) return SLOT_DONE;
+  return k % 3 == 2 ? _direction : SLOT_READ;
+}
+
+/*
+ * Processes a bit read in the current time slot.
+ *
+ * Return values:
+ *   true  - Transaction continues
+ *   false - Transaction finished
+ */
+bool iButtonBackground::slotSample( uint8_t sample ) {
+  if ( _transaction == TRANSACTION_READ ) {
+    uint8_t i = _slot - 8;
+    if ( sample ) _code[i >> 3] |= 1 << ( i & 0x07 );
+    return true;
+  }
+
+  // SEARCH ROM, same algorithm as OneWire::search. Keep the bit read first in
+  // _direction until its complement is read.
+  uint8_t k = _slot - 8;
+  if ( k % 3 == 0 ) {
+    _direction = sample;
+    return true;
+  }
+  uint8_t i = k / 3;                       // Bit index 0-63
+  uint8_t n = i + 1;                       // Bit number 1-64
+  uint8_t id = _direction;
+  if ( id && sample ) {                    // No devices in search
+    _lastDiscrepancy = 0;
+    _lastDevice = false;
+    finish( 0 );
+    return false;
+  }
+  if ( id != sample ) {
+    _direction = id;                       // All devices have same bit
+  } else {
+    // Discrepancy: take same branch as before up to last discrepancy, then
+    // branch 1 at last discrepancy and branch 0 after it
+    if ( n < _lastDiscrepancy ) _direction = ( _code[i >> 3] >> ( i & 0x07 ) ) & 0x01;
+    else _direction = n == _lastDiscrepancy;
+    if ( _direction == 0 ) _lastZero = n;
+  }
+  if ( _direction ) _code[i >> 3] |= 1 << ( i & 0x07 );
+  else _code[i >> 3] &= ~( 1 << ( i & 0x07 ) );
+  return true;
+}
+
+/*
+ * Ends the transaction with its final status.
+ */
+void iButtonBackground::finish( int8_t status ) {
+#if IBUTTON_BACKGROUND_SUPPORTED
+  TIMSK2 &= ~_BV( OCIE2A );
+  LINE_RELEASE();
+#endif
+  _active = NULL;
+  _status = status;
+}
+
+/*
+ * Sets the time from the last compare match to the next interrupt, in timer
+ * ticks.
+ */
+void iButtonBackground::next( uint16_t ticks ) {
+#if IBUTTON_BACKGROUND_SUPPORTED
+  OCR2A = ticks > 1 ? ticks - 1 : 0;
+#else
+  (void) ticks;
+#endif
+}
@@ -0,0 +1,83 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonBackground_h
+#define iButtonBackground_h
+
+// Includes
+#include <inttypes.h>
+#include <Arduino.h>
+#include "iButtonTag.h"
+
+// Background reading uses Timer2, only available on AVR targets that have it
+#if defined(__AVR__) && defined(TCCR2A) && defined(OCIE2A)
+#define IBUTTON_BACKGROUND_SUPPORTED 1
+#define IBUTTON_BACKGROUND_ISR() \
+  ISR( TIMER2_COMPA_vect ) { iButtonBackground::handleInterrupt(); }
+#else
+#define IBUTTON_BACKGROUND_SUPPORTED 0
+#define IBUTTON_BACKGROUND_ISR()
+#endif
+
+// Class definition
+class iButtonBackground {
+
+  public:
+    // Constructor
+    iButtonBackground( uint8_t );
+
+    // Functions
+    bool begin();
+    int8_t startRead( bool = false );
+    int8_t startSearch();
+    int8_t startNext();
+    int8_t status() const { return _status; }
+    bool done() const { return _status != IBUTTON_BUSY; }
+    const uint8_t* code() const { return _code; }
+
+    // Interrupt handler, called by IBUTTON_BACKGROUND_ISR
+    static void handleInterrupt();
+
+  private:
+    // Transactions and phases
+    enum { TRANSACTION_READ, TRANSACTION_SEARCH };
+    enum { PHASE_RESET, PHASE_PRESENCE, PHASE_RECOVER, PHASE_SLOT,
+           PHASE_RELEASE };
+
+    // Object with transaction in progress
+    static iButtonBackground* volatile _active;
+
+    // Pin, registers and bitmask resolved once in the constructor
+    uint8_t _pin;
+    volatile uint8_t* _mode;
+    volatile uint8_t* _output;
+    volatile uint8_t* _input;
+    uint8_t _mask;
+
+    // Transaction in progress
+    volatile int8_t _status;   // IBUTTON_BUSY until finished
+    uint8_t _transaction;
+    uint8_t _command;          // ROM command
+    uint8_t _phase;
+    uint8_t _slot;             // Time slot within transaction
+    uint8_t _direction;        // Search direction of current bit
+    uint8_t _lastZero;         // Bit number of last zero taken at discrepancy
+    iButtonCode _code;
+
+    // Search state, kept between transactions
+    uint8_t _lastDiscrepancy;
+    bool _lastDevice;
+
+    // Functions
+    int8_t start( uint8_t, uint8_t );
+    void interrupt();
+    int8_t slotValue();
+    bool slotSample( uint8_t );
+    void finish( int8_t );
+    void next( uint16_t );
+
+};
+
+#endif // iButtonBackground_h
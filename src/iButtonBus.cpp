@@ -0,0 +1,247 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonBus.h"
+
+#if IBUTTON_OVERDRIVE_PIN
+#include <util/OneWire_direct_gpio.h>
+#endif
+
+
+// CONSTANTS
+
+// Timing of resets and time slots at overdrive speed, in microseconds. Based
+// on Maxim application note 126, rounded to whole microseconds.
+#define OVERDRIVE_RESET_LOW   70 // Reset pulse
+#define OVERDRIVE_PRESENCE     8 // Release to sampling presence
+#define OVERDRIVE_RESET_END   40 // Sampling presence to end of reset
+#define OVERDRIVE_PULSE        1 // Write 1 and read: low pulse
+#define OVERDRIVE_SAMPLE       1 // Read: release to sampling
+#define OVERDRIVE_ZERO_LOW     8 // Write 0: low pulse
+#define OVERDRIVE_SLOT_END     8 // Write 1 and read: release to end of slot
+#define OVERDRIVE_RECOVERY     3 // Write 0: release to end of slot
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs the common part of a bus backend.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+iButtonBus::iButtonBus() {
+  iButtonBus::resetSearch();
+}
+
+/*
+ * Writes a byte to the data line, least significant bit first.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+void iButtonBus::write( uint8_t b ) {
+  for ( uint8_t mask = 0x01; mask; mask <<= 1 ) writeBit( ( b & mask ) ? 1 : 0 );
+}
+
+/*
+ * Reads a byte from the data line, least significant bit first.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+uint8_t iButtonBus::read() {
+  uint8_t b = 0;
+  for ( uint8_t mask = 0x01; mask; mask <<= 1 ) if ( readBit() ) b |= mask;
+  return b;
+}
+
+/*
+ * Resets the search domain, next search starts with the first device.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+void iButtonBus::resetSearch() {
+  _lastDiscrepancy = 0;
+  _lastDevice = false;
+  for ( uint8_t i = 0; i < 8; i++ ) _rom[i] = 0;
+}
+
+/*
+ * Resets the search domain to a family, next search starts with the first
+ * device having the family code.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+void iButtonBus::targetSearch( uint8_t family ) {
+  // Take the path of the family code and zeros after it, as if the last search
+  // ended with a discrepancy at the last bit: the first search takes the
+  // 0-branch after the family code everywhere
+  iButtonBus::resetSearch();
+  _rom[0] = family;
+  _lastDiscrepancy = 64;
+}
+
+/*
+ * Searches the next device on the data line, returns 1 when found and 0 when
+ * there are no more devices.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+uint8_t iButtonBus::search( uint8_t* code ) {
+  if ( _lastDevice ) return 0;
+  if ( reset() == 0 ) {
+    resetSearch();
+    return 0;
+  }
+  write( 0xF0 ); // SEARCH ROM
+
+  // Every bit the devices still in the search answer with the bit and its
+  // complement, the master writes the branch to follow. On a discrepancy take
+  // the same branch as last time before the last discrepancy, the 1-branch at
+  // it and the 0-branch after it.
+  uint8_t lastZero = 0;
+  for ( uint8_t id = 1; id <= 64; id++ ) {
+    uint8_t i = ( id - 1 ) >> 3;
+    uint8_t mask = 1 << ( ( id - 1 ) & 7 );
+    uint8_t bit = readBit();
+    uint8_t complement = readBit();
+    if ( bit && complement ) { // No devices left in the search
+      resetSearch();
+      return 0;
+    }
+    uint8_t direction;
+    if ( bit != complement ) direction = bit;
+    else if ( id < _lastDiscrepancy ) direction = ( _rom[i] & mask ) ? 1 : 0;
+    else direction = id == _lastDiscrepancy ? 1 : 0;
+    if ( direction == 0 && bit == complement ) lastZero = id;
+    if ( direction ) _rom[i] |= mask;
+    else _rom[i] &= ~mask;
+    writeBit( direction );
+  }
+
+  _lastDiscrepancy = lastZero;
+  if ( _lastDiscrepancy == 0 ) _lastDevice = true;
+  for ( uint8_t i = 0; i < 8; i++ ) code[i] = _rom[i];
+  return 1;
+}
+
+/*
+ * Constructs an iButtonOneWireBus object without pin, for use as member of a
+ * class: iButtonTag objects constructed on another backend.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+iButtonOneWireBus::iButtonOneWireBus() {
+  _overdrive = false;
+#if IBUTTON_OVERDRIVE_PIN
+  _reg = NULL;
+  _mask = 0;
+#endif
+}
+
+/*
+ * Constructs an iButtonOneWireBus object on the supplied pin.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+iButtonOneWireBus::iButtonOneWireBus( uint8_t pin ) : _wire( pin ) {
+  _overdrive = false;
+#if IBUTTON_OVERDRIVE_PIN
+  _reg = PIN_TO_BASEREG( pin );
+  _mask = PIN_TO_BITMASK( pin );
+#endif
+}
+
+/*
+ * Switches resets and time slots to overdrive speed or back to standard speed,
+ * returns true when running at the requested speed.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonBus
+ */
+bool iButtonOneWireBus::overdrive( bool on ) {
+#if IBUTTON_OVERDRIVE_PIN
+  if ( _reg == NULL ) return !on;
+  _overdrive = on;
+  return true;
+#else
+  return !on;
+#endif
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Resets the data line at overdrive speed, returns 1 if at least one device
+ * asserted presence.
+ */
+uint8_t iButtonOneWireBus::fastReset() {
+#if IBUTTON_OVERDRIVE_PIN
+  IO_REG_TYPE mask IO_REG_MASK_ATTR = _mask;
+  volatile IO_REG_TYPE* reg IO_REG_BASE_ATTR = _reg;
+
+  noInterrupts();
+  DIRECT_WRITE_LOW( reg, mask );
+  DIRECT_MODE_OUTPUT( reg, mask );
+  delayMicroseconds( OVERDRIVE_RESET_LOW );
+  DIRECT_MODE_INPUT( reg, mask );
+  delayMicroseconds( OVERDRIVE_PRESENCE );
+  uint8_t presence = DIRECT_READ( reg, mask ) ? 0 : 1;
+  interrupts();
+  delayMicroseconds( OVERDRIVE_RESET_END );
+  return presence;
+#else
+  return 0;
+#endif
+}
+
+/*
+ * Writes a single bit at overdrive speed. Interrupts are enabled again as soon
+ * as the data line is released: they can only make the slot longer then.
+ */
+void iButtonOneWireBus::fastWriteBit( uint8_t b ) {
+#if IBUTTON_OVERDRIVE_PIN
+  IO_REG_TYPE mask IO_REG_MASK_ATTR = _mask;
+  volatile IO_REG_TYPE* reg IO_REG_BASE_ATTR = _reg;
+
+  noInterrupts();
+  DIRECT_WRITE_LOW( reg, mask );
+  DIRECT_MODE_OUTPUT( reg, mask );
+  delayMicroseconds( b ? OVERDRIVE_PULSE : OVERDRIVE_ZERO_LOW );
+  DIRECT_MODE_INPUT( reg, mask );
+  interrupts();
+  delayMicroseconds( b ? OVERDRIVE_SLOT_END : OVERDRIVE_RECOVERY );
+#else
+  (void) b;
+#endif
+}
+
+/*
+ * Reads a single bit at overdrive speed.
+ */
+uint8_t iButtonOneWireBus::fastReadBit() {
+#if IBUTTON_OVERDRIVE_PIN
+  IO_REG_TYPE mask IO_REG_MASK_ATTR = _mask;
+  volatile IO_REG_TYPE* reg IO_REG_BASE_ATTR = _reg;
+
+  noInterrupts();
+  DIRECT_WRITE_LOW( reg, mask );
+  DIRECT_MODE_OUTPUT( reg, mask );
+  delayMicroseconds( OVERDRIVE_PULSE );
+  DIRECT_MODE_INPUT( reg, mask );
+  delayMicroseconds( OVERDRIVE_SAMPLE );
+  uint8_t b = DIRECT_READ( reg, mask ) ? 1 : 0;
+  interrupts();
+  delayMicroseconds( OVERDRIVE_SLOT_END - OVERDRIVE_SAMPLE );
+  return b;
+#else
+  return 1;
+#endif
+}
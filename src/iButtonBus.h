@@ -0,0 +1,102 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonBus_h
+#define iButtonBus_h
+
+// Includes
+#include <inttypes.h>
+#include <OneWire.h>
+
+// Overdrive speed on a pin needs the direct pin access of the OneWire library,
+// and a fast MCU: time slots are 10 microseconds, pulses 1 microsecond
+#if defined(__has_include)
+#if __has_include(<util/OneWire_direct_gpio.h>)
+#if !defined(__AVR__) || F_CPU >= 16000000L
+#define IBUTTON_OVERDRIVE_PIN 1
+#endif
+#endif
+#endif
+#ifndef IBUTTON_OVERDRIVE_PIN
+#define IBUTTON_OVERDRIVE_PIN 0
+#endif
+
+// Class definition, interface of a 1-Wire bus backend
+class iButtonBus {
+
+  public:
+    // Constructor and destructor
+    iButtonBus();
+    virtual ~iButtonBus() {}
+
+    // Bus operations
+    virtual uint8_t reset() = 0;
+    virtual void writeBit( uint8_t ) = 0;
+    virtual uint8_t readBit() = 0;
+    virtual void write( uint8_t );
+    virtual uint8_t read();
+    virtual void depower() {}
+
+    // Speed of resets and time slots, only standard speed unless overridden
+    virtual bool overdrive( bool on ) { return !on; }
+
+    // Search, algorithm of Maxim application note 187
+    virtual void resetSearch();
+    virtual void targetSearch( uint8_t );
+    virtual uint8_t search( uint8_t* );
+
+  private:
+    // State of search
+    uint8_t _rom[8];
+    uint8_t _lastDiscrepancy;
+    bool _lastDevice;
+
+};
+
+// Class definition, bus backend bit-banging a pin with the OneWire library
+class iButtonOneWireBus : public iButtonBus {
+
+  public:
+    // Constructors
+    iButtonOneWireBus();
+    iButtonOneWireBus( uint8_t );
+
+    // Bus operations, at overdrive speed not by the OneWire library
+    uint8_t reset() { return _overdrive ? fastReset() : _wire.reset(); }
+    void writeBit( uint8_t b ) { if ( _overdrive ) fastWriteBit( b ); else _wire.write_bit( b ); }
+    uint8_t readBit() { return _overdrive ? fastReadBit() : _wire.read_bit(); }
+    void write( uint8_t b ) { if ( _overdrive ) iButtonBus::write( b ); else _wire.write( b ); }
+    uint8_t read() { return _overdrive ? iButtonBus::read() : _wire.read(); }
+    void depower() { _wire.depower(); }
+    bool overdrive( bool );
+
+    // Search, using the implementation of the OneWire library at standard speed
+    void resetSearch() { _wire.reset_search(); iButtonBus::resetSearch(); }
+    void targetSearch( uint8_t family ) {
+      _wire.target_search( family );
+      iButtonBus::targetSearch( family );
+    }
+    uint8_t search( uint8_t* code ) {
+      if ( _overdrive ) return iButtonBus::search( code );
+      return _wire.search( code ) ? 1 : 0;
+    }
+
+  private:
+    // OneWire instance, stored by value: no heap allocation
+    OneWire _wire;
+
+    // Overdrive speed, driving the pin directly
+    bool _overdrive;
+#if IBUTTON_OVERDRIVE_PIN
+    IO_REG_TYPE _mask;
+    volatile IO_REG_TYPE* _reg;
+#endif
+    uint8_t fastReset();
+    void fastWriteBit( uint8_t );
+    uint8_t fastReadBit();
+
+};
+
+#endif // iButtonBus_h
@@ -0,0 +1,164 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonCodeSet.h"
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonCodeSet object on a sorted table of iButtonCode's.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonCodeSet
+ */
+iButtonCodeSet::iButtonCodeSet( const iButtonCode* codes, uint16_t count,
+                                bool progmem /* = false */ ) {
+  _codes = (const uint8_t*) codes;
+  _count = count;
+  _progmem = progmem;
+  _families = 0;
+}
+
+/*
+ * Builds the family code index of the table.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#buildIndex
+ */
+bool iButtonCodeSet::buildIndex() {
+  _families = 0;
+
+  // Walk the table once, recording where each family code starts. The table is
+  // sorted, so entries with the same family code are adjacent. Also confirm
+  // the table really is sorted: lookups rely on it.
+  uint8_t n = 0;
+  for ( uint16_t i = 0; i < _count; i++ ) {
+    uint8_t family = readByte( i, 0 );
+    if ( i > 0 ) {
+      iButtonCode previous;
+      getCode( i - 1, previous );
+      if ( compareEntry( i, previous, 0 ) < 0 ) return false; // Not sorted
+      if ( family == _family[n - 1] ) continue;
+    }
+    if ( n == IBUTTON_CODESET_FAMILIES ) return false;        // Too many
+    _family[n] = family;
+    _first[n] = i;
+    n++;
+  }
+  _first[n] = _count;
+
+  // Index complete, use it for lookups from now on
+  _families = n;
+  return true;
+}
+
+/*
+ * Looks up an iButtonCode in the table.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#indexOf
+ */
+int32_t iButtonCodeSet::indexOf( const uint8_t* code ) const {
+  // Determine search range, narrowed to one family code if index is available
+  uint16_t low = 0;
+  uint16_t high = _count;
+  uint8_t from = 0;
+  if ( _families > 0 ) {
+    uint8_t f;
+    for ( f = 0; f < _families; f++ ) if ( _family[f] == code[0] ) break;
+    if ( f == _families ) return -1; // Family code not in table, no compares
+    low = _first[f];
+    high = _first[f + 1];
+    from = 1;                        // Family code already known to match
+  }
+
+  // Binary search in range [low, high)
+  while ( low < high ) {
+    uint16_t middle = low + ( ( high - low ) >> 1 );
+    int8_t c = compareEntry( middle, code, from );
+    if ( c == 0 ) return middle;
+    if ( c < 0 ) low = middle + 1;
+    else high = middle;
+  }
+  return -1;
+}
+
+/*
+ * Copies an iButtonCode from the table.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#getCode
+ */
+void iButtonCodeSet::getCode( uint16_t index, uint8_t* code ) const {
+  for ( uint8_t i = 0; i < 8; i++ ) code[i] = readByte( index, i );
+}
+
+/*
+ * Sorts a table of iButtonCode's in RAM for use with iButtonCodeSet.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#sortCodes
+ */
+void iButtonCodeSet::sortCodes( iButtonCode* codes, uint16_t count ) {
+  // Shell sort: in place, small code size and fast enough for tables that fit
+  // in RAM
+  for ( uint16_t gap = count >> 1; gap > 0; gap >>= 1 ) {
+    for ( uint16_t i = gap; i < count; i++ ) {
+      iButtonCode temp;
+      for ( uint8_t k = 0; k < 8; k++ ) temp[k] = codes[i][k];
+      uint16_t j = i;
+      for ( ; j >= gap && compareCode( codes[j - gap], temp ) > 0; j -= gap ) {
+        for ( uint8_t k = 0; k < 8; k++ ) codes[j][k] = codes[j - gap][k];
+      }
+      for ( uint8_t k = 0; k < 8; k++ ) codes[j][k] = temp[k];
+    }
+  }
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Reads one byte of a table entry, from RAM or PROGMEM.
+ */
+uint8_t iButtonCodeSet::readByte( uint16_t index, uint8_t i ) const {
+  const uint8_t* p = _codes + ( (uint32_t) index << 3 ) + i;
+  return _progmem ? pgm_read_byte( p ) : *p;
+}
+
+/*
+ * Compares table entry to iButtonCode, starting at byte position _from_.
+ *
+ * Return values:
+ *   <0 - Table entry sorts before code
+ *    0 - Table entry equals code
+ *   >0 - Table entry sorts after code
+ */
+int8_t iButtonCodeSet::compareEntry( uint16_t index, const uint8_t* code,
+                                     uint8_t from ) const {
+  for ( uint8_t i = from; i < 8; i++ ) {
+    uint8_t b = readByte( index, i );
+    if ( b != code[i] ) return b < code[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+/*
+ * Compares two iButtonCode's in RAM, byte-by-byte as read from the data line.
+ *
+ * Return values:
+ *   <0 - Code a sorts before code b
+ *    0 - Codes are equal
+ *   >0 - Code a sorts after code b
+ */
+int8_t iButtonCodeSet::compareCode( const uint8_t* a, const uint8_t* b ) {
+  for ( uint8_t i = 0; i < 8; i++ ) {
+    if ( a[i] != b[i] ) return a[i] < b[i] ? -1 : 1;
+  }
+  return 0;
+}
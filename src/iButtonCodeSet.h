@@ -0,0 +1,55 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonCodeSet_h
+#define iButtonCodeSet_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+
+// Maximum number of distinct family codes in the family index
+#ifndef IBUTTON_CODESET_FAMILIES
+#define IBUTTON_CODESET_FAMILIES 4
+#endif
+
+// Class definition
+class iButtonCodeSet {
+
+  public:
+    // Constructor
+    iButtonCodeSet( const iButtonCode*, uint16_t, bool = false );
+
+    // Functions
+    bool buildIndex();
+    int32_t indexOf( const uint8_t* ) const;
+    bool contains( const uint8_t* code ) const { return indexOf( code ) >= 0; }
+    uint16_t count() const { return _count; }
+    void getCode( uint16_t, uint8_t* ) const;
+
+    // Static functions
+    static void sortCodes( iButtonCode*, uint16_t );
+
+  private:
+    // Table of sorted codes, in RAM or in PROGMEM
+    const uint8_t* _codes;
+    uint16_t _count;
+    bool _progmem;
+
+    // Family index: family codes and their first table entry
+    uint8_t _families;
+    uint8_t _family[IBUTTON_CODESET_FAMILIES];
+    uint16_t _first[IBUTTON_CODESET_FAMILIES + 1];
+
+    // Functions
+    uint8_t readByte( uint16_t, uint8_t ) const;
+    int8_t compareEntry( uint16_t, const uint8_t*, uint8_t ) const;
+
+    // Static functions
+    static int8_t compareCode( const uint8_t*, const uint8_t* );
+
+};
+
+#endif // iButtonCodeSet_h
@@ -0,0 +1,273 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonEnumerator.h"
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonEnumerator object for the supplied iButtonTag, keeping
+ * known codes in the supplied array.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonEnumerator
+ */
+iButtonEnumerator::iButtonEnumerator( iButtonTag& tag, iButtonCode* codes,
+                                      uint8_t capacity,
+                                      uint32_t budget /* = 20000 */ )
+  : _tag( tag ) {
+  _codes = codes;
+  _capacity = capacity < IBUTTON_ENUMERATOR_MAX ? capacity : IBUTTON_ENUMERATOR_MAX;
+  _budget = budget;
+  _family = -1;
+  _onArrive = NULL;
+  _onDepart = NULL;
+  _count = 0;
+  _pending = 0;
+  _phase = PHASE_SEARCH;
+  _searching = false;
+  _branch = -1;
+  _cycles = 0;
+}
+
+/*
+ * Scans the data line for arriving and departing iButtons, within the bus time
+ * budget. Returns the number of events.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#scan
+ */
+uint8_t iButtonEnumerator::scan() {
+  // A cycle searches the whole data line, one iButton per step, then verifies
+  // the known codes neither found nor dropped. Steps continue until the cycle is complete or
+  // the budget is used; the next scan resumes the cycle where this one ended.
+  uint8_t events = 0;
+  uint32_t start = micros();
+  bool more;
+  do {
+    more = _phase == PHASE_SEARCH ? searchStep( events ) : verifyStep( events );
+  } while ( more && (uint32_t) ( micros() - start ) < _budget );
+  return events;
+}
+
+/*
+ * Restricts scans to iButtons of one family.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#setFamily
+ */
+void iButtonEnumerator::setFamily( uint8_t family ) {
+  _family = family;
+  _phase = PHASE_SEARCH;
+  _searching = false;
+}
+
+/*
+ * Scans for iButtons of all families.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#clearFamily
+ */
+void iButtonEnumerator::clearFamily() {
+  _family = -1;
+  _phase = PHASE_SEARCH;
+  _searching = false;
+}
+
+/*
+ * Checks if a code is known to be present, as of the last scan.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#enumeratorIsPresent
+ */
+bool iButtonEnumerator::isPresent( const uint8_t* code ) const {
+  return find( code ) >= 0;
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Takes one pass of the search, started or resumed: a SEARCH ROM like nextCode
+ * ending at the next iButton in order, along the known codes pending. At every
+ * bit the devices still in the search answer with the bit and its complement,
+ * so a pending code with a bit no device has departed, without a search of its
+ * own. The code found confirms a known code, an unknown code arrives. Where
+ * devices have both bits, the pass takes 0 and a later pass takes 1, so every
+ * branch of the data line is searched once per cycle.
+ *
+ * Return values:
+ *   true  - Search continues
+ *   false - Nothing on the data line, cycle complete
+ */
+bool iButtonEnumerator::searchStep( uint8_t& events ) {
+  if ( !_searching ) {
+    // New cycle: all known codes of the family searched are pending
+    _pending = 0;
+    for ( uint8_t i = 0; i < _count; i++ ) {
+      if ( _family < 0 || _codes[i][0] == _family ) _pending |= (uint32_t) 1 << i;
+    }
+    _branch = -1;
+    _searching = true;
+  }
+
+  // RESET the data line
+  // - No presence at all: every known iButton departed, no need to verify
+  if ( _tag.busReset() == 0 ) {
+    while ( _count > 0 ) {
+      depart( _count - 1 );
+      events++;
+    }
+    _searching = false;
+    _cycles++;
+    return false;
+  }
+
+  // Issue SEARCH ROM command to the data line
+  _tag.busWrite( 0xF0 );
+
+  uint32_t path = _pending;  // Pending codes on the path of this pass
+  uint32_t gone = 0;         // Pending codes no device has
+  int8_t branch = -1;
+  uint8_t b;
+  for ( b = 0; b < 64; b++ ) {
+    uint8_t id = _tag.busReadBit();   // AND of bit of remaining devices
+    uint8_t cmp = _tag.busReadBit();  // AND of complement of bit
+    if ( id && cmp ) break;           // No device left, data line changed
+
+    // Drop pending codes on the path with a bit no remaining device has
+    for ( uint8_t i = 0; i < _count; i++ ) {
+      uint32_t mask = (uint32_t) 1 << i;
+      if ( ( path & mask ) == 0 ) continue;
+      uint8_t known = ( _codes[i][b >> 3] >> ( b & 7 ) ) & 1;
+      if ( known ? cmp : id ) {
+        path &= ~mask;
+        gone |= mask;
+      }
+    }
+
+    // Take the bit of the family searched, the bit all remaining devices have,
+    // or on a branch: the path of the last pass up to its last branch, 1 there
+    // and 0 beyond
+    uint8_t bit;
+    if ( _family >= 0 && b < 8 ) {
+      bit = ( _family >> b ) & 1;
+      if ( bit ? cmp : id ) break;    // No device of the family
+    } else if ( id != cmp ) {
+      bit = id;
+    } else {
+      if ( b < _branch ) bit = ( _path[b >> 3] >> ( b & 7 ) ) & 1;
+      else bit = b == _branch ? 1 : 0;
+      if ( bit == 0 ) branch = b;
+    }
+    if ( bit ) _path[b >> 3] |= 1 << ( b & 7 );
+    else _path[b >> 3] &= ~( 1 << ( b & 7 ) );
+
+    // Deselect devices, and leave the path with codes, that don't have the bit
+    _tag.busWriteBit( bit );
+    for ( uint8_t i = 0; i < _count; i++ ) {
+      if ( ( ( _codes[i][b >> 3] >> ( b & 7 ) ) & 1 ) != bit ) {
+        path &= ~( (uint32_t) 1 << i );
+      }
+    }
+  }
+
+  // Complete pass: a known code found is no longer pending, an unknown code
+  // arrives unless invalid (iButton moving) or the array is full
+  if ( b == 64 ) _pending &= ~path;
+  departAll( gone, events );
+  if ( b == 64 && path == 0 && _tag.testRead( _path ) == 1 &&
+       find( _path ) < 0 && _count < _capacity ) {
+    for ( uint8_t i = 0; i < 8; i++ ) _codes[_count][i] = _path[i];
+    _count++;
+    events++;
+    if ( _onArrive ) _onArrive( _path, 1 );
+  }
+
+  // No branch left, or the data line changed: verify codes still pending
+  _branch = branch;
+  if ( b < 64 || branch < 0 ) {
+    _searching = false;
+    _phase = PHASE_VERIFY;
+  }
+  return true;
+}
+
+/*
+ * Verifies known codes still pending after the search, with one search pass
+ * shared by all of them like verifyPresent. Codes are only left pending when
+ * the data line changed during the cycle, like a search resumed in a later scan.
+ *
+ * Return values:
+ *   true  - More known codes to verify
+ *   false - All verified, cycle complete
+ */
+bool iButtonEnumerator::verifyStep( uint8_t& events ) {
+  if ( _pending == 0 ) {
+    _phase = PHASE_SEARCH;
+    _cycles++;
+    return false;
+  }
+
+  // One search pass along the pending codes: confirms one, drops the departed
+  // ones along the way
+  uint8_t pending[32], found[32];
+  for ( uint8_t i = 0; i < 32; i++ ) pending[i] = found[i] = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) {
+    if ( _pending & ( (uint32_t) 1 << i ) ) pending[i >> 3] |= 1 << ( i & 7 );
+  }
+  _tag.searchPending( _codes, _count, pending, found );
+  uint32_t gone = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) {
+    uint32_t mask = (uint32_t) 1 << i;
+    if ( ( _pending & mask ) == 0 || ( pending[i >> 3] & ( 1 << ( i & 7 ) ) ) ) continue;
+    if ( ( found[i >> 3] & ( 1 << ( i & 7 ) ) ) == 0 ) gone |= mask;
+    _pending &= ~mask;
+  }
+  departAll( gone, events );
+  return true;
+}
+
+/*
+ * Returns the index of a known code, -1 if unknown.
+ */
+int8_t iButtonEnumerator::find( const uint8_t* code ) const {
+  for ( uint8_t i = 0; i < _count; i++ ) {
+    if ( iButtonTag::equalCode( _codes[i], code ) ) return i;
+  }
+  return -1;
+}
+
+/*
+ * Removes the known code at an index, moving the last one to it, and calls the
+ * depart handler.
+ */
+void iButtonEnumerator::depart( uint8_t index ) {
+  iButtonCode code;
+  for ( uint8_t i = 0; i < 8; i++ ) code[i] = _codes[index][i];
+  _count--;
+  uint32_t last = (uint32_t) 1 << _count;
+  for ( uint8_t i = 0; i < 8; i++ ) _codes[index][i] = _codes[_count][i];
+  if ( _pending & last ) _pending |= (uint32_t) 1 << index;
+  else _pending &= ~( (uint32_t) 1 << index );
+  _pending &= ~last;
+  if ( _onDepart ) _onDepart( code, 0 );
+}
+
+/*
+ * Removes the known codes of a mask, highest index first: the last code moved
+ * to an index is never in the mask.
+ */
+void iButtonEnumerator::departAll( uint32_t gone, uint8_t& events ) {
+  for ( uint8_t i = _count; i-- > 0; ) {
+    if ( gone & ( (uint32_t) 1 << i ) ) {
+      depart( i );
+      events++;
+    }
+  }
+}
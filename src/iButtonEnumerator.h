@@ -0,0 +1,71 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonEnumerator_h
+#define iButtonEnumerator_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+#include "iButtonWatcher.h"
+
+// Constant for the maximum number of codes kept, one bit each in a mask
+#define IBUTTON_ENUMERATOR_MAX 32
+
+// Class definition
+class iButtonEnumerator {
+
+  public:
+    // Constructor
+    iButtonEnumerator( iButtonTag&, iButtonCode*, uint8_t, uint32_t = 20000 );
+
+    // Event handlers
+    void onArrive( iButtonEventHandler handler ) { _onArrive = handler; }
+    void onDepart( iButtonEventHandler handler ) { _onDepart = handler; }
+
+    // Functions
+    uint8_t scan();
+    void setFamily( uint8_t );
+    void clearFamily();
+    void setBudget( uint32_t budget ) { _budget = budget; }
+    uint8_t count() const { return _count; }
+    const uint8_t* code( uint8_t index ) const { return _codes[index]; }
+    bool isPresent( const uint8_t* ) const;
+    uint16_t cycles() const { return _cycles; }
+
+  private:
+    // Phases of a cycle: search the data line, then verify known codes not found
+    enum { PHASE_SEARCH, PHASE_VERIFY };
+
+    // Settings
+    iButtonTag& _tag;
+    iButtonCode* _codes;    // Known codes, supplied by caller
+    uint8_t _capacity;
+    uint32_t _budget;       // Bus time per scan, microseconds
+    int16_t _family;        // Family code searched, -1 for all families
+
+    // Event handlers
+    iButtonEventHandler _onArrive;
+    iButtonEventHandler _onDepart;
+
+    // State
+    uint8_t _count;         // Known codes
+    uint32_t _pending;      // Known codes not found yet in this cycle, bit by index
+    uint8_t _phase;
+    bool _searching;        // Search started, resumed by the next scan
+    iButtonCode _path;      // Path of the last search pass
+    int8_t _branch;         // Last bit where the last pass took 0 and 1 is left
+    uint16_t _cycles;       // Cycles completed
+
+    // Functions
+    bool searchStep( uint8_t& );
+    bool verifyStep( uint8_t& );
+    int8_t find( const uint8_t* ) const;
+    void depart( uint8_t );
+    void departAll( uint32_t, uint8_t& );
+
+};
+
+#endif // iButtonEnumerator_h
@@ -0,0 +1,205 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonFrame.h"
+
+
+// CONSTANTS
+
+// Frame layout: offsets of fields
+#define OFFSET_LENGTH  1
+#define OFFSET_TYPE    2
+#define OFFSET_PAYLOAD 3
+
+// Payload layout of code frames and status frames
+#define CODE_PAYLOAD   10 // Reader, status, code
+#define STATUS_PAYLOAD 3  // Reader, event, status
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Encodes a frame with any payload in a buffer.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#encode
+ */
+uint8_t iButtonFrame::encode( uint8_t* buffer, uint8_t type,
+                              const uint8_t* payload, uint8_t length ) {
+  if ( length > IBUTTON_FRAME_PAYLOAD ) return 0;
+  buffer[0] = IBUTTON_FRAME_SYNC;
+  buffer[OFFSET_LENGTH] = length;
+  buffer[OFFSET_TYPE] = type;
+  for ( uint8_t i = 0; i < length; i++ ) buffer[OFFSET_PAYLOAD + i] = payload[i];
+  buffer[OFFSET_PAYLOAD + length] = crc8( buffer + OFFSET_LENGTH, length + 2 );
+  return length + IBUTTON_FRAME_OVERHEAD;
+}
+
+/*
+ * Encodes a frame for an iButtonCode read or written in a buffer.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#encodeCode
+ */
+uint8_t iButtonFrame::encodeCode( uint8_t* buffer, uint8_t type,
+                                  const uint8_t* code, int8_t status,
+                                  uint8_t reader /* = 0 */ ) {
+  uint8_t payload[CODE_PAYLOAD];
+  payload[0] = reader;
+  payload[1] = status;
+  for ( uint8_t i = 0; i < 8; i++ ) payload[2 + i] = code[i];
+  return encode( buffer, type, payload, CODE_PAYLOAD );
+}
+
+/*
+ * Encodes a frame for a status event in a buffer.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#encodeStatus
+ */
+uint8_t iButtonFrame::encodeStatus( uint8_t* buffer, uint8_t event,
+                                    int8_t status, uint8_t reader /* = 0 */ ) {
+  uint8_t payload[STATUS_PAYLOAD] = { reader, event, (uint8_t) status };
+  return encode( buffer, IBUTTON_FRAME_STATUS, payload, STATUS_PAYLOAD );
+}
+
+/*
+ * Constructs an iButtonFrameParser object, waiting for a sync byte.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonFrameParser
+ */
+iButtonFrameParser::iButtonFrameParser() {
+  _size = 0;
+  _ready = false;
+  _errors = 0;
+}
+
+/*
+ * Processes the next byte received, returns 1 when a frame is decoded.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#feed
+ */
+int8_t iButtonFrameParser::feed( uint8_t b ) {
+  if ( _ready ) {         // Frame was handed out, drop it
+    resync( _buffer[OFFSET_LENGTH] + IBUTTON_FRAME_OVERHEAD );
+    _ready = false;
+  }
+  if ( _size == 0 && b != IBUTTON_FRAME_SYNC ) return 0;  // Between frames
+  _buffer[_size++] = b;
+  return parse();
+}
+
+/*
+ * Drops all bytes received, waits for a sync byte.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#resetParser
+ */
+void iButtonFrameParser::reset() {
+  _size = 0;
+  _ready = false;
+}
+
+/*
+ * Returns the reader number of the frame decoded.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#frameReader
+ */
+uint8_t iButtonFrameParser::reader() const {
+  return length() > 0 ? _buffer[OFFSET_PAYLOAD] : 0;
+}
+
+/*
+ * Returns the event number of the status frame decoded.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#frameEvent
+ */
+uint8_t iButtonFrameParser::event() const {
+  if ( type() != IBUTTON_FRAME_STATUS || length() != STATUS_PAYLOAD ) return 0;
+  return _buffer[OFFSET_PAYLOAD + 1];
+}
+
+/*
+ * Returns the status of the code or status frame decoded.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#frameStatus
+ */
+int8_t iButtonFrameParser::status() const {
+  if ( type() == IBUTTON_FRAME_STATUS && length() == STATUS_PAYLOAD ) {
+    return _buffer[OFFSET_PAYLOAD + 2];
+  }
+  if ( ( type() == IBUTTON_FRAME_READ || type() == IBUTTON_FRAME_WRITE ) &&
+       length() == CODE_PAYLOAD ) {
+    return _buffer[OFFSET_PAYLOAD + 1];
+  }
+  return 0;
+}
+
+/*
+ * Copies the iButtonCode of the code frame decoded.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#frameCode
+ */
+bool iButtonFrameParser::code( uint8_t* code ) const {
+  if ( type() != IBUTTON_FRAME_READ && type() != IBUTTON_FRAME_WRITE ) return false;
+  if ( length() != CODE_PAYLOAD ) return false;
+  for ( uint8_t i = 0; i < 8; i++ ) code[i] = _buffer[OFFSET_PAYLOAD + 2 + i];
+  return true;
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Calculates CRC8 with the Dallas/Maxim polynomial, like iButtonTag::crc8.
+ * Bitwise: frames are short, and the parser needs no tables or other files.
+ */
+uint8_t iButtonFrame::crc8( const uint8_t* data, uint8_t length ) {
+  uint8_t crc = 0;
+  while ( length-- ) {
+    crc ^= *data++;
+    for ( uint8_t i = 0; i < 8; i++ ) crc = crc & 1 ? ( crc >> 1 ) ^ 0x8C : crc >> 1;
+  }
+  return crc;
+}
+
+/*
+ * Looks for a frame at the start of the buffer. A frame with invalid length or
+ * CRC is dropped up to the next sync byte in the buffer: the bytes after its
+ * sync byte may hold the start of a valid frame, like after a truncated frame.
+ */
+int8_t iButtonFrameParser::parse() {
+  while ( _size > 1 ) {
+    uint8_t length = _buffer[OFFSET_LENGTH];
+    if ( length <= IBUTTON_FRAME_PAYLOAD ) {
+      if ( _size < length + IBUTTON_FRAME_OVERHEAD ) return 0;  // Incomplete
+      uint8_t check = iButtonFrame::crc8( _buffer + OFFSET_LENGTH, length + 2 );
+      if ( check == _buffer[OFFSET_PAYLOAD + length] ) {
+        _ready = true;
+        return 1;
+      }
+    }
+    _errors++;
+    resync( 1 );
+  }
+  return 0;
+}
+
+/*
+ * Removes bytes from the start of the buffer, at least the supplied number and
+ * further up to the next sync byte.
+ */
+void iButtonFrameParser::resync( uint8_t count ) {
+  while ( count < _size && _buffer[count] != IBUTTON_FRAME_SYNC ) count++;
+  if ( count >= _size ) {
+    _size = 0;
+    return;
+  }
+  _size -= count;
+  for ( uint8_t i = 0; i < _size; i++ ) _buffer[i] = _buffer[count + i];
+}
@@ -0,0 +1,102 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonFrame_h
+#define iButtonFrame_h
+
+// Includes, no Arduino headers: the parser compiles for the host side as is
+#include <inttypes.h>
+#include <stddef.h>
+
+// Constants for frame layout: sync byte, payload length, type, payload and
+// CRC8 of length, type and payload
+#define IBUTTON_FRAME_SYNC     0xA5
+#define IBUTTON_FRAME_PAYLOAD  32 // Maximum payload length
+#define IBUTTON_FRAME_OVERHEAD 4
+#define IBUTTON_FRAME_MAX      ( IBUTTON_FRAME_PAYLOAD + IBUTTON_FRAME_OVERHEAD )
+
+// Constants for frame types
+#define IBUTTON_FRAME_READ     1 // Code read: reader, status, code
+#define IBUTTON_FRAME_WRITE    2 // Code written: reader, status, code
+#define IBUTTON_FRAME_STATUS   3 // Status event: reader, event, status
+
+// Class definition, encoding frames
+class iButtonFrame {
+
+  public:
+    // Static functions, encoding to a buffer of IBUTTON_FRAME_MAX bytes
+    static uint8_t encode( uint8_t*, uint8_t, const uint8_t*, uint8_t );
+    static uint8_t encodeCode( uint8_t*, uint8_t, const uint8_t*, int8_t,
+                               uint8_t = 0 );
+    static uint8_t encodeStatus( uint8_t*, uint8_t, int8_t, uint8_t = 0 );
+
+    // Static functions, writing a frame to a Print or Stream object in a single
+    // write; any class with write( const uint8_t*, size_t ) will do
+    template <class Output>
+    static size_t write( Output& output, uint8_t type, const uint8_t* payload,
+                         uint8_t length ) {
+      uint8_t frame[IBUTTON_FRAME_MAX];
+      uint8_t size = encode( frame, type, payload, length );
+      return size > 0 ? output.write( frame, size ) : 0;
+    }
+
+    template <class Output>
+    static size_t writeCode( Output& output, uint8_t type, const uint8_t* code,
+                             int8_t status, uint8_t reader = 0 ) {
+      uint8_t frame[IBUTTON_FRAME_MAX];
+      uint8_t size = encodeCode( frame, type, code, status, reader );
+      return output.write( frame, size );
+    }
+
+    template <class Output>
+    static size_t writeStatus( Output& output, uint8_t event, int8_t status,
+                               uint8_t reader = 0 ) {
+      uint8_t frame[IBUTTON_FRAME_MAX];
+      uint8_t size = encodeStatus( frame, event, status, reader );
+      return output.write( frame, size );
+    }
+
+  private:
+    // Parser checks frames with the same CRC8
+    friend class iButtonFrameParser;
+    static uint8_t crc8( const uint8_t*, uint8_t );
+
+};
+
+// Class definition, decoding frames from a stream of bytes
+class iButtonFrameParser {
+
+  public:
+    // Constructor
+    iButtonFrameParser();
+
+    // Functions
+    int8_t feed( uint8_t );
+    void reset();
+    uint16_t errors() const { return _errors; }
+
+    // Functions for the frame decoded, valid until the next byte is fed
+    uint8_t type() const { return _ready ? _buffer[2] : 0; }
+    uint8_t length() const { return _ready ? _buffer[1] : 0; }
+    const uint8_t* payload() const { return _buffer + 3; }
+    uint8_t reader() const;
+    uint8_t event() const;
+    int8_t status() const;
+    bool code( uint8_t* ) const;
+
+  private:
+    // Bytes received from the last sync byte on, a frame is decoded in place
+    uint8_t _buffer[IBUTTON_FRAME_MAX];
+    uint8_t _size;
+    bool _ready;            // Buffer starts with a frame decoded
+    uint16_t _errors;       // Frames dropped for invalid length or CRC
+
+    // Functions
+    int8_t parse();
+    void resync( uint8_t );
+
+};
+
+#endif // iButtonFrame_h
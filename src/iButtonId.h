@@ -0,0 +1,96 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonId_h
+#define iButtonId_h
+
+// Includes
+#include <inttypes.h>
+
+// Class definition, an iButtonCode packed in one 64-bit value. Byte i of the
+// code is bits 8i to 8i+7 of the value: family code in the lowest byte, CRC8
+// in the highest. All functions are in this header, most of them constexpr:
+// an iButtonId can be checked, or have its checksum filled in, at compile time.
+class iButtonId {
+
+  public:
+    // Constructors
+    constexpr iButtonId() : _value( 0 ) {}
+    constexpr explicit iButtonId( uint64_t value ) : _value( value ) {}
+    constexpr explicit iButtonId( const uint8_t* code ) : _value( pack( code, 7 ) ) {}
+
+    // Constructor from all 8 bytes of a code, checksum as supplied
+    constexpr iButtonId( uint8_t family, uint8_t b1, uint8_t b2, uint8_t b3,
+                         uint8_t b4, uint8_t b5, uint8_t b6, uint8_t crc )
+      : _value( bytes( family, b1, b2, b3, b4, b5, b6 ) | (uint64_t) crc << 56 ) {}
+
+    // Constructor from the first 7 bytes of a code, checksum filled in
+    constexpr iButtonId( uint8_t family, uint8_t b1, uint8_t b2, uint8_t b3,
+                         uint8_t b4, uint8_t b5, uint8_t b6 )
+      : _value( withCrc( bytes( family, b1, b2, b3, b4, b5, b6 ) ) ) {}
+
+    // Accessors
+    constexpr uint64_t value() const { return _value; }
+    constexpr uint8_t family() const { return (uint8_t) _value; }
+    constexpr uint64_t serial() const { return ( _value >> 8 ) & 0xFFFFFFFFFFFFULL; }
+    constexpr uint8_t crc() const { return (uint8_t) ( _value >> 56 ); }
+    constexpr uint8_t operator[]( uint8_t i ) const { return (uint8_t) ( _value >> ( 8 * i ) ); }
+
+    // Functions, test the same as iButtonTag::testCode
+    constexpr int8_t test() const {
+      return crc() != crc8( _value, 7 ) ? -1 : _value == 0 ? -2 : 1;
+    }
+    constexpr bool valid() const { return test() == 1; }
+    constexpr iButtonId withChecksum() const { return iButtonId( withCrc( _value ) ); }
+    constexpr uint32_t hash() const {
+      return fold( (uint32_t) _value * 0x9E3779B1UL ^
+                   (uint32_t) ( _value >> 32 ) * 0x85EBCA77UL );
+    }
+    void toCode( uint8_t* code ) const {
+      for ( uint8_t i = 0; i < 8; i++ ) code[i] = (uint8_t) ( _value >> ( 8 * i ) );
+    }
+
+    // Comparison, equality the same as iButtonTag::equalCode. Order is the
+    // order of values, not of iButtonCodeSet::sortCodes.
+    constexpr bool operator==( const iButtonId& other ) const { return _value == other._value; }
+    constexpr bool operator!=( const iButtonId& other ) const { return _value != other._value; }
+    constexpr bool operator<( const iButtonId& other ) const { return _value < other._value; }
+    constexpr bool operator<=( const iButtonId& other ) const { return _value <= other._value; }
+    constexpr bool operator>( const iButtonId& other ) const { return _value > other._value; }
+    constexpr bool operator>=( const iButtonId& other ) const { return _value >= other._value; }
+
+    // Static function, CRC8 of the lowest bytes of a value, lowest byte first.
+    // Same result as iButtonTag::crc8, one bit at a time: fine at compile time,
+    // iButtonTag::crc8 is faster at run time.
+    static constexpr uint8_t crc8( uint64_t value, uint8_t count ) {
+      return count == 0 ? 0 : crcByte( crc8( value, count - 1 ),
+                                       (uint8_t) ( value >> ( 8 * ( count - 1 ) ) ) );
+    }
+
+  private:
+    uint64_t _value;
+
+    // Helpers, single return statements for constexpr in C++11
+    static constexpr uint8_t crcBits( uint8_t crc, uint8_t bits ) {
+      return bits == 0 ? crc : crcBits( crc & 1 ? ( crc >> 1 ) ^ 0x8C : crc >> 1, bits - 1 );
+    }
+    static constexpr uint8_t crcByte( uint8_t crc, uint8_t b ) { return crcBits( crc ^ b, 8 ); }
+    static constexpr uint32_t fold( uint32_t h ) { return h ^ ( h >> 16 ); }
+    static constexpr uint64_t pack( const uint8_t* code, uint8_t i ) {
+      return ( (uint64_t) code[i] << ( 8 * i ) ) | ( i == 0 ? 0 : pack( code, i - 1 ) );
+    }
+    static constexpr uint64_t bytes( uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3,
+                                     uint8_t b4, uint8_t b5, uint8_t b6 ) {
+      return (uint64_t) b0 | (uint64_t) b1 << 8 | (uint64_t) b2 << 16 |
+             (uint64_t) b3 << 24 | (uint64_t) b4 << 32 | (uint64_t) b5 << 40 |
+             (uint64_t) b6 << 48;
+    }
+    static constexpr uint64_t withCrc( uint64_t value ) {
+      return ( value & 0x00FFFFFFFFFFFFFFULL ) | (uint64_t) crc8( value, 7 ) << 56;
+    }
+
+};
+
+#endif // iButtonId_h
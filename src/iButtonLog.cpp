@@ -0,0 +1,306 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonLog.h"
+
+
+// CONSTANTS
+
+// Record layout: header byte and body of 9 bytes
+//   header - Bits 7-6 lap marker, bit 5 kind, bits 4-0 check of body
+//   read   - Serial (6 bytes), time since previous record (2 bytes), status
+//   sync   - Time (4 bytes), time since previous record (2 bytes), unused
+#define KIND_READ     0
+#define KIND_SYNC     1
+#define BODY_SIZE     9
+
+// Lap markers cycle 0, 1, 2: records of the current round carry the marker of
+// slot 0, older records the previous marker. Erased storage reads 3.
+#define LAP_ERASED    3
+
+// Time since previous record unknown or too large for 2 bytes
+#define DELTA_UNKNOWN 0xFFFF
+
+// A record for a slot at a multiple of this number starts with a sync record,
+// so reading back never needs to go far for a known time
+#define SYNC_INTERVAL 16
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonLog object on the supplied storage.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonLog
+ */
+iButtonLog::iButtonLog( iButtonStorage& storage, uint8_t family /* = 0x01 */ )
+  : _storage( storage ) {
+  _family = family;
+  _slots = 0;
+  _head = 0;
+  _lap = 0;
+  _full = false;
+  _pending = 0;
+  _synced = false;
+  _rLeft = 0;
+}
+
+/*
+ * Finds the position of the next record in storage.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginLog
+ */
+bool iButtonLog::begin() {
+  _slots = _storage.size() / IBUTTON_LOG_RECORD;
+  _pending = 0;
+  _synced = false;
+  _rLeft = 0;
+  if ( _slots < SYNC_INTERVAL ) return false;
+
+  // Empty storage: start in slot 0
+  uint8_t first = lapOf( 0 );
+  if ( first == LAP_ERASED ) {
+    _head = 0;
+    _lap = 0;
+    _full = false;
+    return lapOf( _slots - 1 ) == LAP_ERASED;
+  }
+
+  // Slots before the head carry the lap marker of slot 0, slots from the head
+  // on don't: binary search, only a few headers are read
+  uint16_t low = 1;
+  uint16_t high = _slots;
+  while ( low < high ) {
+    uint16_t middle = low + ( ( high - low ) >> 1 );
+    if ( lapOf( middle ) == first ) low = middle + 1;
+    else high = middle;
+  }
+  _head = low;
+  _lap = first;
+
+  // Last record written must be intact, otherwise storage is not a log
+  uint8_t body[BODY_SIZE];
+  if ( readRecord( _head - 1, body ) < 0 ) return false;
+
+  if ( _head == _slots ) {        // Round complete, next one starts in slot 0
+    _head = 0;
+    _lap = first == 2 ? 0 : first + 1;
+    _full = true;
+    return true;
+  }
+
+  // Slots after the head belong to the previous round, or were never written
+  uint8_t previous = first == 0 ? 2 : first - 1;
+  uint8_t at = lapOf( _head );
+  uint8_t last = lapOf( _slots - 1 );
+  _full = last != LAP_ERASED;
+  if ( at != previous && at != LAP_ERASED ) return false;
+  return last == ( _full ? previous : LAP_ERASED );
+}
+
+/*
+ * Removes all records.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#clear
+ */
+void iButtonLog::clear() {
+  _slots = _storage.size() / IBUTTON_LOG_RECORD;
+  for ( uint16_t i = 0; i < _slots; i++ ) {
+    _storage.write( i * IBUTTON_LOG_RECORD, 0xFF );
+  }
+  _storage.commit();
+  _head = 0;
+  _lap = 0;
+  _full = false;
+  _pending = 0;
+  _synced = false;
+  _rLeft = 0;
+}
+
+/*
+ * Adds a record for an iButtonCode, buffered in RAM.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#append
+ */
+int8_t iButtonLog::append( const uint8_t* code, uint32_t time,
+                           int8_t status /* = 1 */ ) {
+  // Only the serial is stored, family code must be the one of the log
+  if ( _slots == 0 || code[0] != _family ) return 0;
+
+  Event& e = _buffer[_pending++];
+  for ( uint8_t i = 0; i < 6; i++ ) e.serial[i] = code[i + 1];
+  e.time = time;
+  e.status = status;
+
+  if ( _pending == IBUTTON_LOG_BUFFER ) flush();
+  return 1;
+}
+
+/*
+ * Writes buffered records to storage.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#flush
+ */
+void iButtonLog::flush() {
+  if ( _pending == 0 ) return;
+
+  for ( uint8_t i = 0; i < _pending; i++ ) {
+    const Event& e = _buffer[i];
+    uint8_t body[BODY_SIZE];
+
+    // Time since previous record, if it fits
+    uint16_t delta = DELTA_UNKNOWN;
+    if ( _synced && e.time >= _last && e.time - _last < DELTA_UNKNOWN ) {
+      delta = e.time - _last;
+    }
+
+    // Sync record with full time, when the time since the previous record is
+    // unknown and at fixed slots
+    if ( delta == DELTA_UNKNOWN || _head % SYNC_INTERVAL == 0 ) {
+      for ( uint8_t j = 0; j < 4; j++ ) body[j] = e.time >> ( j << 3 );
+      body[4] = delta;
+      body[5] = delta >> 8;
+      body[6] = body[7] = body[8] = 0;
+      writeRecord( KIND_SYNC, body );
+      delta = 0;
+    }
+
+    for ( uint8_t j = 0; j < 6; j++ ) body[j] = e.serial[j];
+    body[6] = delta;
+    body[7] = delta >> 8;
+    body[8] = e.status;
+    writeRecord( KIND_READ, body );
+
+    _synced = true;
+    _last = e.time;
+  }
+  _pending = 0;
+  _storage.commit();
+}
+
+/*
+ * Returns the number of records in storage, sync records and damaged records
+ * not included: the records next reads back.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#countLog
+ */
+uint16_t iButtonLog::count() {
+  uint16_t records = 0;
+  for ( uint16_t slot = 0, n = used(); slot < n; slot++ ) {
+    uint8_t body[BODY_SIZE];
+    if ( readRecord( slot, body ) == KIND_READ ) records++;
+  }
+  return records;
+}
+
+/*
+ * Starts reading back records, oldest first.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#rewind
+ */
+void iButtonLog::rewind() {
+  flush();
+  _rSlot = _full ? _head : 0;
+  _rLeft = used();
+
+  // The time of the first records follows from the first sync record: walk
+  // back from its time by the time since previous record of each record
+  uint32_t back = 0;
+  uint16_t slot = _rSlot;
+  _rKnown = false;
+  for ( uint16_t i = 0; i < _rLeft && i <= SYNC_INTERVAL; i++ ) {
+    uint8_t body[BODY_SIZE];
+    int8_t kind = readRecord( slot, body );
+    if ( kind == KIND_SYNC ) {
+      uint16_t delta = body[4] | ( body[5] << 8 );
+      _rKnown = i == 0 || delta != DELTA_UNKNOWN;
+      _rTime = (uint32_t) body[0] | ( (uint32_t) body[1] << 8 ) |
+               ( (uint32_t) body[2] << 16 ) | ( (uint32_t) body[3] << 24 );
+      _rTime -= delta + back;
+      break;
+    }
+    if ( kind == KIND_READ ) back += body[6] | ( body[7] << 8 );
+    slot = nextSlot( slot );
+  }
+}
+
+/*
+ * Reads back the next record.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#next
+ */
+int8_t iButtonLog::next( uint8_t* code, uint32_t* time,
+                         int8_t* status /* = NULL */ ) {
+  while ( _rLeft > 0 ) {
+    uint8_t body[BODY_SIZE];
+    int8_t kind = readRecord( _rSlot, body );
+    _rSlot = nextSlot( _rSlot );
+    _rLeft--;
+
+    if ( kind == KIND_SYNC ) {
+      _rTime = (uint32_t) body[0] | ( (uint32_t) body[1] << 8 ) |
+               ( (uint32_t) body[2] << 16 ) | ( (uint32_t) body[3] << 24 );
+      _rKnown = true;
+    }
+    if ( kind != KIND_READ ) continue;  // Sync record or damaged record
+
+    _rTime += body[6] | ( body[7] << 8 );
+    code[0] = _family;
+    for ( uint8_t i = 0; i < 6; i++ ) code[i + 1] = body[i];
+    iButtonTag::updateChecksum( code );
+    *time = _rKnown ? _rTime : 0;
+    if ( status ) *status = body[8];
+    return 1;
+  }
+  return 0;
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Returns lap marker of a slot, LAP_ERASED if never written.
+ */
+uint8_t iButtonLog::lapOf( uint16_t slot ) {
+  return _storage.read( slot * IBUTTON_LOG_RECORD ) >> 6;
+}
+
+/*
+ * Writes a record in the slot of the head and advances the head.
+ *
+ * The header is written last: a record interrupted by power loss still has
+ * the lap marker of the previous round, and is overwritten next time.
+ */
+void iButtonLog::writeRecord( uint8_t kind, const uint8_t* body ) {
+  uint16_t address = _head * IBUTTON_LOG_RECORD;
+  for ( uint8_t i = 0; i < BODY_SIZE; i++ ) _storage.write( address + 1 + i, body[i] );
+  uint8_t check = iButtonTag::crc8( body, BODY_SIZE ) & 0x1F;
+  _storage.write( address, ( _lap << 6 ) | ( kind << 5 ) | check );
+
+  _head = nextSlot( _head );
+  if ( _head == 0 ) {
+    _lap = _lap == 2 ? 0 : _lap + 1;
+    _full = true;
+  }
+}
+
+/*
+ * Reads a record, returns its kind or -1 when never written or damaged.
+ */
+int8_t iButtonLog::readRecord( uint16_t slot, uint8_t* body ) {
+  uint16_t address = slot * IBUTTON_LOG_RECORD;
+  uint8_t header = _storage.read( address );
+  if ( ( header >> 6 ) == LAP_ERASED ) return -1;
+  for ( uint8_t i = 0; i < BODY_SIZE; i++ ) body[i] = _storage.read( address + 1 + i );
+  if ( ( iButtonTag::crc8( body, BODY_SIZE ) & 0x1F ) != ( header & 0x1F ) ) return -1;
+  return ( header >> 5 ) & 1;
+}
@@ -0,0 +1,79 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonLog_h
+#define iButtonLog_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+#include "iButtonStorage.h"
+
+// Size of one record in storage, in bytes
+#define IBUTTON_LOG_RECORD 10
+
+// Number of records buffered in RAM before writing them to storage
+#ifndef IBUTTON_LOG_BUFFER
+#define IBUTTON_LOG_BUFFER 4
+#endif
+
+// Class definition
+class iButtonLog {
+
+  public:
+    // Constructor
+    iButtonLog( iButtonStorage&, uint8_t = 0x01 );
+
+    // Functions
+    bool begin();
+    void clear();
+    int8_t append( const uint8_t*, uint32_t, int8_t = 1 );
+    void flush();
+    uint16_t count();
+    uint16_t capacity() const { return _slots; }
+    uint8_t pending() const { return _pending; }
+
+    // Reading back, oldest record first
+    void rewind();
+    int8_t next( uint8_t*, uint32_t*, int8_t* = NULL );
+
+  private:
+    // Settings
+    iButtonStorage& _storage;
+    uint8_t _family;
+
+    // Ring of records in storage
+    uint16_t _slots;        // Number of records fitting in storage
+    uint16_t _head;         // Slot of next record
+    uint8_t _lap;           // Lap marker of records written in this round
+    bool _full;             // All slots written at least once
+
+    // Records buffered in RAM
+    struct Event {
+      uint8_t serial[6];
+      int8_t status;
+      uint32_t time;
+    };
+    Event _buffer[IBUTTON_LOG_BUFFER];
+    uint8_t _pending;
+    bool _synced;           // Time of last record written is known
+    uint32_t _last;         // Time of last record written
+
+    // Reading back
+    uint16_t _rSlot;        // Slot of next record to read
+    uint16_t _rLeft;        // Number of records left to read
+    bool _rKnown;           // Time of previous record known
+    uint32_t _rTime;        // Time of previous record
+
+    // Functions
+    uint8_t lapOf( uint16_t );
+    void writeRecord( uint8_t, const uint8_t* );
+    int8_t readRecord( uint16_t, uint8_t* );
+    uint16_t used() const { return _full ? _slots : _head; }
+    uint16_t nextSlot( uint16_t slot ) const { return slot + 1 == _slots ? 0 : slot + 1; }
+
+};
+
+#endif // iButtonLog_h
@@ -0,0 +1,242 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonLowPower.h"
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#elif defined(ARDUINO_ARCH_ESP32)
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
+
+// Interrupt handlers must be in RAM on ESP boards, not in flash
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+
+// CONSTANTS
+
+// READ ROM attempts after waking: a tag sliding onto the probe makes contact
+// a few times before it stays. A tag present but not read yet won't wake the
+// MCU again, so attempts go on while it stays, for a limited time.
+#define READ_ATTEMPTS    5
+#define READ_INTERVAL   10 // Milliseconds between attempts
+#define READ_RETRY    1000 // Milliseconds of attempts while a tag stays present
+
+
+#if IBUTTON_WAKE_SUPPORTED
+// Interrupt state, only one object can wait at a time
+volatile bool iButtonLowPower::_woken = false;
+volatile uint8_t iButtonLowPower::_interrupt = 0;
+#endif
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonLowPower object for an iButtonTag object and the pin of
+ * its data line.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonLowPower
+ */
+iButtonLowPower::iButtonLowPower( iButtonTag& tag, uint8_t pin,
+                                  uint16_t interval /* = 250 */ )
+  : _tag( tag ) {
+  _pin = pin;
+  _interval = interval;
+  _mode = IBUTTON_WAKE_POLL;
+  _present = false;
+  _start = 0;
+  _timeout = 0;
+  _latency = 0;
+  _longest = 0;
+  _wakes = 0;
+}
+
+/*
+ * Selects the way of waiting for an iButton.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginLowPower
+ */
+int8_t iButtonLowPower::begin( int8_t mode /* = IBUTTON_WAKE_INTERRUPT */ ) {
+  _mode = IBUTTON_WAKE_POLL;
+#if IBUTTON_WAKE_SUPPORTED
+  // Falls back to polling when the pin can't interrupt, or the board can't
+  // sleep until it does
+  if ( mode == IBUTTON_WAKE_INTERRUPT &&
+       digitalPinToInterrupt( _pin ) != NOT_AN_INTERRUPT ) {
+    _mode = IBUTTON_WAKE_INTERRUPT;
+  }
+#else
+  (void) mode;
+#endif
+  _present = _tag.checkPresence() == 1;
+  return _mode;
+}
+
+/*
+ * Waits for an iButton to arrive on the probe and reads its code, or until the
+ * timeout in milliseconds passes: 0 waits without timeout.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#waitCode
+ */
+int8_t iButtonLowPower::waitCode( uint8_t* code, uint32_t timeout /* = 0 */ ) {
+  _start = millis();
+  _timeout = timeout;
+  while ( true ) {
+    bool woken = _mode == IBUTTON_WAKE_INTERRUPT ? sleepUntilLow() : pollUntilArrival();
+    if ( !woken ) return 0;
+    _wakes++;
+
+    // One READ ROM, repeated only while contact is not yet stable: a few
+    // attempts, then more as long as a tag is present with an invalid code
+    uint32_t wake = micros();
+    uint32_t first = millis();
+    for ( uint16_t i = 1; ; i++ ) {
+      int8_t status = _tag.readCode( code );
+      if ( status > 0 ) {
+        _latency = micros() - wake;
+        if ( _latency > _longest ) _longest = _latency;
+        return status;
+      }
+      bool retry = i < READ_ATTEMPTS ||
+                   ( status < 0 && (uint32_t) ( millis() - first ) < READ_RETRY );
+      if ( !retry || expired() ) break;
+      delay( READ_INTERVAL );
+    }
+    // No valid code: woken by noise, a tag that didn't stay or a tag that
+    // can't be read, sleep again
+    if ( expired() ) return 0;
+  }
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Sleeps until the data line goes low: the presence pulse of an iButton
+ * touching the probe.
+ *
+ * Return values:
+ *   true  - Data line went low
+ *   false - Timeout passed
+ */
+bool iButtonLowPower::sleepUntilLow() {
+#if IBUTTON_WAKE_SUPPORTED
+  _woken = false;
+  _interrupt = digitalPinToInterrupt( _pin );
+#if defined(__AVR__)
+  // In power-down mode only a low level wakes the MCU, the handler detaches the
+  // interrupt so it fires once. The MCU wakes even when the presence pulse ends
+  // before the oscillator is running again, without calling the handler. The
+  // clock stops in power-down: with a timeout, sleep in idle mode instead.
+  set_sleep_mode( _timeout ? SLEEP_MODE_IDLE : SLEEP_MODE_PWR_DOWN );
+  while ( true ) {
+    // Data line must be released and high, otherwise there is nothing to wait for
+    if ( digitalRead( _pin ) == LOW ) return true;
+    if ( expired() ) return false;
+    noInterrupts();
+    attachInterrupt( _interrupt, wakeHandler, LOW );
+    sleep_enable();
+    interrupts();             // Takes effect after the next instruction
+    sleep_cpu();              // so no interrupt is missed before sleeping
+    sleep_disable();
+    detachInterrupt( _interrupt );
+    if ( _woken || !_timeout ) return true;
+  }
+#else
+  // Light sleep, woken by a low level on the pin or the timeout. The interrupt
+  // catches a presence pulse ending just before sleeping.
+  attachInterrupt( _interrupt, wakeHandler, FALLING );
+  bool woken;
+  while ( true ) {
+    woken = _woken || digitalRead( _pin ) == LOW;
+    if ( woken || expired() ) break;
+    gpio_wakeup_enable( (gpio_num_t) _pin, GPIO_INTR_LOW_LEVEL );
+    esp_sleep_enable_gpio_wakeup();
+    if ( _timeout ) esp_sleep_enable_timer_wakeup( (uint64_t) remaining() * 1000 );
+    esp_light_sleep_start();
+    gpio_wakeup_disable( (gpio_num_t) _pin );
+    esp_sleep_disable_wakeup_source( ESP_SLEEP_WAKEUP_ALL );
+    if ( esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO ) _woken = true;
+  }
+  detachInterrupt( _interrupt );
+  return woken;
+#endif
+#else
+  return pollUntilArrival();
+#endif
+}
+
+/*
+ * Checks presence at intervals until an iButton arrives: one reset per check,
+ * idle in between.
+ *
+ * Return values:
+ *   true  - iButton arrived
+ *   false - Timeout passed
+ */
+bool iButtonLowPower::pollUntilArrival() {
+  while ( true ) {
+    bool present = _tag.checkPresence() == 1;
+    bool arrived = present && !_present;
+    _present = present;
+    if ( arrived ) return true;
+    if ( expired() ) return false;
+    uint32_t left = remaining();
+    idle( _timeout && left < _interval ? left : _interval );
+  }
+}
+
+/*
+ * Waits for some milliseconds, in idle sleep mode where available.
+ */
+void iButtonLowPower::idle( uint16_t ms ) {
+#if defined(__AVR__)
+  // Idle mode keeps timers running: the millis() interrupt wakes the MCU every
+  // millisecond
+  set_sleep_mode( SLEEP_MODE_IDLE );
+  uint32_t start = millis();
+  while ( (uint32_t) ( millis() - start ) < ms ) sleep_mode();
+#else
+  delay( ms );
+#endif
+}
+
+/*
+ * Returns true when the timeout of waitCode has passed.
+ */
+bool iButtonLowPower::expired() const {
+  return _timeout && (uint32_t) ( millis() - _start ) >= _timeout;
+}
+
+/*
+ * Returns the time left until the timeout of waitCode, in milliseconds.
+ */
+uint32_t iButtonLowPower::remaining() const {
+  uint32_t elapsed = millis() - _start;
+  return elapsed < _timeout ? _timeout - elapsed : 0;
+}
+
+#if IBUTTON_WAKE_SUPPORTED
+/*
+ * Interrupt handler, data line went low.
+ */
+void IRAM_ATTR iButtonLowPower::wakeHandler() {
+#if defined(__AVR__)
+  detachInterrupt( _interrupt );  // Level interrupt keeps firing otherwise
+#endif
+  _woken = true;
+}
+#endif
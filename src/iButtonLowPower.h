@@ -0,0 +1,79 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonLowPower_h
+#define iButtonLowPower_h
+
+// Includes
+#include <inttypes.h>
+#include <Arduino.h>
+#include "iButtonTag.h"
+
+// Constants for ways of waiting for an iButton
+#define IBUTTON_WAKE_INTERRUPT 1 // Sleeping, woken by the data line going low
+#define IBUTTON_WAKE_POLL      2 // Checking presence at intervals
+
+// Waking by the data line needs a way to sleep until a pin goes low: power-down
+// with a pin interrupt on AVR, light sleep with GPIO wake-up on ESP32. Waiting
+// for an interrupt without sleeping saves nothing, other boards poll.
+#if defined(__AVR__) && defined(digitalPinToInterrupt) && defined(NOT_AN_INTERRUPT)
+#define IBUTTON_WAKE_SUPPORTED 1
+#elif defined(ARDUINO_ARCH_ESP32)
+#define IBUTTON_WAKE_SUPPORTED 1
+#else
+#define IBUTTON_WAKE_SUPPORTED 0
+#endif
+
+// Class definition
+class iButtonLowPower {
+
+  public:
+    // Constructor
+    iButtonLowPower( iButtonTag&, uint8_t, uint16_t = 250 );
+
+    // Functions
+    int8_t begin( int8_t = IBUTTON_WAKE_INTERRUPT );
+    int8_t waitCode( uint8_t*, uint32_t = 0 );
+    int8_t mode() const { return _mode; }
+
+    // Measurements
+    uint32_t latency() const { return _latency; }
+    uint32_t longestLatency() const { return _longest; }
+    uint16_t wakes() const { return _wakes; }
+
+  private:
+    // Settings
+    iButtonTag& _tag;
+    uint8_t _pin;
+    uint16_t _interval;     // Time between presence checks, milliseconds
+    int8_t _mode;
+
+    // State
+    bool _present;          // Presence at last check, polling only
+    uint32_t _start;        // Start of waitCode, milliseconds
+    uint32_t _timeout;      // Timeout of waitCode, milliseconds, 0 for none
+
+    // Measurements
+    uint32_t _latency;      // Wake to code of last waitCode, microseconds
+    uint32_t _longest;
+    uint16_t _wakes;
+
+    // Functions
+    bool sleepUntilLow();
+    bool pollUntilArrival();
+    void idle( uint16_t );
+    bool expired() const;
+    uint32_t remaining() const;
+
+#if IBUTTON_WAKE_SUPPORTED
+    // Interrupt handling
+    static volatile bool _woken;
+    static volatile uint8_t _interrupt;
+    static void wakeHandler();
+#endif
+
+};
+
+#endif // iButtonLowPower_h
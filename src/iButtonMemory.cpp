@@ -0,0 +1,291 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include <Arduino.h>
+#include "iButtonMemory.h"
+
+
+// MEMORY COMMANDS
+
+// Function commands of memory iButtons, after selecting one
+#define WRITE_SCRATCHPAD 0x0F
+#define READ_SCRATCHPAD  0xAA
+#define COPY_SCRATCHPAD  0x55
+#define READ_MEMORY      0xF0 // NVRAM, data up to end of memory
+#define READ_DATA_CRC    0xC3 // EPROM, data and CRC8 of every page
+
+// Flag in ending offset byte of scratchpad: copied to memory
+#define FLAG_COPIED      0x80
+
+// Reads of a page again after a CRC8 failure
+#define READ_RETRIES     2
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonMemory object for the memory of the iButton with the
+ * supplied code, using the bus of the supplied iButtonTag.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonMemory
+ */
+iButtonMemory::iButtonMemory( iButtonTag& tag, const uint8_t* code )
+  : _tag( tag ) {
+  for ( uint8_t i = 0; i < 8; i++ ) _code[i] = code[i];
+  _type = memoryType( code[0] );
+  _size = memorySize( code[0] );
+  _busTime = 0;
+  _busBytes = 0;
+}
+
+/*
+ * Reads memory from an address, handing the data to the handler page by page.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#readMemory
+ */
+int8_t iButtonMemory::read( uint16_t address, uint16_t length,
+                            iButtonMemoryHandler handler ) {
+  return readPages( address, length, handler, NULL );
+}
+
+/*
+ * Reads memory from an address into a buffer.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#readMemory
+ */
+int8_t iButtonMemory::read( uint16_t address, uint8_t* buffer, uint16_t length ) {
+  return readPages( address, length, NULL, buffer );
+}
+
+/*
+ * Writes data to memory from an address, page by page through the scratchpad.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#writeMemory
+ */
+int8_t iButtonMemory::write( uint16_t address, const uint8_t* data,
+                             uint16_t length ) {
+  int8_t status = check( address, length );
+  if ( status != 1 ) return status;
+  if ( _type == IBUTTON_MEMORY_EPROM ) return -5;
+
+  uint32_t start = micros();
+  uint16_t done = 0;
+  while ( done < length ) {
+    uint16_t at = address + done;
+    uint8_t count = IBUTTON_MEMORY_PAGE - ( at & ( IBUTTON_MEMORY_PAGE - 1 ) );
+    if ( length - done < count ) count = length - done;
+    status = writePage( at, data + done, count );
+    if ( status != 1 ) break;
+    done += count;
+  }
+  return finish( micros() - start, done, status );
+}
+
+/*
+ * Returns the bus time of the last read or write per KiB of data, in
+ * microseconds.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#busTimePerKiB
+ */
+uint32_t iButtonMemory::busTimePerKiB() const {
+  if ( _busBytes == 0 ) return 0;
+  return (uint32_t) ( (uint64_t) _busTime * 1024 / _busBytes );
+}
+
+/*
+ * Returns the memory type of a family code.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#memoryType
+ */
+uint8_t iButtonMemory::memoryType( uint8_t family ) {
+  switch ( family ) {
+    case 0x04:                     // DS1994
+    case 0x06:                     // DS1993
+    case 0x08:                     // DS1992
+    case 0x0C:                     // DS1996
+      return IBUTTON_MEMORY_NVRAM;
+    case 0x09:                     // DS1982
+      return IBUTTON_MEMORY_EPROM;
+    default:
+      return IBUTTON_MEMORY_NONE;
+  }
+}
+
+/*
+ * Returns the memory size of a family code, in bytes.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#memorySize
+ */
+uint16_t iButtonMemory::memorySize( uint8_t family ) {
+  switch ( family ) {
+    case 0x08:                     // DS1992, 1 Kbit
+    case 0x09:                     // DS1982, 1 Kbit
+      return 128;
+    case 0x04:                     // DS1994, 4 Kbit
+    case 0x06:                     // DS1993, 4 Kbit
+      return 512;
+    case 0x0C:                     // DS1996, 64 Kbit
+      return 8192;
+    default:
+      return 0;
+  }
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Checks the family is supported and the addresses are within memory.
+ *
+ * Return values:
+ *    1 - Addresses within memory
+ *   -2 - Family not supported, or addresses beyond end of memory
+ */
+int8_t iButtonMemory::check( uint16_t address, uint16_t length ) {
+  if ( _type == IBUTTON_MEMORY_NONE ) return -2;
+  if ( (uint32_t) address + length > _size ) return -2;
+  return 1;
+}
+
+/*
+ * Reads memory from an address in one continuous read: every page goes to the
+ * handler, or to the buffer, as soon as it is read. Only one page is kept in
+ * RAM. EPROM pages are checked with their CRC8 and read again on failure.
+ *
+ * Return values:
+ *    1 - Data read, or reading stopped by handler
+ *    0 - No device present
+ *   -1 - CRC8 failure, also after reading again
+ *   -2 - Family not supported, or addresses beyond end of memory
+ */
+int8_t iButtonMemory::readPages( uint16_t address, uint16_t length,
+                                 iButtonMemoryHandler handler, uint8_t* buffer ) {
+  int8_t status = check( address, length );
+  if ( status != 1 ) return status;
+
+  uint32_t start = micros();
+  uint16_t done = 0;
+  uint8_t retries = 0;
+  bool reading = false;
+  while ( done < length ) {
+    uint16_t at = address + done;
+    if ( !reading ) {
+      status = startRead( at );
+      if ( status == 0 ) break;
+      if ( status < 0 ) {
+        if ( retries++ < READ_RETRIES ) continue;
+        break;
+      }
+      reading = true;
+    }
+
+    // Data up to end of page, for EPROM all of it: the CRC8 follows
+    uint8_t page[IBUTTON_MEMORY_PAGE];
+    uint8_t count = IBUTTON_MEMORY_PAGE - ( at & ( IBUTTON_MEMORY_PAGE - 1 ) );
+    uint8_t wanted = length - done < count ? length - done : count;
+    if ( _type == IBUTTON_MEMORY_NVRAM ) count = wanted;
+    for ( uint8_t i = 0; i < count; i++ ) page[i] = _tag.busRead();
+    if ( _type == IBUTTON_MEMORY_EPROM &&
+         _tag.busRead() != iButtonTag::crc8( page, count ) ) {
+      status = -1;
+      reading = false;                 // Select again, read from this page
+      if ( retries++ < READ_RETRIES ) continue;
+      break;
+    }
+    retries = 0;
+    status = 1;
+
+    done += wanted;
+    if ( buffer != NULL ) {
+      for ( uint8_t i = 0; i < wanted; i++ ) buffer[done - wanted + i] = page[i];
+    } else if ( !handler( at, page, wanted ) ) {
+      break;
+    }
+  }
+  return finish( micros() - start, done, status );
+}
+
+/*
+ * Selects the iButton and starts reading memory at an address. For EPROM the
+ * command and address are checked with the CRC8 sent back.
+ *
+ * Return values:
+ *    1 - Reading started
+ *    0 - No device present
+ *   -1 - CRC8 failure
+ */
+int8_t iButtonMemory::startRead( uint16_t address ) {
+  if ( _tag.selectCode( _code ) == 0 ) return 0;
+  uint8_t command[3] = { READ_MEMORY, (uint8_t) address, (uint8_t) ( address >> 8 ) };
+  if ( _type == IBUTTON_MEMORY_EPROM ) command[0] = READ_DATA_CRC;
+  for ( uint8_t i = 0; i < 3; i++ ) _tag.busWrite( command[i] );
+  if ( _type == IBUTTON_MEMORY_EPROM &&
+       _tag.busRead() != iButtonTag::crc8( command, 3 ) ) return -1;
+  return 1;
+}
+
+/*
+ * Writes data within one page: to the scratchpad, checks the scratchpad read
+ * back, copies it to memory with the authorization read back and checks the
+ * copy is done.
+ *
+ * Return values:
+ *    1 - Data written and copied to memory
+ *    0 - No device present
+ *   -3 - Scratchpad read back differs from data written
+ *   -4 - Scratchpad not copied to memory
+ */
+int8_t iButtonMemory::writePage( uint16_t address, const uint8_t* data,
+                                 uint8_t count ) {
+  uint8_t target[2] = { (uint8_t) address, (uint8_t) ( address >> 8 ) };
+
+  if ( _tag.selectCode( _code ) == 0 ) return 0;
+  _tag.busWrite( WRITE_SCRATCHPAD );
+  _tag.busWrite( target[0] );
+  _tag.busWrite( target[1] );
+  for ( uint8_t i = 0; i < count; i++ ) _tag.busWrite( data[i] );
+
+  // Read back: target address, ending offset without flags, and data
+  if ( _tag.selectCode( _code ) == 0 ) return 0;
+  _tag.busWrite( READ_SCRATCHPAD );
+  uint8_t authorization[3];
+  for ( uint8_t i = 0; i < 3; i++ ) authorization[i] = _tag.busRead();
+  uint8_t ending = ( address & ( IBUTTON_MEMORY_PAGE - 1 ) ) + count - 1;
+  if ( authorization[0] != target[0] || authorization[1] != target[1] ||
+       authorization[2] != ending ) return -3;
+  for ( uint8_t i = 0; i < count; i++ ) {
+    if ( _tag.busRead() != data[i] ) return -3;
+  }
+
+  // Copy, authorized by target address and ending offset as read back
+  if ( _tag.selectCode( _code ) == 0 ) return 0;
+  _tag.busWrite( COPY_SCRATCHPAD );
+  for ( uint8_t i = 0; i < 3; i++ ) _tag.busWrite( authorization[i] );
+
+  // Copy done: flag set in ending offset
+  if ( _tag.selectCode( _code ) == 0 ) return 0;
+  _tag.busWrite( READ_SCRATCHPAD );
+  _tag.busRead();
+  _tag.busRead();
+  if ( !( _tag.busRead() & FLAG_COPIED ) ) return -4;
+  return 1;
+}
+
+/*
+ * Keeps the bus time and number of bytes of a read or write, and passes on
+ * its status.
+ */
+int8_t iButtonMemory::finish( uint32_t time, uint16_t bytes, int8_t status ) {
+  _busTime = time;
+  _busBytes = bytes;
+  return status;
+}
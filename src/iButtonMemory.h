@@ -0,0 +1,68 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonMemory_h
+#define iButtonMemory_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+
+// Constants for memory types
+#define IBUTTON_MEMORY_NONE  0 // Family without memory, or not supported
+#define IBUTTON_MEMORY_NVRAM 1 // NVRAM with scratchpad: DS1992, DS1993, DS1994, DS1996
+#define IBUTTON_MEMORY_EPROM 2 // Add-only EPROM: DS1982, read only
+
+// Size of a memory page and of the scratchpad, in bytes
+#define IBUTTON_MEMORY_PAGE 32
+
+// Type definition of handler for data read: address of first byte, data and
+// number of bytes, at most one page. Returns false to stop reading.
+typedef bool ( *iButtonMemoryHandler )( uint16_t, const uint8_t*, uint8_t );
+
+// Class definition
+class iButtonMemory {
+
+  public:
+    // Constructor
+    iButtonMemory( iButtonTag&, const uint8_t* );
+
+    // Functions
+    uint8_t type() const { return _type; }
+    uint16_t size() const { return _size; }
+    int8_t read( uint16_t, uint16_t, iButtonMemoryHandler );
+    int8_t read( uint16_t, uint8_t*, uint16_t );
+    int8_t write( uint16_t, const uint8_t*, uint16_t );
+
+    // Functions for bus time of last read or write
+    uint32_t busTime() const { return _busTime; }
+    uint16_t busBytes() const { return _busBytes; }
+    uint32_t busTimePerKiB() const;
+
+    // Static functions
+    static uint8_t memoryType( uint8_t );
+    static uint16_t memorySize( uint8_t );
+
+  private:
+    // Settings
+    iButtonTag& _tag;
+    iButtonCode _code;
+    uint8_t _type;
+    uint16_t _size;
+
+    // Bus time of last read or write
+    uint32_t _busTime;      // Microseconds
+    uint16_t _busBytes;     // Bytes transferred to or from memory
+
+    // Functions
+    int8_t check( uint16_t, uint16_t );
+    int8_t readPages( uint16_t, uint16_t, iButtonMemoryHandler, uint8_t* );
+    int8_t startRead( uint16_t );
+    int8_t writePage( uint16_t, const uint8_t*, uint8_t );
+    int8_t finish( uint32_t, uint16_t, int8_t );
+
+};
+
+#endif // iButtonMemory_h
@@ -0,0 +1,172 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonProgrammer.h"
+
+
+// Tag swap: number of presence checks in a row and time between checks
+#define SWAP_CHECKS   3
+#define SWAP_INTERVAL 10 // Milliseconds
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonProgrammer object for a table of iButtonCode's to write.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonProgrammer
+ */
+iButtonProgrammer::iButtonProgrammer( iButtonTag& tag, const iButtonCode* codes,
+                                      uint16_t count,
+                                      bool progmem /* = false */,
+                                      int8_t type /* = IBUTTON_UNKNOWN */ )
+  : _tag( tag ) {
+  _codes = (const uint8_t*) codes;
+  _count = count;
+  _progmem = progmem;
+  _detect = type == IBUTTON_UNKNOWN;
+  _onResult = NULL;
+  _state = count > 0 ? STATE_INSERT : STATE_FINISHED;
+  _type = type;
+  _index = 0;
+  _written = 0;
+  _failed = 0;
+  _checks = 0;
+  _last = 0;
+  _start = 0;
+  _finish = 0;
+}
+
+/*
+ * Continues the batch: waits for a tag, writes it and waits for its removal.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#pollProgrammer
+ */
+int8_t iButtonProgrammer::poll() {
+  switch ( _state ) {
+
+    case STATE_INSERT:
+    case STATE_REMOVE: {
+      // Only RESET the data line once every interval, until a tag is on the
+      // probe (or gone) for a number of checks in a row
+      uint32_t now = millis();
+      if ( (uint32_t) ( now - _last ) < SWAP_INTERVAL ) return IBUTTON_BUSY;
+      _last = now;
+      bool present = _tag.checkPresence() == 1;
+      if ( present != ( _state == STATE_INSERT ) ) {
+        _checks = 0;
+        return IBUTTON_BUSY;
+      }
+      if ( ++_checks < SWAP_CHECKS ) return IBUTTON_BUSY;
+      _checks = 0;
+      if ( _state == STATE_REMOVE ) _state = STATE_INSERT;
+      else startTag();
+      return _state == STATE_FINISHED ? 1 : IBUTTON_BUSY;
+    }
+
+    case STATE_DETECTING: {
+      int8_t status = _tag.pollWrite();
+      if ( status == IBUTTON_BUSY ) return IBUTTON_BUSY;
+      int8_t type = status == 1 ? _tag.detectedType() : status;
+      if ( type < 1 ) {
+        finishTag( type < 0 ? 0 : -12 ); // No iButton, or not detected
+        return _state == STATE_FINISHED ? 1 : IBUTTON_BUSY;
+      }
+      _type = type;
+      startWrite();
+      return _state == STATE_FINISHED ? 1 : IBUTTON_BUSY;
+    }
+
+    case STATE_WRITING: {
+      int8_t status = _tag.pollWrite();
+      if ( status == IBUTTON_BUSY ) return IBUTTON_BUSY;
+      finishTag( status );
+      return _state == STATE_FINISHED ? 1 : IBUTTON_BUSY;
+    }
+
+    default:
+      return 1; // Batch finished
+
+  }
+}
+
+/*
+ * Returns number of tags written per minute.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#tagsPerMinute
+ */
+uint16_t iButtonProgrammer::tagsPerMinute() const {
+  uint32_t time = _finish - _start;
+  if ( _written == 0 || time == 0 ) return 0;
+  return (uint32_t) _written * 60000UL / time;
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Starts the next code for the tag on the probe: detects the type first if not
+ * known yet.
+ */
+void iButtonProgrammer::startTag() {
+  for ( uint8_t i = 0; i < 8; i++ ) {
+    const uint8_t* p = _codes + ( (uint32_t) _index << 3 ) + i;
+    _code[i] = _progmem ? pgm_read_byte( p ) : *p;
+  }
+  if ( _written == 0 && _failed == 0 ) _start = millis();
+
+  // Detect type of blanks once per batch, the first tag is representative.
+  // Detection doesn't block either: it's polled like writing.
+  if ( _type == IBUTTON_UNKNOWN ) {
+    _tag.beginDetect();
+    _state = STATE_DETECTING;
+    return;
+  }
+  startWrite();
+}
+
+/*
+ * Starts writing the current code, to a tag of the known type.
+ */
+void iButtonProgrammer::startWrite() {
+  // Writing with checking on takes only the probe for the known type: a cheap
+  // check the next tag is a blank of the same type
+  int8_t status = _tag.beginWrite( _code, _type, true );
+  if ( status != IBUTTON_BUSY ) {
+    finishTag( status );
+    return;
+  }
+  _state = STATE_WRITING;
+}
+
+/*
+ * Reports the result of writing a tag and moves on to the next tag.
+ */
+void iButtonProgrammer::finishTag( int8_t status ) {
+  if ( _onResult ) _onResult( _index, _code, status );
+
+  if ( status == 1 ) {
+    _written++;
+    _finish = millis();
+  } else {
+    _failed++;
+  }
+
+  // Next code after success, or when the code itself is invalid. Otherwise the
+  // same code is written to the next tag.
+  if ( status == 1 || ( status < 0 && status > -10 ) ) _index++;
+
+  // A tag of another type: detect again for the next tag, if type was detected
+  if ( status == -13 && _detect ) _type = IBUTTON_UNKNOWN;
+
+  _state = _index < _count ? STATE_REMOVE : STATE_FINISHED;
+}
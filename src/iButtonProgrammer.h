@@ -0,0 +1,69 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonProgrammer_h
+#define iButtonProgrammer_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+
+// Type definition of result handler: index in table, code and status as
+// returned by writeCode
+typedef void ( *iButtonResultHandler )( uint16_t, const uint8_t*, int8_t );
+
+// Class definition
+class iButtonProgrammer {
+
+  public:
+    // Constructor
+    iButtonProgrammer( iButtonTag&, const iButtonCode*, uint16_t, bool = false,
+                       int8_t = IBUTTON_UNKNOWN );
+
+    // Result handler
+    void onResult( iButtonResultHandler handler ) { _onResult = handler; }
+
+    // Functions
+    int8_t poll();
+    uint16_t written() const { return _written; }
+    uint16_t failed() const { return _failed; }
+    int8_t type() const { return _type; }
+    uint16_t tagsPerMinute() const;
+
+  private:
+    // States
+    enum { STATE_INSERT, STATE_DETECTING, STATE_WRITING, STATE_REMOVE,
+           STATE_FINISHED };
+
+    // Settings
+    iButtonTag& _tag;
+    const uint8_t* _codes;
+    uint16_t _count;
+    bool _progmem;
+    bool _detect;           // Type detected by batch, not supplied
+
+    // Result handler
+    iButtonResultHandler _onResult;
+
+    // State
+    uint8_t _state;
+    int8_t _type;           // Type of blanks, IBUTTON_UNKNOWN until detected
+    uint16_t _index;        // Index of code to write next
+    uint16_t _written;      // Tags written successfully
+    uint16_t _failed;       // Tags failed
+    uint8_t _checks;        // Presence checks in a row for tag swap
+    uint32_t _last;         // Time of last presence check, millis()
+    uint32_t _start;        // Start of first write, millis()
+    uint32_t _finish;       // End of last successful write, millis()
+    iButtonCode _code;      // Code being written
+
+    // Functions
+    void startTag();
+    void startWrite();
+    void finishTag( int8_t );
+
+};
+
+#endif // iButtonProgrammer_h
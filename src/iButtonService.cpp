@@ -0,0 +1,195 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonService.h"
+
+#if IBUTTON_SERVICE_SUPPORTED
+#include <chrono>
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonService object, reading every reader at the supplied
+ * interval in milliseconds.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonService
+ */
+iButtonService::iButtonService( uint16_t interval /* = 10 */ )
+  : _interval( interval ), _reads( false ), _count( 0 ), _next( 0 ),
+    _running( false ) {}
+
+/*
+ * Destructs an iButtonService object, stopping the reader threads.
+ */
+iButtonService::~iButtonService() {
+  stop();
+}
+
+/*
+ * Adds a reader for the supplied iButtonTag. Returns the index of the reader,
+ * -1 when the service is running or has the maximum number of readers.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#addReader
+ */
+int8_t iButtonService::addReader( iButtonTag& tag ) {
+  if ( running() || _count >= IBUTTON_SERVICE_READERS ) return -1;
+  _readers[_count].tag = &tag;
+  _readers[_count].present = false;
+  return _count++;
+}
+
+/*
+ * Starts a thread for every reader. Returns false when already running or
+ * without readers.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#serviceStart
+ */
+bool iButtonService::start() {
+  if ( running() || _count == 0 ) return false;
+  _running.store( true, std::memory_order_release );
+  for ( uint8_t i = 0; i < _count; i++ ) {
+    _readers[i].thread = std::thread( &iButtonService::run, this, i );
+  }
+  return true;
+}
+
+/*
+ * Stops the reader threads, after the reads in progress. Queued events stay
+ * available to poll.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#serviceStop
+ */
+void iButtonService::stop() {
+  _running.store( false, std::memory_order_release );
+  for ( uint8_t i = 0; i < _count; i++ ) {
+    if ( _readers[i].thread.joinable() ) _readers[i].thread.join();
+  }
+}
+
+/*
+ * Takes the next event of any reader, the readers taking turns, reads last.
+ * Returns false when no events are queued.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#servicePoll
+ */
+bool iButtonService::poll( iButtonEvent& event ) {
+  for ( uint8_t n = 0; n < _count; n++ ) {
+    uint8_t i = _next;
+    _next = _next + 1 < _count ? _next + 1 : 0;
+    Reader& reader = _readers[i];
+    if ( reader.changes.pop( event ) || reader.events.pop( event ) ) return true;
+  }
+  return false;
+}
+
+/*
+ * Queues a write of the supplied code for a reader, done by the reader thread
+ * before its next read. Returns false when the reader doesn't exist or has the
+ * maximum number of writes queued.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#requestWrite
+ */
+bool iButtonService::requestWrite( uint8_t reader, const uint8_t* code,
+                                   int8_t type /* = IBUTTON_UNKNOWN */ ) {
+  if ( reader >= _count ) return false;
+  iButtonWriteRequest request;
+  for ( uint8_t i = 0; i < 8; i++ ) request.code[i] = code[i];
+  request.type = type;
+  return _readers[reader].writes.push( request );
+}
+
+/*
+ * Returns the number of read events dropped by all readers, because queues
+ * were full. Other events are never dropped.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#serviceDropped
+ */
+uint32_t iButtonService::dropped() const {
+  uint32_t dropped = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) dropped += _readers[i].events.dropped();
+  return dropped;
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Reader thread: does the write requests queued, then reads the probe and
+ * queues the events, until the service stops.
+ */
+void iButtonService::run( uint8_t index ) {
+  Reader& reader = _readers[index];
+  while ( _running.load( std::memory_order_acquire ) ) {
+    // Writes only with room for the result, otherwise they wait
+    iButtonWriteRequest request;
+    while ( reader.changes.size() < IBUTTON_SERVICE_CHANGES &&
+            reader.writes.pop( request ) ) {
+      int8_t status = reader.tag -> writeCode( request.code, request.type );
+      push( reader, index, IBUTTON_EVENT_WRITE, status, request.code );
+    }
+
+    iButtonCode code;
+    int8_t status = reader.tag -> readCode( code );
+    if ( status != 0 && _reads.load( std::memory_order_relaxed ) ) {
+      push( reader, index, IBUTTON_EVENT_READ, status, code );
+    }
+
+    // Presence changes only once its event is queued: with the queue full, the
+    // change is found again by the next read and queued then
+    if ( status == 0 && reader.present ) {
+      if ( push( reader, index, IBUTTON_EVENT_DEPART, 1, reader.code ) ) {
+        reader.present = false;
+      }
+    } else if ( status == 1 && !( reader.present &&
+                iButtonTag::equalCode( code, reader.code ) ) ) {
+      // Other iButton without a read in between with nothing present: the
+      // first one departed
+      if ( reader.present &&
+           push( reader, index, IBUTTON_EVENT_DEPART, 1, reader.code ) ) {
+        reader.present = false;
+      }
+      if ( !reader.present && push( reader, index, IBUTTON_EVENT_ARRIVE, 1, code ) ) {
+        reader.present = true;
+        for ( uint8_t i = 0; i < 8; i++ ) reader.code[i] = code[i];
+      }
+    }
+
+    if ( _interval > 0 ) {
+      std::this_thread::sleep_for( std::chrono::milliseconds( _interval ) );
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/*
+ * Queues an event of a reader: writes, arrivals and departures in a queue of
+ * their own, so reads can't crowd them out.
+ *
+ * Return values:
+ *   true  - Event queued
+ *   false - Queue full, event dropped
+ */
+bool iButtonService::push( Reader& reader, uint8_t index, uint8_t type,
+                           int8_t status, const uint8_t* code ) {
+  iButtonEvent event;
+  event.type = type;
+  event.reader = index;
+  event.status = status;
+  for ( uint8_t i = 0; i < 8; i++ ) event.code[i] = code[i];
+  event.time = millis();
+  if ( type == IBUTTON_EVENT_READ ) return reader.events.push( event );
+  return reader.changes.push( event );
+}
+
+#endif // IBUTTON_SERVICE_SUPPORTED
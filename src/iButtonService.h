@@ -0,0 +1,167 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonService_h
+#define iButtonService_h
+
+// Includes
+#include <inttypes.h>
+#include <Arduino.h>
+#include "iButtonTag.h"
+#include "iButtonFrame.h"
+
+// Reader service runs every reader in a thread of its own with std::thread,
+// available on ESP32 (threads are FreeRTOS tasks) and on Linux
+#if ( defined(ESP32) || defined(__linux__) ) && !defined(__AVR__)
+#define IBUTTON_SERVICE_SUPPORTED 1
+#else
+#define IBUTTON_SERVICE_SUPPORTED 0
+#endif
+
+// Constants for event types, read and write the same as frame types
+#define IBUTTON_EVENT_READ   IBUTTON_FRAME_READ  // Code read, status of readCode
+#define IBUTTON_EVENT_WRITE  IBUTTON_FRAME_WRITE // Code written, status of writeCode
+#define IBUTTON_EVENT_ARRIVE 4                   // iButton arrived
+#define IBUTTON_EVENT_DEPART 5                   // iButton departed
+
+// Maximum number of readers of a service
+#ifndef IBUTTON_SERVICE_READERS
+#define IBUTTON_SERVICE_READERS 8
+#endif
+
+// Number of read events, other events and write requests queued per reader,
+// powers of 2
+#ifndef IBUTTON_SERVICE_EVENTS
+#define IBUTTON_SERVICE_EVENTS 64
+#endif
+#ifndef IBUTTON_SERVICE_CHANGES
+#define IBUTTON_SERVICE_CHANGES 8
+#endif
+#ifndef IBUTTON_SERVICE_WRITES
+#define IBUTTON_SERVICE_WRITES 4
+#endif
+
+// Structure of an event, as queued by a reader
+struct iButtonEvent {
+  uint8_t type;           // IBUTTON_EVENT_READ up to IBUTTON_EVENT_DEPART
+  uint8_t reader;         // Index of reader, as returned by addReader
+  int8_t status;          // Status of readCode or writeCode, 1 otherwise
+  iButtonCode code;
+  uint32_t time;          // millis() of reader thread
+};
+
+// Structure of a write request, as queued for a reader
+struct iButtonWriteRequest {
+  iButtonCode code;
+  int8_t type;
+};
+
+#if IBUTTON_SERVICE_SUPPORTED
+// Includes
+#include <atomic>
+#include <thread>
+
+// Class definition, lock-free queue between one producer and one consumer
+// thread. Each index is written by one side only: storing it with release
+// order and loading the other one with acquire order makes an item visible
+// before the index that hands it over. The items are between the two indexes,
+// keeping them out of each other's cache line for queues of 64 bytes or more.
+template <class T, uint16_t N>
+class iButtonQueue {
+
+  public:
+    // Constructor
+    iButtonQueue() : _head( 0 ), _tail( 0 ), _dropped( 0 ) {}
+
+    // Producer side: false when full, item dropped
+    bool push( const T& item ) {
+      uint16_t head = _head.load( std::memory_order_relaxed );
+      if ( (uint16_t) ( head - _tail.load( std::memory_order_acquire ) ) >= N ) {
+        _dropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+      }
+      _items[head & ( N - 1 )] = item;
+      _head.store( (uint16_t) ( head + 1 ), std::memory_order_release );
+      return true;
+    }
+
+    // Consumer side: false when empty
+    bool pop( T& item ) {
+      uint16_t tail = _tail.load( std::memory_order_relaxed );
+      if ( tail == _head.load( std::memory_order_acquire ) ) return false;
+      item = _items[tail & ( N - 1 )];
+      _tail.store( (uint16_t) ( tail + 1 ), std::memory_order_release );
+      return true;
+    }
+
+    // Either side, a snapshot
+    uint16_t size() const {
+      return (uint16_t) ( _head.load( std::memory_order_acquire ) -
+                          _tail.load( std::memory_order_acquire ) );
+    }
+    uint32_t dropped() const { return _dropped.load( std::memory_order_relaxed ); }
+
+  private:
+    static_assert( N > 0 && ( N & ( N - 1 ) ) == 0, "Queue size must be a power of 2" );
+
+    std::atomic<uint16_t> _head;     // Written by producer only
+    T _items[N];
+    std::atomic<uint16_t> _tail;     // Written by consumer only
+    std::atomic<uint32_t> _dropped;  // Items not queued, queue full
+
+};
+
+// Class definition
+class iButtonService {
+
+  public:
+    // Constructor and destructor, destructor stops the service
+    iButtonService( uint16_t = 10 );
+    ~iButtonService();
+
+    // Functions, setup and control
+    int8_t addReader( iButtonTag& );
+    bool start();
+    void stop();
+    bool running() const { return _running.load( std::memory_order_acquire ); }
+    uint8_t readers() const { return _count; }
+    void reportReads( bool reads ) { _reads = reads; }
+
+    // Functions, consumer side: call from one thread only
+    bool poll( iButtonEvent& );
+    bool requestWrite( uint8_t, const uint8_t*, int8_t = IBUTTON_UNKNOWN );
+    uint32_t dropped() const;
+
+  private:
+    // State of a reader: the tag is used by the reader thread only while the
+    // service runs
+    struct Reader {
+      iButtonTag* tag;
+      std::thread thread;
+      iButtonQueue<iButtonEvent, IBUTTON_SERVICE_EVENTS> events;   // Reads
+      iButtonQueue<iButtonEvent, IBUTTON_SERVICE_CHANGES> changes; // Other events
+      iButtonQueue<iButtonWriteRequest, IBUTTON_SERVICE_WRITES> writes;
+      bool present;         // iButton on probe, as of last read
+      iButtonCode code;     // Code of iButton on probe
+    };
+
+    // Settings
+    uint16_t _interval;     // Time between reads, milliseconds, 0 for no wait
+    std::atomic<bool> _reads; // Every read reported, not only arrive and depart
+
+    // Readers
+    Reader _readers[IBUTTON_SERVICE_READERS];
+    uint8_t _count;
+    uint8_t _next;          // Reader polled first, for a fair share
+    std::atomic<bool> _running;
+
+    // Functions, reader thread
+    void run( uint8_t );
+    bool push( Reader&, uint8_t, uint8_t, int8_t, const uint8_t* );
+
+};
+#endif
+
+#endif // iButtonService_h
@@ -0,0 +1,84 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonStorage.h"
+
+#if IBUTTON_EEPROM_SUPPORTED
+
+#include <EEPROM.h>
+
+// EEPROM emulated in flash memory needs begin with its size, and commit
+#if defined(ESP8266) || defined(ESP32) || defined(ARDUINO_ARCH_RP2040)
+#define EEPROM_EMULATED 1
+#else
+#define EEPROM_EMULATED 0
+#endif
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonEepromStorage object on part of the built-in EEPROM.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonEepromStorage
+ */
+iButtonEepromStorage::iButtonEepromStorage( uint16_t start, uint16_t size ) {
+  _start = start;
+  _size = size;
+}
+
+/*
+ * Prepares the EEPROM for use.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginEeprom
+ */
+bool iButtonEepromStorage::begin() {
+#if EEPROM_EMULATED
+  EEPROM.begin( _start + _size );
+#endif
+  return (uint32_t) _start + _size <= EEPROM.length();
+}
+
+/*
+ * Reads a byte.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonStorage
+ */
+uint8_t iButtonEepromStorage::read( uint16_t address ) {
+  return EEPROM.read( _start + address );
+}
+
+/*
+ * Writes a byte, only when changed: an EEPROM cell wears with every write.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonStorage
+ */
+void iButtonEepromStorage::write( uint16_t address, uint8_t b ) {
+#if EEPROM_EMULATED
+  EEPROM.write( _start + address, b ); // Only marks changes in RAM copy
+#else
+  EEPROM.update( _start + address, b );
+#endif
+}
+
+/*
+ * Makes written bytes persistent.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonStorage
+ */
+void iButtonEepromStorage::commit() {
+#if EEPROM_EMULATED
+  EEPROM.commit();
+#endif
+}
+
+#endif // IBUTTON_EEPROM_SUPPORTED
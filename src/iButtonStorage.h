@@ -0,0 +1,60 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonStorage_h
+#define iButtonStorage_h
+
+// Includes
+#include <inttypes.h>
+
+// Built-in EEPROM storage needs the EEPROM library of the board
+#if defined(__has_include)
+#if __has_include(<EEPROM.h>)
+#define IBUTTON_EEPROM_SUPPORTED 1
+#endif
+#endif
+#ifndef IBUTTON_EEPROM_SUPPORTED
+#define IBUTTON_EEPROM_SUPPORTED 0
+#endif
+
+// Class definition, interface of persistent byte storage
+class iButtonStorage {
+
+  public:
+    // Size in bytes, addresses are 0 up to size
+    virtual uint16_t size() = 0;
+
+    // Reading and writing single bytes, write only stores changed bytes
+    virtual uint8_t read( uint16_t ) = 0;
+    virtual void write( uint16_t, uint8_t ) = 0;
+
+    // Makes written bytes persistent, for storage that buffers writes
+    virtual void commit() {}
+
+};
+
+#if IBUTTON_EEPROM_SUPPORTED
+// Class definition, part of the built-in EEPROM of the board
+class iButtonEepromStorage : public iButtonStorage {
+
+  public:
+    // Constructor
+    iButtonEepromStorage( uint16_t, uint16_t );
+
+    // Functions
+    bool begin();
+    uint16_t size() { return _size; }
+    uint8_t read( uint16_t );
+    void write( uint16_t, uint8_t );
+    void commit();
+
+  private:
+    uint16_t _start;
+    uint16_t _size;
+
+};
+#endif
+
+#endif // iButtonStorage_h
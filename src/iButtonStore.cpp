@@ -0,0 +1,302 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonStore.h"
+
+
+// CONSTANTS
+
+// Storage layout: header, followed by slots of 6 bytes holding a serial
+//   header - Magic "iB", family code, unused, count, tombstones
+#define HEADER_SIZE    8
+#define SLOT_SIZE      6
+#define MAGIC_0        'i'
+#define MAGIC_1        'B'
+
+// Slot contents: never used slots are all 0xFF like erased EEPROM, slots of
+// removed codes (tombstones) all 0x00. Neither is a valid serial.
+#define FILL_EMPTY     0xFF
+#define FILL_TOMBSTONE 0x00
+
+// Results of comparing a slot
+#define SLOT_EMPTY     -1
+#define SLOT_TOMBSTONE -2
+#define SLOT_OTHER      0
+#define SLOT_MATCH      1
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonStore object on the supplied storage.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonStore
+ */
+iButtonStore::iButtonStore( iButtonStorage& storage, uint8_t family /* = 0x01 */ )
+  : _storage( storage ) {
+  _family = family;
+  _slots = 0;
+  _count = 0;
+  _tombstones = 0;
+}
+
+/*
+ * Checks the storage holds a store and reads its counts.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginStore
+ */
+bool iButtonStore::begin() {
+  _slots = 0;
+  if ( _storage.size() < HEADER_SIZE + 4 * SLOT_SIZE ) return false;
+  if ( _storage.read( 0 ) != MAGIC_0 || _storage.read( 1 ) != MAGIC_1 ) return false;
+  if ( _storage.read( 2 ) != _family ) return false;
+
+  uint16_t slots = ( _storage.size() - HEADER_SIZE ) / SLOT_SIZE;
+  _count = _storage.read( 4 ) | ( _storage.read( 5 ) << 8 );
+  _tombstones = _storage.read( 6 ) | ( _storage.read( 7 ) << 8 );
+  if ( (uint32_t) _count + _tombstones >= slots ) return false;
+  _slots = slots;
+  return true;
+}
+
+/*
+ * Removes all codes and starts a new store.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#clearStore
+ */
+void iButtonStore::clear() {
+  _slots = ( _storage.size() - HEADER_SIZE ) / SLOT_SIZE;
+  for ( uint16_t i = 0; i < _slots; i++ ) writeFill( i, FILL_EMPTY );
+  _storage.write( 0, MAGIC_0 );
+  _storage.write( 1, MAGIC_1 );
+  _storage.write( 2, _family );
+  _storage.write( 3, 0 );
+  _count = 0;
+  _tombstones = 0;
+  writeCounts();
+}
+
+/*
+ * Adds an iButtonCode to the store.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#insert
+ */
+int8_t iButtonStore::insert( const uint8_t* code ) {
+  // Only the serial is stored, family code must be the one of the store
+  if ( _slots == 0 || code[0] != _family ) return -2;
+  const uint8_t* serial = code + 1;
+  if ( filled( serial, FILL_EMPTY ) || filled( serial, FILL_TOMBSTONE ) ) return -2;
+
+  // Probe until the code or an empty slot is found, remember the first
+  // tombstone on the way: reusing it keeps probe sequences short
+  uint16_t slot = hash( serial );
+  int32_t reuse = -1;
+  int8_t c = SLOT_OTHER;
+  for ( uint16_t n = 0; n < _slots; n++ ) {
+    c = compareSlot( slot, serial );
+    if ( c == SLOT_MATCH ) return 0;
+    if ( c == SLOT_EMPTY ) break;
+    if ( c == SLOT_TOMBSTONE && reuse < 0 ) reuse = slot;
+    slot = nextSlot( slot );
+  }
+
+  if ( reuse >= 0 ) {
+    writeSlot( reuse, serial );
+    _tombstones--;
+  } else {
+    // Taking an empty slot: keep the load low, so probe sequences stay short
+    if ( c != SLOT_EMPTY || _count + _tombstones >= capacity() ) {
+      if ( _tombstones == 0 ) return -1;
+      compact();
+      return insert( code );
+    }
+    writeSlot( slot, serial );
+  }
+  _count++;
+  writeCounts();
+  return 1;
+}
+
+/*
+ * Removes an iButtonCode from the store.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#remove
+ */
+int8_t iButtonStore::remove( const uint8_t* code ) {
+  int32_t slot = find( code );
+  if ( slot < 0 ) return 0;
+
+  // A tombstone keeps probe sequences through the slot intact. Not needed when
+  // the next slot is empty: no probe sequence continues past the slot then.
+  if ( compareSlot( nextSlot( slot ), NULL ) == SLOT_EMPTY ) {
+    writeFill( slot, FILL_EMPTY );
+  } else {
+    writeFill( slot, FILL_TOMBSTONE );
+    _tombstones++;
+  }
+  _count--;
+  writeCounts();
+  return 1;
+}
+
+/*
+ * Removes all tombstones, moving codes closer to their hash slot.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#compact
+ */
+void iButtonStore::compact() {
+  if ( _slots == 0 || _tombstones == 0 ) return;
+
+  // One tombstone at a time: every code can be found after every step, the
+  // remaining tombstones keep probe sequences intact. A tombstone moved back
+  // by closeGap lands no further back than the slot just emptied, so the scan
+  // still comes across it.
+  uint16_t slot = 0;
+  uint32_t steps = 0;
+  while ( _tombstones > 0 && steps < 2UL * _slots ) {
+    if ( compareSlot( slot, NULL ) == SLOT_TOMBSTONE ) {
+      writeFill( slot, FILL_EMPTY );
+      closeGap( slot );
+      _tombstones--;
+    } else {
+      slot = nextSlot( slot );
+      steps++;
+    }
+  }
+  _tombstones = 0;
+  writeCounts();
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Looks up an iButtonCode, returns its slot or -1 when not found.
+ */
+int32_t iButtonStore::find( const uint8_t* code ) {
+  if ( _slots == 0 || code[0] != _family ) return -1;
+  uint16_t slot = hash( code + 1 );
+  for ( uint16_t n = 0; n < _slots; n++ ) {
+    int8_t c = compareSlot( slot, code + 1 );
+    if ( c == SLOT_MATCH ) return slot;
+    if ( c == SLOT_EMPTY ) return -1;
+    slot = nextSlot( slot );
+  }
+  return -1;
+}
+
+/*
+ * Closes the gap of an empty slot in the middle of probe sequences: moves the
+ * codes after it back that can't be found anymore otherwise, until an empty
+ * slot. Backward shift deletion, Knuth's Algorithm R. A tombstone on the way
+ * belongs to no probe sequence and is moved back as well.
+ */
+void iButtonStore::closeGap( uint16_t gap ) {
+  uint8_t serial[SLOT_SIZE];
+  uint16_t slot = gap;
+  for ( uint16_t n = 1; n < _slots; n++ ) {
+    slot = nextSlot( slot );
+    int8_t c = compareSlot( slot, NULL );
+    if ( c == SLOT_EMPTY ) return;
+
+    if ( c == SLOT_TOMBSTONE ) {
+      writeFill( gap, FILL_TOMBSTONE );
+    } else {
+      // Code stays when its hash slot lies after the gap, up to the code
+      for ( uint8_t i = 0; i < SLOT_SIZE; i++ ) {
+        serial[i] = _storage.read( HEADER_SIZE + slot * SLOT_SIZE + i );
+      }
+      uint16_t home = hash( serial );
+      bool stays = gap <= slot ? ( home > gap && home <= slot )
+                               : ( home > gap || home <= slot );
+      if ( stays ) continue;
+      writeSlot( gap, serial );   // Written first: no code lost on power loss
+    }
+    writeFill( slot, FILL_EMPTY );
+    gap = slot;
+  }
+}
+
+/*
+ * Returns the hash slot of a serial: FNV-1a, folded to 16 bits. Serials of a
+ * batch of tags often differ in a few bits only, every bit must count.
+ */
+uint16_t iButtonStore::hash( const uint8_t* serial ) const {
+  uint32_t h = 2166136261UL;
+  for ( uint8_t i = 0; i < SLOT_SIZE; i++ ) {
+    h ^= serial[i];
+    h *= 16777619UL;
+  }
+  return (uint16_t) ( h ^ ( h >> 16 ) ) % _slots;
+}
+
+/*
+ * Compares a slot to a serial, reading no further than needed. Without serial
+ * only tells empty slots and tombstones from slots holding a code.
+ *
+ * Return values:
+ *   SLOT_MATCH     - Slot holds the serial
+ *   SLOT_OTHER     - Slot holds another serial
+ *   SLOT_EMPTY     - Slot never used
+ *   SLOT_TOMBSTONE - Slot of a removed code
+ */
+int8_t iButtonStore::compareSlot( uint16_t slot, const uint8_t* serial ) {
+  uint16_t address = HEADER_SIZE + slot * SLOT_SIZE;
+  bool match = serial != NULL;
+  bool empty = true;
+  bool tombstone = true;
+  for ( uint8_t i = 0; i < SLOT_SIZE; i++ ) {
+    uint8_t b = _storage.read( address + i );
+    if ( match && b != serial[i] ) match = false;
+    if ( b != FILL_EMPTY ) empty = false;
+    if ( b != FILL_TOMBSTONE ) tombstone = false;
+    if ( !match && !empty && !tombstone ) return SLOT_OTHER;
+  }
+  if ( empty ) return SLOT_EMPTY;
+  if ( tombstone ) return SLOT_TOMBSTONE;
+  return match ? SLOT_MATCH : SLOT_OTHER;
+}
+
+/*
+ * Returns true when all bytes of a serial have the fill value.
+ */
+bool iButtonStore::filled( const uint8_t* serial, uint8_t fill ) {
+  for ( uint8_t i = 0; i < SLOT_SIZE; i++ ) if ( serial[i] != fill ) return false;
+  return true;
+}
+
+/*
+ * Writes a serial to a slot.
+ */
+void iButtonStore::writeSlot( uint16_t slot, const uint8_t* serial ) {
+  uint16_t address = HEADER_SIZE + slot * SLOT_SIZE;
+  for ( uint8_t i = 0; i < SLOT_SIZE; i++ ) _storage.write( address + i, serial[i] );
+}
+
+/*
+ * Fills a slot with one value, to mark it empty or a tombstone.
+ */
+void iButtonStore::writeFill( uint16_t slot, uint8_t fill ) {
+  uint16_t address = HEADER_SIZE + slot * SLOT_SIZE;
+  for ( uint8_t i = 0; i < SLOT_SIZE; i++ ) _storage.write( address + i, fill );
+}
+
+/*
+ * Writes the counts to the header and makes all writes persistent.
+ */
+void iButtonStore::writeCounts() {
+  _storage.write( 4, _count );
+  _storage.write( 5, _count >> 8 );
+  _storage.write( 6, _tombstones );
+  _storage.write( 7, _tombstones >> 8 );
+  _storage.commit();
+}
@@ -0,0 +1,57 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonStore_h
+#define iButtonStore_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+#include "iButtonStorage.h"
+
+// Class definition
+class iButtonStore {
+
+  public:
+    // Constructor
+    iButtonStore( iButtonStorage&, uint8_t = 0x01 );
+
+    // Functions
+    bool begin();
+    void clear();
+    int8_t insert( const uint8_t* );
+    int8_t remove( const uint8_t* );
+    bool contains( const uint8_t* code ) { return find( code ) >= 0; }
+    void compact();
+    uint16_t count() const { return _count; }
+    uint16_t capacity() const { return (uint32_t) _slots * 3 / 4; }
+    uint16_t tombstones() const { return _tombstones; }
+
+  private:
+    // Settings
+    iButtonStorage& _storage;
+    uint8_t _family;
+
+    // Hash table in storage
+    uint16_t _slots;        // Number of slots
+    uint16_t _count;        // Slots holding a code
+    uint16_t _tombstones;   // Slots of removed codes
+
+    // Functions
+    int32_t find( const uint8_t* );
+    void closeGap( uint16_t );
+    uint16_t hash( const uint8_t* ) const;
+    int8_t compareSlot( uint16_t, const uint8_t* );
+    void writeSlot( uint16_t, const uint8_t* );
+    void writeFill( uint16_t, uint8_t );
+    void writeCounts();
+    uint16_t nextSlot( uint16_t slot ) const { return slot + 1 == _slots ? 0 : slot + 1; }
+
+    // Static functions
+    static bool filled( const uint8_t*, uint8_t );
+
+};
+
+#endif // iButtonStore_h
@@ -13,6 +13,106 @@
 #include "iButtonTag.h"
 
 
+// CRC8 LOOKUP TABLES
+
+#if IBUTTON_CRC8 == IBUTTON_CRC8_NIBBLE
+// CRC8 of all 4-bit values, Dallas/Maxim polynomial (x^8 + x^5 + x^4 + 1)
+static const uint8_t crc8table[16] PROGMEM = {
+  0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8,
+  0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74
+};
+#else
+// CRC8 of all 8-bit values, Dallas/Maxim polynomial (x^8 + x^5 + x^4 + 1)
+static const uint8_t crc8table[256] PROGMEM = {
+  0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83,
+  0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+  0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E,
+  0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+  0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0,
+  0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+  0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D,
+  0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+  0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5,
+  0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+  0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58,
+  0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+  0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6,
+  0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+  0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B,
+  0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+  0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F,
+  0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+  0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92,
+  0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+  0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C,
+  0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+  0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1,
+  0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+  0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49,
+  0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+  0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4,
+  0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+  0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A,
+  0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+  0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7,
+  0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35
+};
+#endif
+
+
+// WRITE PROCEDURE
+
+// Phases of the (non-blocking) write procedure
+#define PHASE_IDLE           0
+#define PHASE_PROBE_RW1990V1 1
+#define PHASE_PROBE_RW1990V2 2
+#define PHASE_PROBE_RW2004   3
+#define PHASE_ENABLE         4
+#define PHASE_CODE           5
+#define PHASE_DISABLE        6
+#define PHASE_RW2004         7
+#define PHASE_VERIFY         8
+#define PHASE_LOOKUP         9
+
+// Internal status of a procedure step, not finished yet
+#define STEP_BUSY 0x7F
+
+// Delays after steps, in microseconds. Defaults of the timing profile for
+// programming a bit (RW1990V1, RW1990V2 and TM01) or a byte (RW2004) are on
+// the safe side, calibrateWriteDelay can find shorter ones for actual tags.
+#define DELAY_FLAG         10000
+#define DELAY_RW2004_BYTE    600
+#define DELAY_RW2004_PULSE 50000
+
+// ROM commands switching devices supporting it to overdrive speed, until a
+// reset at standard speed
+#define OVERDRIVE_SKIP_ROM  0x3C
+#define OVERDRIVE_MATCH_ROM 0x69
+
+// Consensus reads: invalid reads in a row before switching between READ ROM
+// commands 0x33 and 0x0F
+#define STABLE_SWITCH        2
+// and distinct valid codes counted, the one with the fewest reads replaced
+#define STABLE_CODES         4
+
+// Calibration of programming delays
+#define CALIBRATE_MIN        250 // Shortest delay tried, microseconds
+#define CALIBRATE_STEPS        8 // Number of write trials
+
+
+// STATISTICS
+
+// Time calls of public functions, ending with a return of the status
+#if IBUTTON_STATS
+#define STATS_BEGIN uint32_t statsStart = micros()
+#define STATS_RETURN( latency, status ) \
+  return recordCall( _stats.latency, statsStart, status )
+#else
+#define STATS_BEGIN
+#define STATS_RETURN( latency, status ) return status
+#endif
+
+
 // PUBLIC FUNCTIONS
 
 /*
@@ -20,8 +120,19 @@
  *
  * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#constructor
  */
-iButtonTag::iButtonTag( uint8_t pin ) {
-  _wire = new OneWire( pin );
+iButtonTag::iButtonTag( uint8_t pin ) : _pinBus( pin ) {
+  _bus = &_pinBus;
+  init();
+}
+
+/*
+ * Constructs an iButtonTag object on the supplied bus backend.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#constructor
+ */
+iButtonTag::iButtonTag( iButtonBus& bus ) {
+  _bus = &bus;
+  init();
 }
 
 /*
@@ -30,21 +141,108 @@ iButtonTag::iButtonTag( uint8_t pin ) {
  * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#readCode
  */
 int8_t iButtonTag::readCode( uint8_t* code, bool old /* = false */ ) {
+  STATS_BEGIN;
+
+  // The iButton read last is at overdrive speed, if it supports it: only as
+  // long as it stays, devices assert presence at overdrive speed
+  if ( _busOverdrive ) {
+    if ( busReset( true ) ) {
+      busWrite( old ? 0x0F : 0x33 );
+      for ( uint8_t i = 0; i < 8; i++ ) code[i] = busRead();
+      if ( testRead( code ) == 1 ) STATS_RETURN( readCode, 1 );
+    }
+    // Falls back to standard speed: the reset returns all devices to it
+  }
+
   // RESET the data line
   // - Connected devices will assert presence with a pulse
   // - Returns 1 if at least one device is present, 0 otherwise
   // - Exit with status 0 when no device asserted presence
-  if ( _wire -> reset() == 0 ) return 0;
+  if ( busReset() == 0 ) STATS_RETURN( readCode, 0 );
 
   // Issue READ ROM command to the data line
   // - 0x33 is protocol standard
   // - 0x0F for compatibility with DS1990
-  _wire -> write( old ? 0x0F : 0x33 );
+  busWrite( old ? 0x0F : 0x33 );
   // Read 8 bytes of identifying code
-  for ( uint8_t i = 0; i < 8; i++ ) code[i] = _wire -> read();
+  for ( uint8_t i = 0; i < 8; i++ ) code[i] = busRead();
 
-  // Test the identifying code and return result
-  return testCode( code );
+  // Test the identifying code, switch the iButton to overdrive speed for the
+  // next read if it supports it and return result
+  int8_t status = testRead( code );
+  if ( status == 1 && _speed != IBUTTON_SPEED_STANDARD ) enterOverdrive( code, old );
+  STATS_RETURN( readCode, status );
+}
+
+/*
+ * Reads one single iButtonCode from the data line until the same code is read
+ * a number of times, for iButtons sliding on the probe. Reads are tallied, not
+ * counted in a row: reads A, B, A agree 2 times on code A.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#readCodeStable
+ */
+int8_t iButtonTag::readCodeStable( uint8_t* code, uint8_t agree /* = 2 */,
+                                   uint8_t tries /* = 8 */,
+                                   uint16_t timeout /* = 100 */,
+                                   uint8_t* attempts /* = NULL */ ) {
+  iButtonCode read;
+  iButtonCode seen[STABLE_CODES];  // Distinct valid codes read
+  uint8_t votes[STABLE_CODES];     // Number of reads of each
+  uint8_t kept = 0;
+  uint8_t best = 0;         // Reads of the code in code, most of all
+  uint8_t failed = 0;       // Invalid reads in a row
+  uint8_t done = 0;
+  bool old = false;
+  int8_t result = 0;
+  uint32_t start = millis();
+  if ( agree == 0 ) agree = 1;
+
+  // Read until any valid code has been read enough times, in any order: an
+  // iButton flipping between two codes still settles. Invalid reads don't
+  // count. Reads that keep failing with READ ROM 0x33 are retried with 0x0F,
+  // for DS1990 tags, and back.
+  while ( done < tries ) {
+    int8_t status = readCode( read, old );
+    done++;
+    if ( status == 0 && done == 1 ) break;  // Nothing on the probe
+    if ( status == 1 ) {
+      failed = 0;
+      uint8_t k = 0;
+      while ( k < kept && !equalCode( read, seen[k] ) ) k++;
+      if ( k == kept ) {
+        if ( kept < STABLE_CODES ) {
+          kept++;
+        } else {                            // Table full: replace fewest reads
+          k = 0;
+          for ( uint8_t j = 1; j < STABLE_CODES; j++ ) {
+            if ( votes[j] < votes[k] ) k = j;
+          }
+        }
+        for ( uint8_t i = 0; i < 8; i++ ) seen[k][i] = read[i];
+        votes[k] = 0;
+      }
+      votes[k]++;
+      if ( votes[k] >= best ) {             // Read most often, latest on a tie
+        best = votes[k];
+        for ( uint8_t i = 0; i < 8; i++ ) code[i] = read[i];
+      }
+      result = votes[k] >= agree ? 1 : -3;
+      if ( result == 1 ) break;
+    } else {
+      if ( status < 0 && kept == 0 ) {      // No valid code, show invalid read
+        for ( uint8_t i = 0; i < 8; i++ ) code[i] = read[i];
+        result = status;
+      }
+      if ( ++failed >= STABLE_SWITCH ) {
+        old = !old;
+        failed = 0;
+      }
+    }
+    if ( timeout > 0 && (uint32_t) ( millis() - start ) >= timeout ) break;
+  }
+
+  if ( attempts ) *attempts = done;
+  return result;
 }
 
 /*
@@ -53,16 +251,18 @@ int8_t iButtonTag::readCode( uint8_t* code, bool old /* = false */ ) {
  * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#readCodes
  */
 int8_t iButtonTag::readCodes() {
-  // RESET the data line
-  // - Connected devices will assert presence with a pulse
-  // - Returns 1 if at least one device is present, 0 otherwise
-  // - Exit with status 0 when no device asserted presence
-  if ( _wire -> reset() == 0 ) return 0;
-
-  // Reset search domain on data line
-  _wire -> reset_search();
+  _searchFamily = -1;
+  return beginSearch();
+}
 
-  return 1;
+/*
+ * Starts the search for multiple iButtonCode's of one family on the data line.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#readCodes
+ */
+int8_t iButtonTag::readCodes( uint8_t family ) {
+  _searchFamily = family;
+  return beginSearch();
 }
 
 /*
@@ -71,13 +271,173 @@ int8_t iButtonTag::readCodes() {
  * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#nextCode
  */
 int8_t iButtonTag::nextCode( uint8_t* code ) {
+  STATS_BEGIN;
+
   // Search for the next iButtonCode on data line
   // - Returns 1 when a code is found, 0 when there are no more iButtons
+  // - Falls back to standard speed when no device is found at overdrive speed
   // - Exit with status 0 when no more iButtons are detected
-  if ( _wire -> search( code ) == 0 ) return 0;
+  iButtonCode rom;
+  busSpeed( _searchOverdrive );
+  uint8_t found = _bus -> search( rom );
+  if ( found == 0 && _searchOverdrive && _searchFirst ) {
+    _searchOverdrive = false;
+    busSpeed( false );
+    restartSearch();
+    found = _bus -> search( rom );
+  }
+  _searchFirst = false;
+  if ( found == 0 ) STATS_RETURN( nextCode, 0 );
 
-  // Test the identifying code and return result
-  return testCode( code );
+#if IBUTTON_STATS
+  // Count the bus operations of a complete search: reset, SEARCH ROM command
+  // and for each of 64 bits two bits read and one written
+  _stats.resets++;
+  _stats.bytesWritten++;
+  _stats.bitsRead += 128;
+  _stats.bitsWritten += 64;
+#endif
+
+  // Devices of a family come one after another in the search: the first one
+  // of another family ends the search, the next call starts it again
+  if ( _searchFamily >= 0 && rom[0] != _searchFamily ) {
+    restartSearch();
+    _searchFirst = true;
+    STATS_RETURN( nextCode, 0 );
+  }
+  for ( uint8_t i = 0; i < 8; i++ ) code[i] = rom[i];
+
+  // Test the identifying code and return result, found at overdrive speed
+  // means the iButton supports it
+  int8_t status = testRead( code );
+  if ( status == 1 && _searchOverdrive ) speedStore( code, true );
+  STATS_RETURN( nextCode, status );
+}
+
+/*
+ * Checks if any iButton is present on the data line.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#checkPresence
+ */
+int8_t iButtonTag::checkPresence() {
+  // RESET the data line
+  // - Connected devices will assert presence with a pulse
+  // - Returns 1 if at least one device is present, 0 otherwise
+  return busReset() ? 1 : 0;
+}
+
+/*
+ * Verifies if a known iButtonCode is still present on the data line.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#verifyPresent
+ */
+int8_t iButtonTag::verifyPresent( const uint8_t* code ) {
+  iButtonCode known;
+  for ( uint8_t i = 0; i < 8; i++ ) known[i] = code[i];
+  return verifyPresent( &known, 1 );
+}
+
+/*
+ * Verifies which of multiple known iButtonCode's are present on the data line.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#verifyPresent
+ */
+uint8_t iButtonTag::verifyPresent( const iButtonCode* codes, uint8_t count,
+                                   bool* present /* = NULL */ ) {
+  // Codes left to verify and codes found present, one bit each
+  uint8_t pending[32], found[32];
+  for ( uint8_t i = 0; i < 32; i++ ) pending[i] = found[i] = 0;
+  for ( uint16_t i = 0; i < count; i++ ) pending[i >> 3] |= 1 << ( i & 7 );
+
+  // READ ROM settles all codes with a single device on the data line, the
+  // codes left take one search pass each
+  uint8_t left = count;
+  if ( left > 0 && !_crowded ) left = readPending( codes, count, pending, found );
+  while ( left > 0 ) left = searchPending( codes, count, pending, found );
+
+  uint8_t number = 0;
+  for ( uint16_t i = 0; i < count; i++ ) {
+    bool result = found[i >> 3] & ( 1 << ( i & 7 ) );
+    if ( present ) present[i] = result;
+    if ( result ) number++;
+  }
+  return number;
+}
+
+/*
+ * Selects one iButton on the data line for a function command, like memory
+ * access, at overdrive speed if it supports it.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#selectCode
+ */
+int8_t iButtonTag::selectCode( const uint8_t* code ) {
+  int8_t capable = _speed == IBUTTON_SPEED_STANDARD ? 0 : overdriveCapable( code );
+
+  // Devices still at overdrive speed after the last transaction: MATCH ROM at
+  // overdrive speed right away
+  if ( capable == 1 && _busOverdrive && busReset( true ) ) {
+    busWrite( 0x55 );
+    writeRom( code );
+    return 2;
+  }
+
+  if ( busReset() == 0 ) return 0;
+  if ( capable != 0 ) {
+    // OVERDRIVE MATCH ROM: command at standard speed, code at overdrive speed
+    busWrite( OVERDRIVE_MATCH_ROM );
+    busSpeed( true );
+    writeRom( code );
+    if ( capable == 1 ) return 2;
+
+    // Capability unknown: other devices may have switched too, only a search
+    // along the code tells if this one did. The search leaves it selected.
+    if ( searchCode( code, true ) ) {
+      speedStore( code, true );
+      return 2;
+    }
+    if ( busReset() == 0 ) return 0;
+    speedStore( code, false );
+  }
+
+  // MATCH ROM at standard speed
+  busWrite( 0x55 );
+  writeRom( code );
+  return 1;
+}
+
+/*
+ * Sets the speed of bus traffic.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#setSpeed
+ */
+int8_t iButtonTag::setSpeed( int8_t speed ) {
+  busSpeed( false );
+  _speed = IBUTTON_SPEED_STANDARD;
+  if ( speed == IBUTTON_SPEED_AUTO || speed == IBUTTON_SPEED_OVERDRIVE ) {
+    // Backend must support overdrive speed
+    if ( _bus -> overdrive( true ) ) _speed = speed;
+    _bus -> overdrive( false );
+  }
+  return _speed;
+}
+
+/*
+ * Returns the overdrive capability of an iButton, as detected earlier.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#overdriveCapable
+ */
+int8_t iButtonTag::overdriveCapable( const uint8_t* code ) {
+#if IBUTTON_SPEED_CACHE > 0
+  for ( uint8_t i = 0; i < _sCount; i++ ) {
+    if ( !equalCode( _sCode[i], code ) ) continue;
+    bool capable = _sCapable[i];
+    speedStore( code, capable ); // Moves it to the front
+    return capable ? 1 : 0;
+  }
+#else
+  (void) code;
+#endif
+  return -1;
 }
 
 /*
@@ -114,6 +474,22 @@ int8_t iButtonTag::testCode( const uint8_t* code ) {
   return 1;
 }
 
+/*
+ * Tests multiple iButtonCode's for validity.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#testCodes
+ */
+uint16_t iButtonTag::testCodes( const iButtonCode* codes, uint16_t count,
+                                int8_t* results /* = NULL */ ) {
+  uint16_t valid = 0;
+  for ( uint16_t i = 0; i < count; i++ ) {
+    int8_t result = testCode( codes[i] );
+    if ( results ) results[i] = result;
+    if ( result == 1 ) valid++;
+  }
+  return valid;
+}
+
 /*
  * Tests if two iButtonCode's are equal.
  *
@@ -125,17 +501,56 @@ bool iButtonTag::equalCode( const uint8_t* a, const uint8_t* b ) {
 }
 
 /*
- * Prints iButtonCode to Serial as hexadecimal byte values.
+ * Prints iButtonCode as hexadecimal byte values, to Serial unless another
+ * output is supplied.
  *
  * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#printCode
  */
-void iButtonTag::printCode( const uint8_t* code, bool reverse /* = false */ ) {
+void iButtonTag::printCode( const uint8_t* code, bool reverse /* = false */,
+                            Print& output /* = Serial */ ) {
+  char text[IBUTTON_CODE_TEXT];
+  formatCode( code, text, reverse );
+  output.write( (const uint8_t*) text, IBUTTON_CODE_TEXT - 1 ); // One write
+}
+
+/*
+ * Formats iButtonCode as hexadecimal byte values in a buffer.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#formatCode
+ */
+char* iButtonTag::formatCode( const uint8_t* code, char* buffer,
+                              bool reverse /* = false */ ) {
+  static const char digits[] = "0123456789ABCDEF";
+  char* p = buffer;
+  for( uint8_t i = 0; i < 8; i++ ) {
+    uint8_t b = code[reverse ? 7 - i : i];
+    *p++ = digits[b >> 4];
+    *p++ = digits[b & 0x0F];
+    *p++ = i < 7 ? ' ' : '\0';
+  }
+  return buffer;
+}
+
+/*
+ * Parses hexadecimal byte values to iButtonCode.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#parseCode
+ */
+int8_t iButtonTag::parseCode( const char* text, uint8_t* code,
+                              bool reverse /* = false */ ) {
+  uint8_t result[8];
   for( uint8_t i = 0; i < 8; i++ ) {
-    uint8_t j = reverse ? 7 - i : i;
-    if ( code[j] < 0x10 ) Serial.print( "0" );
-    Serial.print( code[j], HEX );
-    if ( i < 7 ) Serial.print( " " );
+    int8_t high = hexValue( *text++ );
+    if ( high < 0 ) return 0;
+    int8_t low = hexValue( *text++ );
+    if ( low < 0 ) return 0;
+    result[reverse ? 7 - i : i] = ( high << 4 ) | low;
+    // Byte values may be separated by a single space, colon or dash
+    if ( i < 7 && ( *text == ' ' || *text == ':' || *text == '-' ) ) text++;
   }
+  if ( *text != '\0' ) return 0;
+  for( uint8_t i = 0; i < 8; i++ ) code[i] = result[i];
+  return testCode( code );
 }
 
 /*
@@ -147,25 +562,56 @@ void iButtonTag::updateChecksum( uint8_t* code ) {
   code[7] = calculateChecksum( code );
 }
 
+/*
+ * Calculates CRC8 of data as used on the 1-Wire data line.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#crc8
+ */
+uint8_t iButtonTag::crc8( const uint8_t* data, uint8_t length ) {
+  uint8_t crc = 0;
+
+#if IBUTTON_CRC8 == IBUTTON_CRC8_NIBBLE
+  // Two lookups per byte in a table of 16 values
+  while ( length-- ) {
+    crc ^= *data++;
+    crc = ( crc >> 4 ) ^ pgm_read_byte( crc8table + ( crc & 0x0F ) );
+    crc = ( crc >> 4 ) ^ pgm_read_byte( crc8table + ( crc & 0x0F ) );
+  }
+#else
+  // One lookup per byte in a table of 256 values
+  while ( length-- ) crc = pgm_read_byte( crc8table + ( crc ^ *data++ ) );
+#endif
+
+  return crc;
+}
+
 /*
  * Detects type of (re)writable iButton tag.
  *
  * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#detectWritableType
  */
 int8_t iButtonTag::detectWritableType() {
-  int8_t t = isWritableTypeRW1990V1();
-  if ( t == 1 ) return IBUTTON_RW1990V1; // Detected
-  if ( t < 0 ) return t;                 // Failure
-
-  t = isWritableTypeRW1990V2();
-  if ( t == 1 ) return IBUTTON_RW1990V2; // Detected
-  if ( t < 0 ) return t;                 // Failure
+  STATS_BEGIN;
 
-  t = isWritableTypeRW2004();
-  if ( t == 1 ) return IBUTTON_RW2004;   // Detected
-  if ( t < 0 ) return t;                 // Failure
+  // Run the non-blocking detection until it finishes
+  int8_t status = beginDetect();
+  while ( status == IBUTTON_BUSY ) {
+    yield();
+    status = pollWrite();
+  }
+  if ( status == 1 ) status = detectedType();
+  STATS_RETURN( detectWritableType, status );
+}
 
-  return IBUTTON_UNKNOWN;
+/*
+ * Starts detecting the type of (re)writable iButton tag without blocking.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginDetect
+ */
+int8_t iButtonTag::beginDetect() {
+  // The probing steps of the write procedure, without writing
+  beginProcedure( NULL, IBUTTON_UNKNOWN, false, true );
+  return IBUTTON_BUSY;
 }
 
 /*
@@ -176,133 +622,994 @@ int8_t iButtonTag::detectWritableType() {
 int8_t iButtonTag::writeCode( const uint8_t* code,
                               int8_t type /* = IBUTTON_UNKNOWN */,
                               bool check /* = true */ ) {
+  STATS_BEGIN;
 
-  int8_t val;
+  // Run the non-blocking write procedure until it finishes
+  int8_t status = beginWrite( code, type, check );
+  while ( status == IBUTTON_BUSY ) {
+    yield();
+    status = pollWrite();
+  }
+  STATS_RETURN( writeCode, status );
+}
 
+/*
+ * Starts writing a new iButtonCode to a (re)writable tag without blocking.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginWrite
+ */
+int8_t iButtonTag::beginWrite( const uint8_t* code,
+                               int8_t type /* = IBUTTON_UNKNOWN */,
+                               bool check /* = true */ ) {
   // Check code if checking is on
   if ( check ) {
-    val = testCode( code );
+    int8_t val = testCode( code );
     if ( val < 1 ) return val; // Invalid code
   }
 
   // Check valid type argument - always
-  if ( type > IBUTTON_MAXWRITABLE ) return -11;    // Type out of range
+  if ( type < 0 || type > IBUTTON_MAXWRITABLE ) return -11; // Out of range
 
-  // Find out / check writable type
-  if ( type == IBUTTON_UNKNOWN ) {             // Run auto-detection routine
-    type = detectWritableType();
-    if ( type == IBUTTON_UNKNOWN ) return -12; // Unable to detect
-    if ( type < 0 ) return 0;                  // No iButton detected
-  } else if ( check ) {                        // Check type if checking is on
-    switch ( type ) {
-      case IBUTTON_RW1990V1:
-        val = isWritableTypeRW1990V1();
-        if ( val == 0 ) return -13;
-        if ( val == -1 ) return 0;
-        break;
-      case IBUTTON_RW1990V2:
-        val = isWritableTypeRW1990V2();
-        if ( val == 0 ) return -13;
-        if ( val == -1 ) return 0;
-        break;
-      case IBUTTON_RW2004:
-        val = isWritableTypeRW2004();
-        if ( val == 0 ) return -13;
-        if ( val == -1 ) return 0;
-        break;
-      case IBUTTON_TM01: break;                // Non-detectable type, allow
-      default: return -11;                     // Type out of range
-    }
+  beginProcedure( code, type, check, false );
+  return IBUTTON_BUSY;
+}
+
+/*
+ * Continues writing started with beginWrite, or detection started with
+ * beginDetect.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#pollWrite
+ */
+int8_t iButtonTag::pollWrite() {
+  int8_t status = _wPhase == PHASE_IDLE ? _wStatus : pollProcedure();
+  if ( status == STEP_BUSY ) return IBUTTON_BUSY;
+
+  // Detection finished: the type is returned by detectedType, as type
+  // IBUTTON_RW1990V2 has the same value as IBUTTON_BUSY
+  if ( _wDetect ) return status < 0 ? status : 1;
+  return status;
+}
+
+/*
+ * Returns the type found by detection started with beginDetect.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#detectedType
+ */
+int8_t iButtonTag::detectedType() const {
+  if ( !_wDetect || _wPhase != PHASE_IDLE || _wStatus < 0 ) return IBUTTON_UNKNOWN;
+  return _wStatus;
+}
+
+/*
+ * Returns progress of writing started with beginWrite.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#writeProgress
+ */
+uint8_t iButtonTag::writeProgress() {
+  // Progress is counted in delayed steps: for RW1990V1, RW1990V2 and TM01 one
+  // flag bit, 64 code bits and one flag bit; for RW2004 three steps per byte.
+  switch ( _wPhase ) {
+    case PHASE_IDLE:    return 100;
+    case PHASE_ENABLE:  return 0;
+    case PHASE_CODE:    return ( 1 + _wStep ) * 100 / 66;
+    case PHASE_DISABLE: return 65 * 100 / 66;
+    case PHASE_RW2004:  return _wStep * 100 / 24;
+    case PHASE_VERIFY:  return 99;
+    default:            return 0; // Detecting or checking type
   }
+}
 
-  // Checks passed or turned off, run actual writing procedure
-  switch ( type ) {
-    case IBUTTON_RW1990V1:
-      if ( writeCodeCommon( code, 0xD1, true ) == 0 ) return 0;
-      break;
-    case IBUTTON_RW1990V2:
-      if ( writeCodeCommon( code, 0x1D ) == 0 ) return 0;
-      break;
-    case IBUTTON_TM01:
-      if ( writeCodeCommon( code, 0xC1 ) == 0 ) return 0;
-      break;
-    case IBUTTON_RW2004:
-      int8_t status = writeCodeRW2004( code );
-      if ( status < 1 ) return status;
-      break;
+/*
+ * Sets the programming delay of a (re)writable tag type.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#setWriteDelay
+ */
+int8_t iButtonTag::setWriteDelay( int8_t type, uint32_t wait ) {
+  if ( type < 1 || type > IBUTTON_MAXWRITABLE ) return -11; // Out of range
+  _wDelay[type - 1] = wait;
+  return 1;
+}
+
+/*
+ * Returns the programming delay of a (re)writable tag type.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#writeDelay
+ */
+uint32_t iButtonTag::writeDelay( int8_t type ) {
+  if ( type < 1 || type > IBUTTON_MAXWRITABLE ) return 0;
+  return _wDelay[type - 1];
+}
+
+/*
+ * Forgets all cached (re)writable types.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#clearTypeCache
+ */
+void iButtonTag::clearTypeCache() {
+#if IBUTTON_TYPE_CACHE > 0
+  _cCount = 0;
+#endif
+}
+
+/*
+ * Finds the shortest reliable programming delay for the (re)writable tag on the
+ * data line by write trials.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#calibrateWriteDelay
+ */
+int8_t iButtonTag::calibrateWriteDelay( int8_t type /* = IBUTTON_UNKNOWN */,
+                                        uint8_t margin /* = 50 */ ) {
+  // Check valid type argument
+  if ( type < 0 || type > IBUTTON_MAXWRITABLE ) return -11; // Out of range
+
+  // Read the original code of the tag, to be restored at the end
+  iButtonCode original;
+  int8_t status = readCode( original );
+  if ( status < 1 ) return status;
+
+  // Detect type if not supplied, TM01 is non-detectable
+  if ( type == IBUTTON_UNKNOWN ) {
+    type = detectWritableType();
+    if ( type < 0 ) return 0;                                // No iButton
+    if ( type == IBUTTON_UNKNOWN ) return -12;               // Not detected
   }
 
-  // Writing procedure finished, check success if checking is on
-  if ( check ) {
-    iButtonCode result;
-    readCode( result );
-    if ( !equalCode( result, code ) ) return -21;
+  // Binary search between shortest delay tried and current (safe) delay. Each
+  // trial writes a code that differs from the tag contents in all bits of
+  // bytes 1 to 6, so every missed bit shows when reading it back. After a
+  // failed trial the tag contents are unknown: restore the original code with
+  // the safe delay.
+  uint32_t safe = _wDelay[type - 1];
+  uint32_t low = CALIBRATE_MIN;
+  uint32_t high = safe;
+  iButtonCode trial;
+  for ( uint8_t i = 0; i < 8; i++ ) trial[i] = original[i];
+  for ( uint8_t n = 0; n < CALIBRATE_STEPS && low < high; n++ ) {
+    uint32_t middle = low + ( ( high - low ) >> 1 );
+    for ( uint8_t i = 1; i < 7; i++ ) trial[i] ^= 0xFF;
+    updateChecksum( trial );
+    _wDelay[type - 1] = middle;
+    status = writeTrial( trial, type );
+    if ( status == 0 ) break;                                // No iButton
+    if ( status == 1 ) {
+      high = middle;
+    } else {
+      low = middle + 1;
+      _wDelay[type - 1] = safe;
+      for ( uint8_t i = 0; i < 8; i++ ) trial[i] = original[i];
+      status = writeTrial( original, type );
+      if ( status < 1 ) break;                               // Even safe fails
+    }
   }
 
+  // Restore original code with the safe delay
+  _wDelay[type - 1] = safe;
+  if ( status != 0 ) status = writeTrial( original, type );
+  if ( status < 1 ) return status;
+
+  // Use shortest delay that passed plus safety margin, never above safe delay
+  uint32_t result = high + high / 100 * margin;
+  if ( result < safe ) _wDelay[type - 1] = result;
   return 1;
+}
+
+#if IBUTTON_STATS
+/*
+ * Resets all statistics to zero.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#resetStats
+ */
+void iButtonTag::resetStats() {
+  memset( &_stats, 0, sizeof( _stats ) );
+}
 
+/*
+ * Prints all statistics to Serial.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#printStats
+ */
+void iButtonTag::printStats() {
+  Serial.print( "resets: " );
+  Serial.print( _stats.resets );
+  Serial.print( ", no presence: " );
+  Serial.println( _stats.noPresence );
+  Serial.print( "written: " );
+  Serial.print( _stats.bytesWritten );
+  Serial.print( " bytes, " );
+  Serial.print( _stats.bitsWritten );
+  Serial.println( " bits" );
+  Serial.print( "read: " );
+  Serial.print( _stats.bytesRead );
+  Serial.print( " bytes, " );
+  Serial.print( _stats.bitsRead );
+  Serial.println( " bits" );
+  Serial.print( "invalid codes: " );
+  Serial.print( _stats.checksumFailures );
+  Serial.print( " checksum, " );
+  Serial.print( _stats.zeroCodes );
+  Serial.println( " all zeros" );
+  Serial.print( "programming delays: " );
+  Serial.print( _stats.delayMicros );
+  Serial.println( " us" );
+  printLatency( "readCode", _stats.readCode );
+  printLatency( "nextCode", _stats.nextCode );
+  printLatency( "detectWritableType", _stats.detectWritableType );
+  printLatency( "writeCode", _stats.writeCode );
 }
+#endif
 
 
 // PRIVATE FUNCTIONS
 
 /*
- * Performs test to determine if iButton tag is of (re)writable type RW1990v1.
+ * Initializes the state of the object, common to constructors.
+ */
+void iButtonTag::init() {
+  _wPhase = PHASE_IDLE;
+  _wStatus = 0;
+  _wDelay[IBUTTON_RW1990V1 - 1] = DELAY_FLAG;
+  _wDelay[IBUTTON_RW1990V2 - 1] = DELAY_FLAG;
+  _wDelay[IBUTTON_RW2004 - 1] = DELAY_RW2004_PULSE;
+  _wDelay[IBUTTON_TM01 - 1] = DELAY_FLAG;
+  for ( uint8_t i = 0; i < 3; i++ ) _wSeen[i] = 0;
+  clearTypeCache();
+  _speed = IBUTTON_SPEED_STANDARD;
+  _busOverdrive = false;
+  _searchOverdrive = false;
+  _searchFirst = false;
+  _searchFamily = -1;
+  _crowded = false;
+#if IBUTTON_SPEED_CACHE > 0
+  _sCount = 0;
+#endif
+#if IBUTTON_STATS
+  resetStats();
+#endif
+}
+
+/*
+ * Starts a search of readCodes: resets the data line and the search domain,
+ * then switches all devices supporting it to overdrive speed if set.
  *
- * This type includes iButton tag models RW1990, RW1990.1, ТM08 and ТM08v2.
+ * Return values:
+ *   1 - At least one device present
+ *   0 - No device present
+ */
+int8_t iButtonTag::beginSearch() {
+  // RESET the data line
+  // - Connected devices will assert presence with a pulse
+  // - Returns 1 if at least one device is present, 0 otherwise
+  // - Exit with status 0 when no device asserted presence
+  if ( busReset() == 0 ) return 0;
+
+  // Reset search domain on data line
+  restartSearch();
+
+  // Search at overdrive speed: OVERDRIVE SKIP ROM switches all devices
+  // supporting it, others don't take part in the search
+  _searchOverdrive = _speed == IBUTTON_SPEED_OVERDRIVE;
+  _searchFirst = true;
+  if ( _searchOverdrive ) {
+    busWrite( OVERDRIVE_SKIP_ROM );
+    busSpeed( true );
+  }
+
+  return 1;
+}
+
+/*
+ * Resets the search domain of the bus backend, to the family searched if any.
+ */
+void iButtonTag::restartSearch() {
+  if ( _searchFamily >= 0 ) _bus -> targetSearch( (uint8_t) _searchFamily );
+  else _bus -> resetSearch();
+}
+
+/*
+ * Resets the data line, returns 1 if at least one device asserted presence.
+ *
+ * A reset at standard speed returns all devices to standard speed, a reset at
+ * overdrive speed only gets presence of devices at overdrive speed.
+ */
+uint8_t iButtonTag::busReset( bool overdrive /* = false */ ) {
+  busSpeed( overdrive );
+  uint8_t presence = _bus -> reset();
+
+#if IBUTTON_TYPE_CACHE > 0
+  // No presence: tags departed, cached types may not apply to the next tags.
+  // A tag present is looked up by the code read, however long ago it was cached.
+  if ( presence == 0 ) clearTypeCache();
+#endif
+#if IBUTTON_STATS
+  _stats.resets++;
+  if ( presence == 0 ) _stats.noPresence++;
+#endif
+  return presence;
+}
+
+/*
+ * Switches speed of resets and time slots of the backend.
+ */
+void iButtonTag::busSpeed( bool overdrive ) {
+  if ( overdrive == _busOverdrive ) return;
+  _bus -> overdrive( overdrive );
+  _busOverdrive = overdrive;
+}
+
+/*
+ * Writes a byte to the data line.
+ */
+void iButtonTag::busWrite( uint8_t b ) {
+  _bus -> write( b );
+#if IBUTTON_STATS
+  _stats.bytesWritten++;
+#endif
+}
+
+/*
+ * Reads a byte from the data line.
+ */
+uint8_t iButtonTag::busRead() {
+#if IBUTTON_STATS
+  _stats.bytesRead++;
+#endif
+  return _bus -> read();
+}
+
+/*
+ * Writes a single bit to the data line, b can only be 0 or 1.
+ */
+void iButtonTag::busWriteBit( uint8_t b ) {
+  _bus -> writeBit( b );
+#if IBUTTON_STATS
+  _stats.bitsWritten++;
+#endif
+}
+
+/*
+ * Reads a single bit from the data line.
+ */
+uint8_t iButtonTag::busReadBit() {
+#if IBUTTON_STATS
+  _stats.bitsRead++;
+#endif
+  return _bus -> readBit();
+}
+
+/*
+ * Searches the data line along one known iButtonCode only.
+ *
+ * A SEARCH ROM that always takes the branch of the known code: every bit the
+ * devices still in the search answer with the bit and its complement, then the
+ * code bit is written to deselect all devices that differ. No device left on
+ * the known branch means the code is not present, so the search stops right
+ * there. MATCH ROM can't be used for this: a selected iButton like the DS1990A
+ * doesn't respond to any function command, so presence would remain unknown.
+ *
+ * At overdrive speed only devices at overdrive speed take part.
  *
  * Return values:
- *    1 - iButton _is_ of (re)writable type RW1990v1
- *    0 - iButton _is not_ of (re)writable type RW1990v1
- *   -1 - No iButton detected during test
+ *   true  - iButton with code is present on the data line, and selected
+ *   false - iButton with code is not present
  */
-int8_t iButtonTag::isWritableTypeRW1990V1() {
-  // Write flag value 1 (writing disabled)
-  if ( _wire -> reset() == 0 ) return -1;
-  _wire -> write( 0xD1 );
-  writeBitDelayed( 1 );
+bool iButtonTag::searchCode( const uint8_t* code, bool overdrive /* = false */ ) {
+  // RESET the data line
+  // - Exit when no device asserted presence
+  if ( busReset( overdrive ) == 0 ) return false;
 
-  // Read flag command
-  if ( _wire -> reset() == 0 ) return -1;
-  _wire -> write( 0xB5 );
+  // Issue SEARCH ROM command to the data line
+  busWrite( 0xF0 );
 
-  // Read response and determine result
-  if ( _wire -> read() == 0xFE ) return 1;
-  return 0;
+  for ( uint8_t i = 0; i < 64; i++ ) {
+    uint8_t bit = ( code[i >> 3] >> ( i & 7 ) ) & 1;
+    uint8_t id = busReadBit();  // AND of bit of remaining devices
+    uint8_t cmp = busReadBit(); // AND of complement of bit
+
+    // Exit when no remaining device has the bit of the known code
+    if ( bit ? cmp : id ) return false;
+
+    // Deselect devices that don't have the bit of the known code
+    busWriteBit( bit );
+  }
+  return true;
 }
 
 /*
- * Performs test to determine if iButton tag is of (re)writable type RW1990v2.
+ * Verifies known codes with READ ROM. A single iButton answers with its code.
+ * With more iButtons on the data line every bit read is the AND of their bits,
+ * so each iButton present has at least the bits read. A code without a bit
+ * read is not present. A code read exactly is present when no other code is
+ * left; other codes are left pending, and then the code read exactly too. A
+ * code left pending means more than one device: the next verifyPresent skips
+ * READ ROM, until a search pass finds a single device again.
  *
- * This type includes iButton tag models RW1990v2 and RW1990.2.
+ * Return values:
+ *   Number of codes left pending
+ */
+uint8_t iButtonTag::readPending( const iButtonCode* codes, uint8_t count,
+                                 uint8_t* pending, uint8_t* found ) {
+  // RESET the data line
+  // - No device asserted presence: no code present
+  if ( busReset() == 0 ) {
+    for ( uint8_t i = 0; i < 32; i++ ) pending[i] = 0;
+    return 0;
+  }
+
+  // Issue READ ROM command to the data line, and read 8 bytes
+  iButtonCode rom;
+  busWrite( 0x33 );
+  for ( uint8_t i = 0; i < 8; i++ ) rom[i] = busRead();
+
+  // Drop codes without a bit read, keep the others pending
+  uint8_t left = 0;
+  int16_t exact = -1;
+  for ( uint16_t i = 0; i < count; i++ ) {
+    bool subset = true;
+    for ( uint8_t j = 0; j < 8; j++ ) {
+      if ( rom[j] & ~codes[i][j] ) subset = false;
+    }
+    if ( !subset ) pending[i >> 3] &= ~( 1 << ( i & 7 ) );
+    else if ( equalCode( rom, codes[i] ) ) exact = i;
+    else left++;
+  }
+
+  // A code read exactly is present only without other codes pending: those
+  // could be devices on the data line with an AND equal to it
+  if ( exact >= 0 ) {
+    if ( left == 0 ) {
+      found[exact >> 3] |= 1 << ( exact & 7 );
+      pending[exact >> 3] &= ~( 1 << ( exact & 7 ) );
+    } else {
+      left++;
+    }
+  }
+  _crowded = left > 0;
+  return left;
+}
+
+/*
+ * Verifies pending known codes with one SEARCH ROM pass. Every bit the devices
+ * still in the search answer with the bit and its complement: a pending code
+ * with a bit no device has is not present. Where the pending codes on the path
+ * diverge, the pass follows those with a 0 bit and leaves the others for a next
+ * pass. A code still on the path after 64 bits is present. Each pass settles at
+ * least one code, usually many codes not present along the way.
  *
  * Return values:
- *    1 - iButton _is_ of (re)writable type RW1990v2
- *    0 - iButton _is not_ of (re)writable type RW1990v2
- *   -1 - No iButton detected during test
+ *   Number of codes left pending
  */
-int8_t iButtonTag::isWritableTypeRW1990V2() {
-  // Write flag value 1 (writing enabled)
-  if ( _wire -> reset() == 0 ) return -1;
-  _wire -> write( 0x1D );
-  writeBitDelayed( 1 );
+uint8_t iButtonTag::searchPending( const iButtonCode* codes, uint8_t count,
+                                   uint8_t* pending, uint8_t* found ) {
+  // RESET the data line
+  // - No device asserted presence: no code present
+  if ( busReset() == 0 ) {
+    for ( uint8_t i = 0; i < 32; i++ ) pending[i] = 0;
+    _crowded = false;
+    return 0;
+  }
 
-  // Read flag command
-  if ( _wire -> reset() == 0 ) return -1;
-  _wire -> write( 0x1E );
+  // Issue SEARCH ROM command to the data line
+  busWrite( 0xF0 );
 
-  // Read response and determine result
-  if ( _wire -> read() == 0xFE ) {
-    // Restore write flag value 0 (writing disabled)
-    if ( _wire -> reset() == 0 ) return -1;
-    _wire -> write( 0x1D );
-    writeBitDelayed( 0 );
-    _wire -> depower();
-    return 1;
+  // Codes on the path of this pass
+  uint8_t path[32];
+  for ( uint8_t i = 0; i < 32; i++ ) path[i] = pending[i];
+  bool crowded = false;
+
+  uint8_t b;
+  for ( b = 0; b < 64; b++ ) {
+    uint8_t id = busReadBit();  // AND of bit of remaining devices
+    uint8_t cmp = busReadBit(); // AND of complement of bit
+    if ( id == 0 && cmp == 0 ) crowded = true;
+
+    // Drop codes with a bit no remaining device has
+    uint8_t zeros = 0, ones = 0;
+    for ( uint16_t i = 0; i < count; i++ ) {
+      uint8_t mask = 1 << ( i & 7 );
+      if ( ( path[i >> 3] & mask ) == 0 ) continue;
+      uint8_t bit = ( codes[i][b >> 3] >> ( b & 7 ) ) & 1;
+      if ( bit ? cmp : id ) {
+        path[i >> 3] &= ~mask;
+        pending[i >> 3] &= ~mask;
+      } else if ( bit ) {
+        ones++;
+      } else {
+        zeros++;
+      }
+    }
+    if ( zeros == 0 && ones == 0 ) break;  // No code left on the path
+
+    // Follow the codes with a 0 bit, if any; others are left for a next pass
+    uint8_t bit = zeros > 0 ? 0 : 1;
+    if ( zeros > 0 && ones > 0 ) {
+      for ( uint16_t i = 0; i < count; i++ ) {
+        if ( ( ( codes[i][b >> 3] >> ( b & 7 ) ) & 1 ) != bit ) {
+          path[i >> 3] &= ~( 1 << ( i & 7 ) );
+        }
+      }
+    }
+
+    // Deselect devices that don't have the bit
+    busWriteBit( bit );
+  }
+
+  uint8_t left = 0;
+  for ( uint16_t i = 0; i < count; i++ ) {
+    uint8_t mask = 1 << ( i & 7 );
+    if ( b == 64 && ( path[i >> 3] & mask ) ) {
+      found[i >> 3] |= mask;
+      pending[i >> 3] &= ~mask;
+    }
+    if ( pending[i >> 3] & mask ) left++;
+  }
+  if ( b == 64 ) _crowded = crowded;  // Complete path: all devices seen
+  return left;
+}
+
+/*
+ * Writes the 8 bytes of an iButtonCode to the data line, after MATCH ROM.
+ */
+void iButtonTag::writeRom( const uint8_t* code ) {
+  for ( uint8_t i = 0; i < 8; i++ ) busWrite( code[i] );
+}
+
+/*
+ * Switches a single iButton just read to overdrive speed, if it supports it:
+ * OVERDRIVE SKIP ROM, then it must be read again at overdrive speed. Otherwise
+ * the data line stays at standard speed. Known capability is used and kept.
+ *
+ * Return values:
+ *   true  - iButton and data line at overdrive speed
+ *   false - Data line at standard speed
+ */
+bool iButtonTag::enterOverdrive( const uint8_t* code, bool old ) {
+  if ( overdriveCapable( code ) == 0 ) return false;
+  if ( busReset() == 0 ) return false;
+  busWrite( OVERDRIVE_SKIP_ROM );
+
+  bool capable = false;
+  if ( busReset( true ) ) {
+    iButtonCode rom;
+    busWrite( old ? 0x0F : 0x33 );
+    for ( uint8_t i = 0; i < 8; i++ ) rom[i] = busRead();
+    capable = equalCode( rom, code );
+  }
+  if ( !capable ) busSpeed( false );
+  speedStore( code, capable );
+  return capable;
+}
+
+/*
+ * Stores overdrive capability of a code at the front of the list, dropping the
+ * least recently used code when full.
+ */
+void iButtonTag::speedStore( const uint8_t* code, bool capable ) {
+#if IBUTTON_SPEED_CACHE > 0
+  uint8_t last = _sCount < IBUTTON_SPEED_CACHE ? _sCount : _sCount - 1;
+  for ( uint8_t i = 0; i < _sCount; i++ ) {
+    if ( equalCode( _sCode[i], code ) ) {
+      last = i;
+      break;
+    }
+  }
+  if ( last == _sCount ) _sCount++;
+  for ( uint8_t i = last; i > 0; i-- ) {
+    for ( uint8_t j = 0; j < 8; j++ ) _sCode[i][j] = _sCode[i - 1][j];
+    _sCapable[i] = _sCapable[i - 1];
+  }
+  for ( uint8_t j = 0; j < 8; j++ ) _sCode[0][j] = code[j];
+  _sCapable[0] = capable;
+#else
+  (void) code;
+  (void) capable;
+#endif
+}
+
+/*
+ * Tests iButtonCode read from the data line, counting invalid codes.
+ */
+int8_t iButtonTag::testRead( const uint8_t* code ) {
+  int8_t status = testCode( code );
+#if IBUTTON_STATS
+  if ( status == -1 ) _stats.checksumFailures++;
+  if ( status == -2 ) _stats.zeroCodes++;
+#endif
+  return status;
+}
+
+/*
+ * Sets up the write procedure, or the detection part of it only.
+ *
+ * The procedure starts with probing steps: all of them to detect the type, or
+ * just the one for the supplied type if checking is on. To detect the type,
+ * the code is read first to look it up in the cache of detected types. The
+ * actual steps are taken by calling pollProcedure.
+ */
+void iButtonTag::beginProcedure( const uint8_t* code, int8_t type, bool check,
+                                 bool detect ) {
+  if ( code ) for ( uint8_t i = 0; i < 8; i++ ) _wCode[i] = code[i];
+  _wType = type;
+  _wCheck = check;
+  _wDetect = detect;
+  _wStep = 0;
+  _wWait = 0;
+  _wStatus = IBUTTON_BUSY;
+
+  // Probe types in order of detection counts, most detected first. Without
+  // counts the order is RW1990V1, RW1990V2, RW2004.
+  _wProbe = 0;
+  for ( uint8_t i = 0; i < 3; i++ ) {
+    uint8_t j = i;
+    for ( ; j > 0 && _wSeen[_wOrder[j - 1] - 1] < _wSeen[i]; j-- )
+      _wOrder[j] = _wOrder[j - 1];
+    _wOrder[j] = i + 1;
+  }
+#if IBUTTON_TYPE_CACHE > 0
+  _wRomValid = false;
+#endif
+
+  switch ( type ) {
+#if IBUTTON_TYPE_CACHE > 0
+    case IBUTTON_UNKNOWN:  _wPhase = PHASE_LOOKUP;         break;
+#else
+    case IBUTTON_UNKNOWN:  _wPhase = _wOrder[0];           break;
+#endif
+    case IBUTTON_RW1990V1: _wPhase = PHASE_PROBE_RW1990V1; break;
+    case IBUTTON_RW1990V2: _wPhase = PHASE_PROBE_RW1990V2; break;
+    case IBUTTON_RW2004:   _wPhase = PHASE_PROBE_RW2004;   break;
+    default:               break; // TM01 is non-detectable, see below
+  }
+
+  // Skip probing for known type when checking is off, TM01 is non-detectable
+  if ( type != IBUTTON_UNKNOWN && ( !check || type == IBUTTON_TM01 ) )
+    startWriting( type );
+}
+
+/*
+ * Takes the next step of the procedure, unless still waiting.
+ *
+ * Return values:
+ *   STEP_BUSY - Procedure still running, call again
+ *   other     - Procedure finished, final status
+ */
+int8_t iButtonTag::pollProcedure() {
+  // Wait for delay after previous step to pass
+  if ( (uint32_t) ( micros() - _wStart ) < _wWait ) return STEP_BUSY;
+  _wWait = 0;
+
+  int8_t status = stepProcedure();
+  if ( status != STEP_BUSY ) finishProcedure( status );
+  return status;
+}
+
+/*
+ * Takes one step of the procedure. Each step ends when the data line needs to
+ * be left alone for some time, or at a change of phase.
+ *
+ * Return values:
+ *   STEP_BUSY - Procedure still running
+ *   other     - Procedure finished, final status
+ */
+int8_t iButtonTag::stepProcedure() {
+  switch ( _wPhase ) {
+
+#if IBUTTON_TYPE_CACHE > 0
+    case PHASE_LOOKUP: {
+      // Read code of the tag and look up its type in the cache. Only a valid
+      // code can be cached: not with a collision of multiple tags.
+      int8_t status = readCode( _wRom );
+      if ( status == 0 ) return noDevice();
+      _wRomValid = status == 1;
+      int8_t i = _wRomValid ? cacheFind( _wRom ) : -1;
+      if ( i < 0 ) {
+        _wPhase = _wOrder[0];                  // Not cached, start probing
+        return STEP_BUSY;
+      }
+      if ( _cType[i] == IBUTTON_UNKNOWN ) return _wDetect ? IBUTTON_UNKNOWN : -12;
+      return foundType( _cType[i] );
+    }
+#endif
+
+    case PHASE_PROBE_RW1990V1:
+      // Test for (re)writable type RW1990v1: models RW1990, RW1990.1, ТM08 and
+      // ТM08v2
+      if ( _wStep == 0 ) {
+        // Write flag value 1 (writing disabled)
+        if ( busReset() == 0 ) return noDevice();
+        busWrite( 0xD1 );
+        _wStep++;
+        return writeBitDelayed( 1, _wDelay[IBUTTON_RW1990V1 - 1] );
+      }
+      // Read flag command
+      if ( busReset() == 0 ) return noDevice();
+      busWrite( 0xB5 );
+      // Read response and determine result
+      if ( busRead() == 0xFE ) return foundType( IBUTTON_RW1990V1 );
+      return nextProbe();
+
+    case PHASE_PROBE_RW1990V2:
+      // Test for (re)writable type RW1990v2: models RW1990v2 and RW1990.2
+      if ( _wStep == 0 ) {
+        // Write flag value 1 (writing enabled)
+        if ( busReset() == 0 ) return noDevice();
+        busWrite( 0x1D );
+        _wStep++;
+        return writeBitDelayed( 1, _wDelay[IBUTTON_RW1990V2 - 1] );
+      }
+      if ( _wStep == 1 ) {
+        // Read flag command
+        if ( busReset() == 0 ) return noDevice();
+        busWrite( 0x1E );
+        // Read response and determine result
+        if ( busRead() != 0xFE ) return nextProbe();
+        _wStep++;
+        return STEP_BUSY;
+      }
+      if ( _wStep == 2 ) {
+        // Restore write flag value 0 (writing disabled)
+        if ( busReset() == 0 ) return noDevice();
+        busWrite( 0x1D );
+        _wStep++;
+        return writeBitDelayed( 0, _wDelay[IBUTTON_RW1990V2 - 1] );
+      }
+      _bus -> depower();
+      return foundType( IBUTTON_RW1990V2 );
+
+    case PHASE_PROBE_RW2004: {
+      // Test for (re)writable type RW2004: models RW2004 and TM2004
+      int8_t t = isWritableTypeRW2004();
+      if ( t < 0 ) return noDevice();
+      if ( t == 1 ) return foundType( IBUTTON_RW2004 );
+      return nextProbe();
+    }
+
+    case PHASE_ENABLE:
+      // Write types RW1990V1, RW1990V2 and TM01: each has its own write-enable
+      // command and for RW1990V1 all written bits need to be inverted.
+      // Set flag value to [writing enabled]
+      if ( busReset() == 0 ) return 0;
+      busWrite( enableCommand() );
+      _wPhase = PHASE_CODE;
+      _wStep = 0;
+      return writeBitDelayed( _wType == IBUTTON_RW1990V1 ? 0 : 1,
+                              _wDelay[_wType - 1] );
+
+    case PHASE_CODE: {
+      // Write code, one bit per step LSB-first
+      if ( _wStep == 0 ) {
+        if ( busReset() == 0 ) return 0;
+        busWrite( 0xD5 );
+      }
+      uint8_t b = ( _wCode[_wStep >> 3] >> ( _wStep & 0x07 ) ) & 0x01;
+      if ( _wType == IBUTTON_RW1990V1 ) b ^= 0x01;
+      if ( ++_wStep == 64 ) _wPhase = PHASE_DISABLE;
+      return writeBitDelayed( b, _wDelay[_wType - 1] );
+    }
+
+    case PHASE_DISABLE:
+      // Set flag value [writing disabled]
+      if ( busReset() == 0 ) return 0;
+      busWrite( enableCommand() );
+      _wPhase = PHASE_VERIFY;
+      return writeBitDelayed( _wType == IBUTTON_RW1990V1 ? 1 : 0,
+                              _wDelay[_wType - 1] );
+
+    case PHASE_RW2004: {
+      // Write type RW2004. Send command 0x3C to start writing at address 0x00
+      // 0x00. Then the code is written byte-by-byte: write byte > read value >
+      // send program pulse > read written byte [ > write next byte >>> ]. The
+      // first byte read after each write is probably CRC8, probably of
+      // command/address/data on first pass and of address/data on additional
+      // passes. Much like the procedure for model DS1982 command 0x55 in
+      // 'iButton Book of Standards' (fig6-11, p80). This tag type needs more
+      // testing to be able to check more responses.
+      //
+      // If you know where to get a RW2004/TM2004 model, please contact the
+      // developer!
+      uint8_t i = _wStep / 3;
+      switch ( _wStep++ % 3 ) {
+        case 0:
+          if ( i == 0 ) { // Send command
+            uint8_t seq[3] = { 0x3C, 0x00, 0x00 };
+            if ( busReset() == 0 ) return 0;
+            for ( uint8_t j = 0; j < 3; j++ ) busWrite( seq[j] );
+          }
+          busWrite( _wCode[i] );  // Write byte
+          busRead();              // Read value - CRC8 (needs testing)
+          return waitStep( DELAY_RW2004_BYTE );
+        case 1:
+          busWriteBit( 1 );      // Program pulse
+          return waitStep( _wDelay[IBUTTON_RW2004 - 1] );
+        default:
+          if ( busRead() != _wCode[i] ) return -22; // Confirm byte
+          if ( i == 7 ) _wPhase = PHASE_VERIFY;
+          return STEP_BUSY;
+      }
+    }
+
+    case PHASE_VERIFY:
+      // Writing procedure finished, check success if checking is on
+      if ( _wCheck ) {
+        iButtonCode result;
+        readCode( result );
+        if ( !equalCode( result, _wCode ) ) return -21;
+      }
+      return 1;
+
+  }
+  return 0; // Not reached
+}
+
+/*
+ * Ends the procedure with its final status.
+ *
+ * A successful write changes the code of the tag, so its cached type moves to
+ * the new code. After a failed write the code of the tag is unknown.
+ */
+void iButtonTag::finishProcedure( int8_t status ) {
+#if IBUTTON_TYPE_CACHE > 0
+  if ( _wRomValid && !_wDetect && ( status == 1 || status <= -21 ) ) {
+    cacheRemove( _wRom );
+    if ( status == 1 ) cacheStore( _wCode, _wType );
   }
-  return 0;
+#endif
+  _wPhase = PHASE_IDLE;
+  _wStatus = status;
 }
 
+/*
+ * Ends a probing step with a detected type: finishes detection, or continues
+ * with writing.
+ */
+int8_t iButtonTag::foundType( int8_t type ) {
+  if ( _wType == IBUTTON_UNKNOWN && _wPhase != PHASE_LOOKUP ) {
+    // Detected by probing: count for order of probes, halving all counts
+    // before one overflows, and cache by code
+    if ( _wSeen[type - 1] == 0xFF )
+      for ( uint8_t i = 0; i < 3; i++ ) _wSeen[i] >>= 1;
+    _wSeen[type - 1]++;
+#if IBUTTON_TYPE_CACHE > 0
+    if ( _wRomValid ) cacheStore( _wRom, type );
+#endif
+  }
+  if ( _wDetect ) return type;
+  startWriting( type );
+  return STEP_BUSY;
+}
+
+/*
+ * Ends a probing step without a detected type: continues with the next probe,
+ * or finishes with the appropriate status.
+ */
+int8_t iButtonTag::nextProbe() {
+  if ( _wType != IBUTTON_UNKNOWN ) return -13; // Supplied type incorrect
+  if ( ++_wProbe == 3 ) {
+#if IBUTTON_TYPE_CACHE > 0
+    if ( _wRomValid ) cacheStore( _wRom, IBUTTON_UNKNOWN );
+#endif
+    return _wDetect ? IBUTTON_UNKNOWN : -12;
+  }
+  _wPhase = _wOrder[_wProbe];
+  _wStep = 0;
+  return STEP_BUSY;
+}
+
+/*
+ * Ends a probing step when no iButton is detected.
+ */
+int8_t iButtonTag::noDevice() {
+  return _wDetect ? -1 : 0;
+}
+
+/*
+ * Switches the procedure to the writing phases for the supplied type.
+ */
+void iButtonTag::startWriting( int8_t type ) {
+  _wType = type;
+  _wPhase = type == IBUTTON_RW2004 ? PHASE_RW2004 : PHASE_ENABLE;
+  _wStep = 0;
+}
+
+/*
+ * Returns write-enable command for current type RW1990V1, RW1990V2 or TM01.
+ */
+uint8_t iButtonTag::enableCommand() {
+  if ( _wType == IBUTTON_RW1990V1 ) return 0xD1;
+  if ( _wType == IBUTTON_RW1990V2 ) return 0x1D;
+  return 0xC1;
+}
+
+/*
+ * Writes a bit to the data line and waits before the next step.
+ *
+ * The data line stays _high_ while waiting. Next steps should perform other
+ * actions on the data line or _depower_.
+ */
+int8_t iButtonTag::writeBitDelayed( uint8_t b, uint32_t wait ) {
+  busWriteBit( b ); // b can only be 0 or 1 !!
+  return waitStep( wait );
+}
+
+/*
+ * Ends a step, the next step is taken after a delay of _wait_ microseconds.
+ */
+int8_t iButtonTag::waitStep( uint32_t wait ) {
+  _wStart = micros();
+  _wWait = wait;
+#if IBUTTON_STATS
+  _stats.delayMicros += wait;
+#endif
+  return STEP_BUSY;
+}
+
+/*
+ * Writes a code to the tag with the current timing profile, without probing
+ * the type, and reads it back.
+ *
+ * Return values:
+ *    1 - Code written and read back successfully
+ *    0 - No iButton detected
+ *   <0 - Code not written correctly
+ */
+int8_t iButtonTag::writeTrial( const uint8_t* code, int8_t type ) {
+  int8_t status = writeCode( code, type, false );
+  if ( status < 1 ) return status;
+  iButtonCode result;
+  status = readCode( result );
+  if ( status == 0 ) return 0;
+  return equalCode( result, code ) ? 1 : -21;
+}
+
+#if IBUTTON_TYPE_CACHE > 0
+/*
+ * Looks up a code in the type cache, moving it to the front when found.
+ *
+ * Return values:
+ *   >=0 - Index of code in cache, always 0
+ *    -1 - Code not in cache
+ */
+int8_t iButtonTag::cacheFind( const uint8_t* code ) {
+  for ( uint8_t i = 0; i < _cCount; i++ ) {
+    if ( !equalCode( _cCode[i], code ) ) continue;
+    int8_t type = _cType[i];
+    cacheRemove( code );
+    cacheStore( code, type );
+    return 0;
+  }
+  return -1;
+}
+
+/*
+ * Stores a code with its type at the front of the type cache, dropping the
+ * least recently used code when full.
+ */
+void iButtonTag::cacheStore( const uint8_t* code, int8_t type ) {
+  cacheRemove( code );
+  if ( _cCount < IBUTTON_TYPE_CACHE ) _cCount++;
+  for ( uint8_t i = _cCount - 1; i > 0; i-- ) {
+    for ( uint8_t j = 0; j < 8; j++ ) _cCode[i][j] = _cCode[i - 1][j];
+    _cType[i] = _cType[i - 1];
+  }
+  for ( uint8_t j = 0; j < 8; j++ ) _cCode[0][j] = code[j];
+  _cType[0] = type;
+}
+
+/*
+ * Removes a code from the type cache.
+ */
+void iButtonTag::cacheRemove( const uint8_t* code ) {
+  for ( uint8_t i = 0; i < _cCount; i++ ) {
+    if ( !equalCode( _cCode[i], code ) ) continue;
+    _cCount--;
+    for ( ; i < _cCount; i++ ) {
+      for ( uint8_t j = 0; j < 8; j++ ) _cCode[i][j] = _cCode[i + 1][j];
+      _cType[i] = _cType[i + 1];
+    }
+    return;
+  }
+}
+#endif
+
 /*
  * Performs test to determine if iButton tag is of (re)writable type RW2004.
  *
@@ -324,129 +1631,82 @@ int8_t iButtonTag::isWritableTypeRW2004() {
 
   // Send command
   uint8_t seq[3] = { 0xAA, 0x00, 0x00 };
-  if ( _wire -> reset() == 0 ) return -1;
-  for ( uint8_t i = 0; i < 3; i++ ) _wire -> write( seq[i] );
+  if ( busReset() == 0 ) return -1;
+  for ( uint8_t i = 0; i < 3; i++ ) busWrite( seq[i] );
 
   // Read response and determine result
   int8_t result = 0;
-  if ( _wire -> read() == OneWire::crc8( seq, 3 ) ) { // CRC8 of command/address
+  if ( busRead() == crc8( seq, 3 ) ) { // CRC8 of command/address
     // Read another byte and reset
-    _wire -> read(); // Read byte from status register
-    if ( _wire -> reset() == 0 ) return -1;
+    busRead(); // Read byte from status register
+    if ( busReset() == 0 ) return -1;
     result = 1;
   }  
   return result;
 }
 
-/*
- * Writes new iButtonCode to (re)writable types RW1990V1, RW1990V2 and TM01
- * without checks.
- *
- * These types include iButton tag models RW1990, RW1990.1, ТM08, ТM08v2 (type
- * IBUTTON_RW1990V1), RW1990v2, RW1990.2 (type IBUTTON_RW1990V2), TM01 and TM01C
- * (type IBUTTON_TM01).
- *
- * When using this function, apart from the new iButtonCode, the byte-code for
- * the type-specific write-enable command needs to be supplied. For RW1990V1 all
- * written bits need to be inverted.
- *
- * Return values:
- *    1 - Writing procedure finished successfully
- *    0 - No iButton detected at some time during procedure
- */
-int8_t iButtonTag::writeCodeCommon( const uint8_t* code, uint8_t enablecommand,
-                                    bool invert /* = false */ ) {
-  // Set flag value to [writing enabled]
-  if ( _wire -> reset() == 0 ) return 0;
-  _wire -> write( enablecommand );
-  writeBitDelayed( invert ? 0 : 1 );
-  // Write code
-  if ( _wire -> reset() == 0 ) return 0;
-  _wire -> write( 0xD5 );
-  for ( uint8_t i = 0; i < 8; i++ )
-    writeByteDelayed( invert ? ~code[i] : code[i] );
-  // Set flag value [writing disabled]
-  if ( _wire -> reset() == 0 ) return 0;
-  _wire -> write( enablecommand );
-  writeBitDelayed( invert ? 1 : 0 );
-  return 1;
-}
 
 /*
- * Writes new iButtonCode to (re)writable type RW2004 without checks.
- *
- * This type includes iButton tag models RW2004 and TM2004.
+ * Calculates checksum of iButtonCode.
  *
- * Return values:
- *    1 - Writing procedure finished successfully
- *    0 - No iButton detected at some time during procedure
- *  -22 - Writing code failed, unexpected response while writing
- */
-int8_t iButtonTag::writeCodeRW2004( const uint8_t* code ) {
-  // Send command 0x3C to start writing at address 0x00 0x00. Then the code is
-  // written byte-by-byte: write byte > read value > send program pulse > read
-  // written byte [ > write next byte >>> ]. The first byte read after each
-  // write is probably CRC8, probably of command/address/data on first pass and
-  // of address/data on additional passes. Much like the procedure for model
-  // DS1982 command 0x55 in 'iButton Book of Standards' (fig6-11, p80). This tag
-  // type needs more testing to be able to check more responses.
-  //
-  // If you know where to get a RW2004/TM2004 model, please contact the
-  // developer!
-
-  // Send command
-  uint8_t seq[3] = { 0x3C, 0x00, 0x00 };
-  if ( _wire -> reset() == 0 ) return 0;
-  for ( uint8_t i = 0; i < 3; i++ ) _wire -> write( seq[i] );
-
-  // Write code byte-by-byte
-  for ( uint8_t i = 0; i < 8; i++ ) {
-    _wire -> write( code[i] );   // Write byte
-    _wire -> read();             // Read value - CRC8 (needs testing)
-    delayMicroseconds( 600 );
-    _wire -> write_bit( 1 );     // Program pulse
-    delay( 50 );
-    if ( _wire -> read() != code[i] ) return -22; // Confirm byte written
-  }
-
-  return 1;
+ * Returns correct checksum value
+ */
+uint8_t iButtonTag::calculateChecksum( const uint8_t* code ) {
+  return crc8( code, 7 );
 }
 
 /*
- * Writes a byte to the data line with a delay after each bit.
- *
- * By default the byte is written _as is_, if indicated all bits are inverted.
- * 
- * The data line stays _high_ after this function. Calling procedures should
- * perform other actions on the data line or _depower_.
+ * Returns value of a hexadecimal digit, -1 for any other character.
  */
-void iButtonTag::writeByteDelayed( uint8_t b, bool invert /* = false */ ) {
-  // Invert byte if specified
-  if ( invert ) b = ~b;
-  // Write all bits with a delay LSB-first
-  for ( uint8_t mask = 0x01; mask; mask <<= 1 ) {
-    writeBitDelayed( ( mask & b ) ? 1 : 0 );
-  }  
+int8_t iButtonTag::hexValue( char c ) {
+  if ( c >= '0' && c <= '9' ) return c - '0';
+  if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+  if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+  return -1;
 }
+#if IBUTTON_STATS
 
 /*
- * Writes a bit to the data line with a delay after it.
- *
- * The data line stays _high_ after this function. Calling procedures should
- * perform other actions on the data line or _depower_.
+ * Records a call in a latency histogram and passes its status.
  */
-void iButtonTag::writeBitDelayed( uint8_t b ) { // b can only be 0 or 1 !!
-  // Write as always
-  _wire -> write_bit( b );
-  // Delay 10ms - May need as much as 20ms? Or can do with less?
-  delay( 10 );
+int8_t iButtonTag::recordCall( iButtonLatency& latency, uint32_t start,
+                               int8_t status ) {
+  uint32_t time = micros() - start;
+  latency.calls++;
+  latency.total += time;
+  if ( time > latency.longest ) latency.longest = time;
+
+  // Bucket 0 for less than 256 microseconds, then one per doubling
+  uint8_t b = 0;
+  for ( uint32_t t = time >> 8; t > 0 && b < IBUTTON_STATS_BUCKETS - 1; t >>= 1 )
+    b++;
+  if ( latency.buckets[b] < 0xFFFF ) latency.buckets[b]++;
+  return status;
 }
 
 /*
- * Calculates checksum of iButtonCode.
- *
- * Returns correct checksum value
+ * Prints a latency histogram to Serial, empty buckets are left out.
  */
-uint8_t iButtonTag::calculateChecksum( const uint8_t* code ) {
-  return OneWire::crc8( code, 7 );
+void iButtonTag::printLatency( const char* name, const iButtonLatency& latency ) {
+  Serial.print( name );
+  Serial.print( ": " );
+  Serial.print( latency.calls );
+  Serial.print( " calls" );
+  if ( latency.calls > 0 ) {
+    Serial.print( ", average " );
+    Serial.print( latency.total / latency.calls );
+    Serial.print( " us, longest " );
+    Serial.print( latency.longest );
+    Serial.print( " us" );
+  }
+  Serial.println();
+  for ( uint8_t b = 0; b < IBUTTON_STATS_BUCKETS; b++ ) {
+    if ( latency.buckets[b] == 0 ) continue;
+    Serial.print( b < IBUTTON_STATS_BUCKETS - 1 ? "  < " : "  >= " );
+    Serial.print( 256UL << ( b < IBUTTON_STATS_BUCKETS - 1 ? b : b - 1 ) );
+    Serial.print( " us: " );
+    Serial.println( latency.buckets[b] );
+  }
 }
+
+#endif
@@ -8,7 +8,7 @@
 
 // Includes
 #include <inttypes.h>
-#include <OneWire.h>
+#include "iButtonBus.h"
 
 // Constants for iButton (re)writable tag types
 #define IBUTTON_UNKNOWN     0
@@ -18,47 +18,250 @@
 #define IBUTTON_TM01        4 // Model sold as TM01, TM01C - Non-detectable
 #define IBUTTON_MAXWRITABLE 4 // Always equal to maximum type constant
 
+// Constant for status of non-blocking procedure still in progress
+#define IBUTTON_BUSY        2
+
+// Constants for CRC8 calculation strategies, select one with IBUTTON_CRC8
+#define IBUTTON_CRC8_TABLE  1 // 256-byte table in PROGMEM, fastest
+#define IBUTTON_CRC8_NIBBLE 2 // 16-byte table in PROGMEM, smallest
+
+// Default CRC8 calculation strategy
+#ifndef IBUTTON_CRC8
+#define IBUTTON_CRC8 IBUTTON_CRC8_TABLE
+#endif
+
+// Constants for speed of bus traffic, select one with setSpeed
+#define IBUTTON_SPEED_STANDARD  0 // Standard speed only
+#define IBUTTON_SPEED_AUTO      1 // Overdrive speed for iButtons supporting it
+#define IBUTTON_SPEED_OVERDRIVE 2 // Also searching at overdrive speed
+
+// Number of iButtons with known overdrive capability, by code
+#ifndef IBUTTON_SPEED_CACHE
+#define IBUTTON_SPEED_CACHE 4
+#endif
+
+// Number of detected (re)writable types cached by code, 0 disables the cache
+#ifndef IBUTTON_TYPE_CACHE
+#define IBUTTON_TYPE_CACHE 4
+#endif
+
+// Statistics of bus operations and call latencies, off by default
+#ifndef IBUTTON_STATS
+#define IBUTTON_STATS 0
+#endif
+
+// Number of buckets in latency histograms
+#define IBUTTON_STATS_BUCKETS 12
+
+// Size of buffer for iButtonCode as text: 8 hexadecimal byte values separated
+// by spaces, terminating null character included
+#define IBUTTON_CODE_TEXT 24
+
 // Type definition
 typedef uint8_t iButtonCode[8];
 
+#if IBUTTON_STATS
+// Type definition, latency histogram of one function
+struct iButtonLatency {
+  uint32_t calls;                           // Number of calls
+  uint32_t total;                           // Total time, microseconds
+  uint32_t longest;                         // Longest call, microseconds
+  uint16_t buckets[IBUTTON_STATS_BUCKETS];  // Bucket i: < 256 << i microseconds
+};
+
+// Type definition, statistics of one iButtonTag object
+struct iButtonStats {
+  uint32_t resets;                          // Resets of the data line
+  uint32_t noPresence;                      // Resets without presence pulse
+  uint32_t bytesWritten;
+  uint32_t bytesRead;
+  uint32_t bitsWritten;                     // Single bits, not part of bytes
+  uint32_t bitsRead;                        // Single bits, not part of bytes
+  uint32_t checksumFailures;                // Codes read with status -1
+  uint32_t zeroCodes;                       // Codes read with status -2
+  uint32_t delayMicros;                     // Time waited for programming
+  iButtonLatency readCode;
+  iButtonLatency nextCode;
+  iButtonLatency detectWritableType;
+  iButtonLatency writeCode;
+};
+#endif
+
 // Class definition
 class iButtonTag {
 
   public:
-    // Constructor / destructor
+    // Constructors
     iButtonTag( uint8_t );
-    ~iButtonTag() { delete _wire; };
+    iButtonTag( iButtonBus& );
+
+    // Not copyable: a copy would use the bus backend inside the original
+    iButtonTag( const iButtonTag& ) = delete;
+    iButtonTag& operator=( const iButtonTag& ) = delete;
 
     // Functions
     int8_t readCode( uint8_t*, bool = false );
+    int8_t readCodeStable( uint8_t*, uint8_t = 2, uint8_t = 8, uint16_t = 100,
+                           uint8_t* = NULL );
     int8_t readCodes();
+    int8_t readCodes( uint8_t );
     int8_t nextCode( uint8_t* );
+    int8_t checkPresence();
+    int8_t verifyPresent( const uint8_t* );
+    uint8_t verifyPresent( const iButtonCode*, uint8_t, bool* = NULL );
+    int8_t selectCode( const uint8_t* );
+
+    // Functions for overdrive speed
+    int8_t setSpeed( int8_t );
+    int8_t speed() const { return _speed; }
+    int8_t overdriveCapable( const uint8_t* );
 
     // Static functions
     static int8_t testCode( const uint8_t* );
+    static uint16_t testCodes( const iButtonCode*, uint16_t, int8_t* = NULL );
     static bool equalCode( const uint8_t*, const uint8_t* );
-    static void printCode( const uint8_t*, bool = false );
+    static void printCode( const uint8_t*, bool = false, Print& = Serial );
+    static char* formatCode( const uint8_t*, char*, bool = false );
+    static int8_t parseCode( const char*, uint8_t*, bool = false );
     static void updateChecksum( uint8_t* );
+    static uint8_t crc8( const uint8_t*, uint8_t );
 
     // Functions for writing
     int8_t detectWritableType();
     int8_t writeCode( const uint8_t*, int8_t = IBUTTON_UNKNOWN, bool = true );
+    int8_t beginWrite( const uint8_t*, int8_t = IBUTTON_UNKNOWN, bool = true );
+    int8_t beginDetect();
+    int8_t detectedType() const;
+    int8_t pollWrite();
+    uint8_t writeProgress();
+
+    // Functions for write timing
+    int8_t setWriteDelay( int8_t, uint32_t );
+    uint32_t writeDelay( int8_t );
+    int8_t calibrateWriteDelay( int8_t = IBUTTON_UNKNOWN, uint8_t = 50 );
+    void clearTypeCache();
+
+#if IBUTTON_STATS
+    // Functions for statistics
+    const iButtonStats& stats() { return _stats; }
+    void resetStats();
+    void printStats();
+#endif
 
   private:
-    // OneWire instance
-    OneWire* _wire;
+    // Memory access uses the bus operations
+    friend class iButtonMemory;
+
+    // The enumerator searches with bus operations, along the codes it knows
+    friend class iButtonEnumerator;
+
+    // Bus backend in use: the OneWire backend on the pin, stored by value (no
+    // heap allocation), or the backend supplied to the constructor. Using a
+    // supplied backend, _pinBus stays unused but still takes its RAM: about 30
+    // bytes on AVR (vptr, search state of iButtonBus and the OneWire object)
+    iButtonOneWireBus _pinBus;
+    iButtonBus* _bus;
+
+    // Speed of bus traffic
+    int8_t _speed;          // Speed setting
+    bool _busOverdrive;     // Resets and time slots at overdrive speed
+    bool _searchOverdrive;  // Search in progress at overdrive speed
+    bool _searchFirst;      // No device found yet in search
+    int16_t _searchFamily;  // Family code searched, -1 for all families
+    bool _crowded;          // More than one device seen by last verifyPresent
+#if IBUTTON_SPEED_CACHE > 0
+    // Overdrive capability by code, most recently used first
+    iButtonCode _sCode[IBUTTON_SPEED_CACHE];
+    bool _sCapable[IBUTTON_SPEED_CACHE];
+    uint8_t _sCount;
+#endif
+
+    // State of (non-blocking) write procedure
+    iButtonCode _wCode;     // Code to be written
+    int8_t _wType;          // Writable type, IBUTTON_UNKNOWN until detected
+    bool _wCheck;           // Checking on
+    bool _wDetect;          // Detecting type only, not writing
+    uint8_t _wPhase;        // Current phase of procedure
+    uint8_t _wStep;         // Step within current phase
+    int8_t _wStatus;        // Final status of last procedure
+    uint32_t _wStart;       // Start of delay after last step, micros()
+    uint32_t _wWait;        // Length of delay after last step, microseconds
+
+    // Timing profile, programming delay per writable type in microseconds
+    uint32_t _wDelay[IBUTTON_MAXWRITABLE];
+
+    // Probing for type, types RW1990V1, RW1990V2 and RW2004 only
+    uint8_t _wProbe;        // Index of current probe in order
+    uint8_t _wOrder[3];     // Types in order of probing, most detected first
+    uint8_t _wSeen[3];      // Number of times each type was detected
+
+#if IBUTTON_TYPE_CACHE > 0
+    // Cache of detected types by code, most recently used first
+    iButtonCode _wRom;      // Code read before probing
+    bool _wRomValid;        // Code read and valid, type can be cached
+    iButtonCode _cCode[IBUTTON_TYPE_CACHE];
+    int8_t _cType[IBUTTON_TYPE_CACHE];
+    uint8_t _cCount;
+#endif
+
+#if IBUTTON_STATS
+    // Statistics
+    iButtonStats _stats;
+#endif
+
+    // Initialization, common to constructors
+    void init();
+
+    // Bus operations, counted in statistics
+    uint8_t busReset( bool = false );
+    void busSpeed( bool );
+    void busWrite( uint8_t );
+    uint8_t busRead();
+    void busWriteBit( uint8_t );
+    uint8_t busReadBit();
+
+    // Functions for reading
+    int8_t beginSearch();
+    void restartSearch();
+    bool searchCode( const uint8_t*, bool = false );
+    uint8_t readPending( const iButtonCode*, uint8_t, uint8_t*, uint8_t* );
+    uint8_t searchPending( const iButtonCode*, uint8_t, uint8_t*, uint8_t* );
+    int8_t testRead( const uint8_t* );
+    void writeRom( const uint8_t* );
+
+    // Functions for overdrive speed
+    bool enterOverdrive( const uint8_t*, bool );
+    void speedStore( const uint8_t*, bool );
 
     // Functions for writing
-    int8_t isWritableTypeRW1990V1();
-    int8_t isWritableTypeRW1990V2();
+    void beginProcedure( const uint8_t*, int8_t, bool, bool );
+    int8_t pollProcedure();
+    int8_t stepProcedure();
+    void finishProcedure( int8_t );
+    int8_t foundType( int8_t );
+    int8_t nextProbe();
+    int8_t noDevice();
+    void startWriting( int8_t );
+    uint8_t enableCommand();
+    int8_t writeBitDelayed( uint8_t, uint32_t );
+    int8_t waitStep( uint32_t );
     int8_t isWritableTypeRW2004();
-    int8_t writeCodeCommon( const uint8_t*, uint8_t, bool = false );
-    int8_t writeCodeRW2004( const uint8_t* );
-    void writeByteDelayed( uint8_t, bool invert = false );
-    void writeBitDelayed( uint8_t );
+    int8_t writeTrial( const uint8_t*, int8_t );
+
+#if IBUTTON_TYPE_CACHE > 0
+    // Functions for type cache
+    int8_t cacheFind( const uint8_t* );
+    void cacheStore( const uint8_t*, int8_t );
+    void cacheRemove( const uint8_t* );
+#endif
 
     // Static functions
     static uint8_t calculateChecksum( const uint8_t* );
+    static int8_t hexValue( char );
+#if IBUTTON_STATS
+    static int8_t recordCall( iButtonLatency&, uint32_t, int8_t );
+    static void printLatency( const char*, const iButtonLatency& );
+#endif
 
 };
 
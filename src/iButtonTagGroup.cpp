@@ -0,0 +1,253 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include <Arduino.h>
+#include "iButtonTagGroup.h"
+
+#if IBUTTON_GROUP_PARALLEL
+#include <util/OneWire_direct_gpio.h>
+#endif
+
+
+// CONSTANTS
+
+// Timing of resets and time slots at standard speed, in microseconds. The same
+// as the OneWire library uses for a single pin.
+#define RESET_LOW     480 // Reset pulse
+#define RESET_WAIT    125 // Waiting for lines to go high, in steps of 2
+#define PRESENCE       70 // Release to sampling presence
+#define RESET_END     410 // Sampling presence to end of reset
+#define ONE_LOW        10 // Write 1: low pulse
+#define ONE_END        55 // Write 1: release to end of slot
+#define ZERO_LOW       65 // Write 0: low pulse
+#define ZERO_END        5 // Write 0: release to end of slot
+#define READ_LOW        3 // Read: low pulse
+#define READ_SAMPLE    10 // Read: release to sampling
+#define READ_END       53 // Read: sampling to end of slot
+
+
+// GROUP BUS
+
+/*
+ * Writes a byte to all data lines, least significant bit first.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonGroupBus
+ */
+void iButtonGroupBus::write( uint8_t b ) {
+  for ( uint8_t mask = 0x01; mask; mask <<= 1 ) writeBit( ( b & mask ) ? 1 : 0 );
+}
+
+
+// PIN GROUP BUS
+
+/*
+ * Constructs a group backend without pins, call begin before use.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonPinGroupBus
+ */
+iButtonPinGroupBus::iButtonPinGroupBus() {
+  _count = 0;
+}
+
+/*
+ * Constructs a group backend on the supplied pins.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonPinGroupBus
+ */
+iButtonPinGroupBus::iButtonPinGroupBus( const uint8_t* pins, uint8_t count ) {
+  begin( pins, count );
+}
+
+/*
+ * Sets up the supplied pins. Returns false when pins are on different ports,
+ * on AVR: the group has no lines then.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#beginGroup
+ */
+bool iButtonPinGroupBus::begin( const uint8_t* pins, uint8_t count ) {
+  _count = count < IBUTTON_GROUP_MAX ? count : IBUTTON_GROUP_MAX;
+#if IBUTTON_GROUP_PARALLEL
+  _reg = PIN_TO_BASEREG( pins[0] );
+  _mask = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) {
+    if ( PIN_TO_BASEREG( pins[i] ) != _reg ) {
+      _count = 0;
+      return false;
+    }
+    pinMode( pins[i], INPUT );
+    _masks[i] = PIN_TO_BITMASK( pins[i] );
+    _mask |= _masks[i];
+  }
+#else
+  for ( uint8_t i = 0; i < _count; i++ ) _wires[i].begin( pins[i] );
+#endif
+  return true;
+}
+
+/*
+ * Resets all data lines. Returns the lines with a presence pulse. Lines held
+ * low before the reset, like a shorted probe, have no presence.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonGroupBus
+ */
+uint8_t iButtonPinGroupBus::reset() {
+#if IBUTTON_GROUP_PARALLEL
+  IO_REG_TYPE mask IO_REG_MASK_ATTR = _mask;
+  volatile IO_REG_TYPE* reg IO_REG_BASE_ATTR = _reg;
+  if ( _count == 0 ) return 0;
+
+  // Wait for all lines to go high, or give up on the ones that don't
+  noInterrupts();
+  DIRECT_MODE_INPUT( reg, mask );
+  interrupts();
+  uint8_t retries = RESET_WAIT;
+  while ( ( *reg & mask ) != mask && --retries ) delayMicroseconds( 2 );
+  uint8_t high = lineBits( *reg );
+
+  noInterrupts();
+  DIRECT_WRITE_LOW( reg, mask );
+  DIRECT_MODE_OUTPUT( reg, mask );
+  interrupts();
+  delayMicroseconds( RESET_LOW );
+  noInterrupts();
+  DIRECT_MODE_INPUT( reg, mask );
+  delayMicroseconds( PRESENCE );
+  IO_REG_TYPE sample = *reg;           // Input register of the port, all pins
+  interrupts();
+  delayMicroseconds( RESET_END );
+  return high & (uint8_t) ~lineBits( sample );
+#else
+  uint8_t presence = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) if ( _wires[i].reset() ) presence |= 1 << i;
+  return presence;
+#endif
+}
+
+/*
+ * Writes a single bit to all data lines.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonGroupBus
+ */
+void iButtonPinGroupBus::writeBit( uint8_t b ) {
+#if IBUTTON_GROUP_PARALLEL
+  IO_REG_TYPE mask IO_REG_MASK_ATTR = _mask;
+  volatile IO_REG_TYPE* reg IO_REG_BASE_ATTR = _reg;
+
+  noInterrupts();
+  DIRECT_WRITE_LOW( reg, mask );
+  DIRECT_MODE_OUTPUT( reg, mask );
+  delayMicroseconds( b ? ONE_LOW : ZERO_LOW );
+  DIRECT_MODE_INPUT( reg, mask );
+  interrupts();
+  delayMicroseconds( b ? ONE_END : ZERO_END );
+#else
+  for ( uint8_t i = 0; i < _count; i++ ) _wires[i].write_bit( b );
+#endif
+}
+
+/*
+ * Reads a single bit from all data lines. Returns the lines reading a 1.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonGroupBus
+ */
+uint8_t iButtonPinGroupBus::readBits() {
+#if IBUTTON_GROUP_PARALLEL
+  IO_REG_TYPE mask IO_REG_MASK_ATTR = _mask;
+  volatile IO_REG_TYPE* reg IO_REG_BASE_ATTR = _reg;
+
+  noInterrupts();
+  DIRECT_WRITE_LOW( reg, mask );
+  DIRECT_MODE_OUTPUT( reg, mask );
+  delayMicroseconds( READ_LOW );
+  DIRECT_MODE_INPUT( reg, mask );
+  delayMicroseconds( READ_SAMPLE );
+  IO_REG_TYPE sample = *reg;           // Input register of the port, all pins
+  interrupts();
+  uint8_t bits = lineBits( sample );   // Takes part of the end of the slot
+  delayMicroseconds( READ_END );
+  return bits;
+#else
+  uint8_t bits = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) if ( _wires[i].read_bit() ) bits |= 1 << i;
+  return bits;
+#endif
+}
+
+#if IBUTTON_GROUP_PARALLEL
+/*
+ * Converts a value of the input register of the port to a mask of lines.
+ */
+uint8_t iButtonPinGroupBus::lineBits( IO_REG_TYPE sample ) const {
+  uint8_t bits = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) if ( sample & _masks[i] ) bits |= 1 << i;
+  return bits;
+}
+#endif
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonTagGroup object for probes on the supplied pins.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonTagGroup
+ */
+iButtonTagGroup::iButtonTagGroup( const uint8_t* pins, uint8_t count )
+  : _pinBus( pins, count ) {
+  _bus = &_pinBus;
+  _count = _pinBus.lines();
+}
+
+/*
+ * Constructs an iButtonTagGroup object for the supplied number of probes on
+ * the supplied group backend.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonTagGroup
+ */
+iButtonTagGroup::iButtonTagGroup( iButtonGroupBus& bus, uint8_t count ) {
+  _bus = &bus;
+  _count = count < IBUTTON_GROUP_MAX ? count : IBUTTON_GROUP_MAX;
+}
+
+/*
+ * Reads one single iButtonCode from every probe of the group, in one reset
+ * and one set of time slots for all of them. Returns the number of valid
+ * codes read.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#readCodeGroup
+ */
+uint8_t iButtonTagGroup::readCode( iButtonCode* codes, int8_t* statuses,
+                                   bool old /* = false */ ) {
+  for ( uint8_t i = 0; i < _count; i++ ) statuses[i] = 0;
+  uint8_t present = _count > 0 ? _bus -> reset() : 0;
+  if ( present == 0 ) return 0;
+
+  // READ ROM, all lines at once. Bits are distributed to the codes afterwards,
+  // keeping the time between slots short.
+  _bus -> write( old ? 0x0F : 0x33 );
+  uint8_t samples[64];
+  for ( uint8_t b = 0; b < 64; b++ ) samples[b] = _bus -> readBits();
+
+  uint8_t valid = 0;
+  for ( uint8_t i = 0; i < _count; i++ ) {
+    uint8_t line = 1 << i;
+    if ( !( present & line ) ) continue;      // Code unchanged, like readCode
+    for ( uint8_t j = 0; j < 8; j++ ) {
+      uint8_t value = 0;
+      for ( uint8_t k = 0; k < 8; k++ ) if ( samples[j * 8 + k] & line ) value |= 1 << k;
+      codes[i][j] = value;
+    }
+    statuses[i] = iButtonTag::testCode( codes[i] );
+    if ( statuses[i] == 1 ) valid++;
+  }
+  return valid;
+}
@@ -0,0 +1,101 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonTagGroup_h
+#define iButtonTagGroup_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+
+// Maximum number of probes in a group, one bit each in a mask: a port
+#define IBUTTON_GROUP_MAX 8
+
+// Driving all pins of a port at once needs the direct pin access of the
+// OneWire library on AVR, where all pins of a port share one set of registers
+#if defined(__AVR__) && defined(__has_include)
+#if __has_include(<util/OneWire_direct_gpio.h>)
+#define IBUTTON_GROUP_PARALLEL 1
+#endif
+#endif
+#ifndef IBUTTON_GROUP_PARALLEL
+#define IBUTTON_GROUP_PARALLEL 0
+#endif
+
+// Class definition, interface of the data lines of a group of probes. Masks
+// hold one bit per data line: bit i for line i.
+class iButtonGroupBus {
+
+  public:
+    virtual ~iButtonGroupBus() {}
+
+    // Bus operations on all data lines of the group at once
+    virtual uint8_t reset() = 0;               // Lines with presence pulse
+    virtual void writeBit( uint8_t ) = 0;      // Same bit on every line
+    virtual uint8_t readBits() = 0;            // Lines reading a 1
+    virtual void write( uint8_t );
+
+};
+
+// Class definition, group backend on pins: all pins of a port driven with
+// single register operations on AVR, one pin after the other elsewhere
+class iButtonPinGroupBus : public iButtonGroupBus {
+
+  public:
+    // Constructors
+    iButtonPinGroupBus();
+    iButtonPinGroupBus( const uint8_t*, uint8_t );
+    bool begin( const uint8_t*, uint8_t );
+
+    // Functions
+    uint8_t lines() const { return _count; }
+    bool parallel() const { return IBUTTON_GROUP_PARALLEL; }
+
+    // Bus operations
+    uint8_t reset();
+    void writeBit( uint8_t );
+    uint8_t readBits();
+
+  private:
+    uint8_t _count;
+#if IBUTTON_GROUP_PARALLEL
+    // Registers of the port, mask of every pin and of all of them
+    volatile IO_REG_TYPE* _reg;
+    IO_REG_TYPE _masks[IBUTTON_GROUP_MAX];
+    IO_REG_TYPE _mask;
+    uint8_t lineBits( IO_REG_TYPE ) const;
+#else
+    // OneWire instance per pin, stored by value: no heap allocation
+    OneWire _wires[IBUTTON_GROUP_MAX];
+#endif
+
+};
+
+// Class definition
+class iButtonTagGroup {
+
+  public:
+    // Constructors
+    iButtonTagGroup( const uint8_t*, uint8_t );
+    iButtonTagGroup( iButtonGroupBus&, uint8_t );
+
+    // Not copyable: a copy would use the group backend inside the original
+    iButtonTagGroup( const iButtonTagGroup& ) = delete;
+    iButtonTagGroup& operator=( const iButtonTagGroup& ) = delete;
+
+    // Functions
+    uint8_t count() const { return _count; }
+    uint8_t readCode( iButtonCode*, int8_t*, bool = false );
+
+  private:
+    // Group backend in use: the pin backend, stored by value (no heap
+    // allocation), or the backend supplied to the constructor
+    iButtonPinGroupBus _pinBus;
+    iButtonGroupBus* _bus;
+    uint8_t _count;
+
+};
+
+#endif // iButtonTagGroup_h
@@ -0,0 +1,113 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonUartBus.h"
+
+
+// CONSTANTS
+
+// Baud rates: one frame at 9600 baud is a reset pulse, one frame at 115200
+// baud is a time slot. At overdrive speed frames at 115200 baud are resets,
+// at 1000000 baud time slots.
+#define BAUD_RESET             9600
+#define BAUD_SLOT            115200
+#define BAUD_OVERDRIVE_RESET 115200
+#define BAUD_OVERDRIVE_SLOT 1000000
+
+// Frames sent to the data line, durations at standard speed
+#define FRAME_RESET  0xF0 // Start bit and 4 bits low: 520 microseconds
+#define FRAME_ONE    0xFF // Start bit low: 9 microseconds, write 1 or read
+#define FRAME_ZERO   0x00 // Start bit and 8 bits low: 78 microseconds
+
+// Reset frame at overdrive speed, slot frames are the same
+#define FRAME_OVERDRIVE_RESET 0xE0 // Start bit and 5 bits low: 52 microseconds
+
+// Maximum time to wait for the echo of a frame, in microseconds
+#define TIMEOUT_RESET 3000
+#define TIMEOUT_SLOT  1000
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonUartBus object on the supplied serial port.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonUartBus
+ */
+iButtonUartBus::iButtonUartBus( HardwareSerial& serial ) : _serial( serial ) {
+  _baud = 0;
+  _overdrive = false;
+}
+
+/*
+ * Resets the data line, returns 1 if at least one device asserted presence.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonUartBus
+ */
+uint8_t iButtonUartBus::reset() {
+  uint8_t frame = _overdrive ? FRAME_OVERDRIVE_RESET : FRAME_RESET;
+  setBaud( _overdrive ? BAUD_OVERDRIVE_RESET : BAUD_RESET );
+  while ( _serial.available() > 0 ) _serial.read(); // Drop stale echoes
+  _serial.write( frame );
+  int16_t echo = receive( TIMEOUT_RESET );
+  setBaud( _overdrive ? BAUD_OVERDRIVE_SLOT : BAUD_SLOT );
+
+  // A device asserting presence pulls the data line low during the high bits
+  // of the frame, no echo at all means the data line is not connected
+  return echo >= 0 && echo != frame ? 1 : 0;
+}
+
+
+// PRIVATE FUNCTIONS
+
+/*
+ * Changes the baud rate of the serial port, after sending pending frames.
+ */
+void iButtonUartBus::setBaud( uint32_t baud ) {
+  if ( baud == _baud ) return;
+  _serial.flush();
+  _serial.begin( baud );
+  _baud = baud;
+}
+
+/*
+ * Transfers the lowest _count_ bits of b as time slots, returns the bits read.
+ *
+ * All frames are queued first and their echoes collected afterwards: the UART
+ * times the slots, interrupts can't stretch them.
+ */
+uint8_t iButtonUartBus::transfer( uint8_t b, uint8_t count ) {
+  setBaud( _overdrive ? BAUD_OVERDRIVE_SLOT : BAUD_SLOT );
+  while ( _serial.available() > 0 ) _serial.read(); // Drop stale echoes
+
+  for ( uint8_t i = 0; i < count; i++ ) {
+    _serial.write( (uint8_t) ( ( b >> i ) & 1 ? FRAME_ONE : FRAME_ZERO ) );
+  }
+
+  // A bit reads 1 only when no device pulled the data line low during the slot
+  uint8_t r = 0;
+  for ( uint8_t i = 0; i < count; i++ ) {
+    if ( receive( TIMEOUT_SLOT ) == FRAME_ONE ) r |= 1 << i;
+  }
+  return r;
+}
+
+/*
+ * Waits for the echo of a frame, returns it or -1 on timeout.
+ */
+int16_t iButtonUartBus::receive( uint16_t timeout ) {
+  uint32_t start = micros();
+  while ( _serial.available() <= 0 ) {
+    if ( (uint32_t) ( micros() - start ) > timeout ) return -1;
+  }
+  return _serial.read();
+}
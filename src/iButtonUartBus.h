@@ -0,0 +1,40 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonUartBus_h
+#define iButtonUartBus_h
+
+// Includes
+#include <inttypes.h>
+#include <Arduino.h>
+#include "iButtonBus.h"
+
+// Class definition, bus backend generating time slots with a hardware UART
+class iButtonUartBus : public iButtonBus {
+
+  public:
+    // Constructor
+    iButtonUartBus( HardwareSerial& );
+
+    // Bus operations
+    uint8_t reset();
+    void writeBit( uint8_t b ) { transfer( b, 1 ); }
+    uint8_t readBit() { return transfer( 1, 1 ); }
+    void write( uint8_t b ) { transfer( b, 8 ); }
+    uint8_t read() { return transfer( 0xFF, 8 ); }
+    bool overdrive( bool on ) { _overdrive = on; return true; }
+
+  private:
+    HardwareSerial& _serial;
+    uint32_t _baud;         // Current baud rate, 0 before first use
+    bool _overdrive;        // Resets and time slots at overdrive speed
+
+    void setBaud( uint32_t );
+    uint8_t transfer( uint8_t, uint8_t );
+    int16_t receive( uint16_t );
+
+};
+
+#endif // iButtonUartBus_h
@@ -0,0 +1,103 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Reference documentation available in doc-folder of library. Only short
+ * descriptions in this source file. Full documentation can be viewed online
+ * via: https://vdwulp.github.io/iButtonTag/REFERENCE.html
+ */
+
+
+#include "iButtonWatcher.h"
+
+
+// PUBLIC FUNCTIONS
+
+/*
+ * Constructs an iButtonWatcher object for the supplied iButtonTag.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#iButtonWatcher
+ */
+iButtonWatcher::iButtonWatcher( iButtonTag& tag, uint8_t window /* = 3 */,
+                                uint16_t interval /* = 10 */ )
+  : _tag( tag ) {
+  _window = window > 0 ? window : 1;
+  _interval = interval;
+  _onArrive = NULL;
+  _onDepart = NULL;
+  _onInvalid = NULL;
+  _state = STATE_EMPTY;
+  _count = 0;
+  _invalid = 0;
+  _last = 0;
+  for ( uint8_t i = 0; i < 8; i++ ) _code[i] = 0x00;
+}
+
+/*
+ * Checks the data line for arriving and departing iButtons.
+ *
+ * See https://vdwulp.github.io/iButtonTag/REFERENCE.html#poll
+ */
+void iButtonWatcher::poll() {
+  // Check once every interval
+  uint32_t now = millis();
+  if ( (uint32_t) ( now - _last ) < _interval ) return;
+  _last = now;
+
+  switch ( _state ) {
+
+    case STATE_EMPTY:
+      // Nothing on the probe, only RESET the data line to check for presence
+      if ( _tag.checkPresence() == 0 ) return;
+      _state = STATE_ARRIVING;
+      _count = 0;
+      _invalid = 0;
+      // Presence detected, read code right away
+      // fall through
+
+    case STATE_ARRIVING: {
+      // Read code until it's the same a number of times in a row. Sliding an
+      // iButton on the probe gives invalid or incorrect codes now and then:
+      // invalid reads are skipped, only a number of them in a row rejects it.
+      iButtonCode code;
+      int8_t status = _tag.readCode( code );
+      if ( status == 0 ) {                     // Gone again, bounce
+        _state = STATE_EMPTY;
+        return;
+      }
+      if ( status < 0 ) {                      // Invalid code
+        if ( ++_invalid < _window ) return;
+        _state = STATE_REJECTED;
+        if ( _onInvalid ) _onInvalid( code, status );
+        return;
+      }
+      _invalid = 0;
+      if ( _count == 0 || !iButtonTag::equalCode( code, _code ) ) {
+        for ( uint8_t i = 0; i < 8; i++ ) _code[i] = code[i];
+        _count = 0;                            // New candidate code
+      }
+      if ( ++_count < _window ) return;
+      _state = STATE_PRESENT;
+      _count = 0;
+      if ( _onArrive ) _onArrive( _code, status );
+      return;
+    }
+
+    case STATE_PRESENT:
+    case STATE_REJECTED:
+      // Tag on the probe, only RESET the data line until it's gone for a number
+      // of times in a row
+      if ( _tag.checkPresence() ) {
+        _count = 0;
+        return;
+      }
+      if ( ++_count < _window ) return;
+      if ( _state == STATE_PRESENT && _onDepart ) _onDepart( _code, 0 );
+      _state = STATE_EMPTY;
+      _count = 0;
+      return;
+
+  }
+}
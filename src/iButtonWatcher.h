@@ -0,0 +1,56 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#ifndef iButtonWatcher_h
+#define iButtonWatcher_h
+
+// Includes
+#include <inttypes.h>
+#include "iButtonTag.h"
+
+// Type definition of event handler: code and status as returned by readCode
+typedef void ( *iButtonEventHandler )( const uint8_t*, int8_t );
+
+// Class definition
+class iButtonWatcher {
+
+  public:
+    // Constructor
+    iButtonWatcher( iButtonTag&, uint8_t = 3, uint16_t = 10 );
+
+    // Event handlers
+    void onArrive( iButtonEventHandler handler ) { _onArrive = handler; }
+    void onDepart( iButtonEventHandler handler ) { _onDepart = handler; }
+    void onInvalid( iButtonEventHandler handler ) { _onInvalid = handler; }
+
+    // Functions
+    void poll();
+    bool isPresent() const { return _state == STATE_PRESENT; }
+    const uint8_t* code() const { return _code; }
+
+  private:
+    // States
+    enum { STATE_EMPTY, STATE_ARRIVING, STATE_PRESENT, STATE_REJECTED };
+
+    // Settings
+    iButtonTag& _tag;
+    uint8_t _window;
+    uint16_t _interval;
+
+    // Event handlers
+    iButtonEventHandler _onArrive;
+    iButtonEventHandler _onDepart;
+    iButtonEventHandler _onInvalid;
+
+    // State
+    uint8_t _state;
+    uint8_t _count;         // Agreeing reads, or absent checks
+    uint8_t _invalid;       // Invalid reads in a row
+    uint32_t _last;         // Time of last check, millis()
+    iButtonCode _code;
+
+};
+
+#endif // iButtonWatcher_h
@@ -0,0 +1,29 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonBackground.h>
+
+unittest( iButtonBackground_basics ) {
+
+  // Background reading on PIN 2
+  iButtonBackground background( 2 );
+
+  // Functions done and status, nothing started
+  assertTrue( background.done() );
+  assertEqual( 0, background.status() );
+
+  // Functions startRead, startSearch and startNext before begin
+  assertEqual( 0, background.startRead() );           // Not started
+  assertEqual( 0, background.startSearch() );
+  assertEqual( 0, background.startNext() );
+  assertTrue( background.done() );
+
+  // Function begin, only succeeds on supported boards
+  assertEqual( (bool) IBUTTON_BACKGROUND_SUPPORTED, background.begin() );
+
+}
+
+unittest_main()
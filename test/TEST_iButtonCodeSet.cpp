@@ -0,0 +1,65 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonCodeSet.h>
+
+unittest( iButtonCodeSet_basics ) {
+
+  // Variables
+  iButtonCode codes[6], code, missing;
+
+  // Fill codes in reverse order, two family codes
+  for( uint8_t i = 0; i < 6; i++ ) {
+    for( uint8_t j = 0; j < 8; j++ ) codes[i][j] = 0x00;
+    codes[i][0] = i < 3 ? 0x01 : 0x08;
+    codes[i][1] = 60 - 10 * i;
+    iButtonTag::updateChecksum( codes[i] );
+  }
+  for( uint8_t j = 0; j < 8; j++ ) missing[j] = codes[2][j];
+  missing[6] = 0x01;
+  iButtonTag::updateChecksum( missing );
+
+  // Function sortCodes
+  iButtonCodeSet::sortCodes( codes, 6 );
+  assertEqual( 0x01, codes[0][0] );
+  assertEqual( 40, codes[0][1] );
+  assertEqual( 0x01, codes[2][0] );
+  assertEqual( 60, codes[2][1] );
+  assertEqual( 0x08, codes[3][0] );
+  assertEqual( 10, codes[3][1] );
+
+  iButtonCodeSet set( codes, 6 );
+
+  // Function count
+  assertEqual( 6, set.count() );
+
+  // Functions indexOf and contains, without index
+  for( uint8_t i = 0; i < 6; i++ ) assertEqual( i, set.indexOf( codes[i] ) );
+  assertEqual( -1, set.indexOf( missing ) );
+  assertTrue( set.contains( codes[5] ) );
+  assertFalse( set.contains( missing ) );
+
+  // Function buildIndex
+  assertTrue( set.buildIndex() );
+
+  // Functions indexOf and contains, with index
+  for( uint8_t i = 0; i < 6; i++ ) assertEqual( i, set.indexOf( codes[i] ) );
+  assertEqual( -1, set.indexOf( missing ) );
+  missing[0] = 0x02;                                  // Family not in table
+  assertFalse( set.contains( missing ) );
+
+  // Function getCode
+  set.getCode( 4, code );
+  assertTrue( iButtonTag::equalCode( code, codes[4] ) );
+
+  // Function buildIndex fails on unsorted table
+  iButtonCodeSet unsorted( codes + 1, 3 );
+  codes[1][1] = 0xFF;
+  assertFalse( unsorted.buildIndex() );
+
+}
+
+unittest_main()
@@ -0,0 +1,131 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonTag.h>
+#include <iButtonFrame.h>
+
+// Output collecting bytes, counting writes
+class Capture {
+
+  public:
+    uint8_t data[256];
+    size_t size = 0;
+    uint16_t writes = 0;
+    size_t write( const uint8_t* buffer, size_t length ) {
+      writes++;
+      for ( size_t i = 0; i < length; i++ ) data[size++] = buffer[i];
+      return length;
+    }
+
+};
+
+// Feeds bytes to parser, returns number of frames decoded
+uint8_t feedAll( iButtonFrameParser& parser, const uint8_t* data, size_t length ) {
+  uint8_t frames = 0;
+  for ( size_t i = 0; i < length; i++ ) frames += parser.feed( data[i] );
+  return frames;
+}
+
+unittest( iButtonFrame_encode ) {
+  uint8_t code[8] = { 0x01, 0x0B, 0x15, 0x1F, 0x29, 0x33, 0x3D, 0xE8 };
+  uint8_t frame[IBUTTON_FRAME_MAX];
+
+  // Function encodeCode
+  assertEqual( 14, iButtonFrame::encodeCode( frame, IBUTTON_FRAME_READ, code, 1, 7 ) );
+  assertEqual( IBUTTON_FRAME_SYNC, frame[0] );
+  assertEqual( 10, frame[1] );
+  assertEqual( IBUTTON_FRAME_READ, frame[2] );
+  assertEqual( 7, frame[3] );
+  assertEqual( 1, frame[4] );
+  for ( uint8_t i = 0; i < 8; i++ ) assertEqual( code[i], frame[5 + i] );
+  assertEqual( iButtonTag::crc8( frame + 1, 12 ), frame[13] );
+
+  // Function encodeStatus
+  assertEqual( 7, iButtonFrame::encodeStatus( frame, 9, -1, 2 ) );
+  assertEqual( IBUTTON_FRAME_STATUS, frame[2] );
+  assertEqual( iButtonTag::crc8( frame + 1, 5 ), frame[6] );
+
+  // Function encode
+  uint8_t payload[IBUTTON_FRAME_PAYLOAD + 1] = { 0 };
+  assertEqual( IBUTTON_FRAME_MAX, iButtonFrame::encode( frame, 0x40, payload, IBUTTON_FRAME_PAYLOAD ) );
+  assertEqual( 0, iButtonFrame::encode( frame, 0x40, payload, IBUTTON_FRAME_PAYLOAD + 1 ) );
+  assertEqual( 4, iButtonFrame::encode( frame, 0x40, NULL, 0 ) );
+
+  // Functions write, writeCode and writeStatus: single write per frame
+  Capture capture;
+  assertEqual( 14, iButtonFrame::writeCode( capture, IBUTTON_FRAME_WRITE, code, 1 ) );
+  assertEqual( 7, iButtonFrame::writeStatus( capture, 3, 0 ) );
+  assertEqual( 5, iButtonFrame::write( capture, 0x40, payload, 1 ) );
+  assertEqual( 0, iButtonFrame::write( capture, 0x40, payload, IBUTTON_FRAME_PAYLOAD + 1 ) );
+  assertEqual( 3, capture.writes );
+  assertEqual( 26, capture.size );
+}
+
+unittest( iButtonFrame_parse ) {
+  uint8_t code[8] = { 0x01, 0x0B, 0x15, 0x1F, 0x29, 0x33, 0x3D, 0xE8 };
+  uint8_t other[8] = { 0x01, 0xA5, 0xA5, 0xA5, 0x00, 0x00, 0x00, 0x00 };
+  iButtonTag::updateChecksum( other );
+  uint8_t result[8];
+  Capture capture;
+  iButtonFrameParser parser;
+
+  // Frames decoded one by one, noise between frames ignored
+  const uint8_t noise[3] = { 0x00, 0x17, 0xFF };
+  capture.write( noise, 3 );
+  iButtonFrame::writeCode( capture, IBUTTON_FRAME_READ, code, 1, 4 );
+  capture.write( noise, 3 );
+  iButtonFrame::writeStatus( capture, 9, -2, 5 );
+  iButtonFrame::writeCode( capture, IBUTTON_FRAME_WRITE, other, -1 );
+
+  uint8_t frames = 0;
+  for ( size_t i = 0; i < capture.size; i++ ) {
+    if ( parser.feed( capture.data[i] ) != 1 ) continue;
+    frames++;
+    if ( frames == 1 ) {
+      assertEqual( IBUTTON_FRAME_READ, parser.type() );
+      assertEqual( 4, parser.reader() );
+      assertEqual( 1, parser.status() );
+      assertTrue( parser.code( result ) );
+      assertTrue( iButtonTag::equalCode( code, result ) );
+    } else if ( frames == 2 ) {
+      assertEqual( IBUTTON_FRAME_STATUS, parser.type() );
+      assertEqual( 5, parser.reader() );
+      assertEqual( 9, parser.event() );
+      assertEqual( -2, parser.status() );
+      assertFalse( parser.code( result ) );
+    } else {
+      assertEqual( IBUTTON_FRAME_WRITE, parser.type() );
+      assertEqual( -1, parser.status() );
+      assertTrue( parser.code( result ) );
+      assertTrue( iButtonTag::equalCode( other, result ) );
+    }
+  }
+  assertEqual( 3, frames );
+  assertEqual( 0, parser.errors() );
+
+  // Damaged frame dropped
+  uint8_t frame[IBUTTON_FRAME_MAX];
+  uint8_t size = iButtonFrame::encodeCode( frame, IBUTTON_FRAME_READ, code, 1 );
+  frame[6] ^= 0x10;
+  assertEqual( 0, feedAll( parser, frame, size ) );
+  assertEqual( 1, parser.errors() );
+
+  // Truncated frame followed by a complete one: frame found after resync
+  size = iButtonFrame::encodeCode( frame, IBUTTON_FRAME_READ, other, 1 );
+  assertEqual( 0, feedAll( parser, frame, 6 ) );
+  assertEqual( 1, feedAll( parser, frame, size ) );
+  assertTrue( parser.code( result ) );
+  assertTrue( iButtonTag::equalCode( other, result ) );
+
+  // Function reset
+  assertEqual( 0, feedAll( parser, frame, 6 ) );
+  parser.reset();
+  assertEqual( 1, feedAll( parser, frame, size ) );
+  assertEqual( 0, parser.feed( 0x00 ) );
+  assertEqual( 0, parser.type() );
+}
+
+unittest_main()
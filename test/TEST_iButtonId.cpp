@@ -0,0 +1,67 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonTag.h>
+#include <iButtonId.h>
+
+// Codes checked and completed at compile time
+constexpr iButtonId idA( 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C );
+constexpr iButtonId idB( 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00 );
+constexpr iButtonId idBad( 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8D );
+static_assert( idA.valid(), "checksum of idA" );
+static_assert( idA == idB, "checksum filled in" );
+static_assert( idBad.test() == -1, "checksum failure" );
+static_assert( iButtonId().test() == -2, "all zeros" );
+static_assert( idA.family() == 0x01 && idA.crc() == 0x8C, "accessors" );
+static_assert( idA.serial() == 0x01C5945FULL, "serial" );
+static_assert( idA[2] == 0x94, "byte" );
+
+unittest( iButtonId_convert ) {
+  uint8_t code[8] = { 0x01, 0x0B, 0x15, 0x1F, 0x29, 0x33, 0x3D, 0x00 };
+  iButtonTag::updateChecksum( code );
+
+  // From and to an iButtonCode
+  iButtonId id( code );
+  assertEqual( 1, id.test() );
+  assertEqual( code[7], id.crc() );
+  uint8_t back[8];
+  id.toCode( back );
+  assertTrue( iButtonTag::equalCode( code, back ) );
+  for ( uint8_t i = 0; i < 8; i++ ) assertEqual( code[i], id[i] );
+
+  // Checksum the same as at run time
+  for ( uint8_t n = 0; n <= 8; n++ ) {
+    assertEqual( iButtonTag::crc8( code, n ), iButtonId::crc8( id.value(), n ) );
+  }
+
+  // Function withChecksum
+  code[3] ^= 0x40;
+  iButtonId changed( code );
+  assertEqual( -1, changed.test() );
+  iButtonTag::updateChecksum( code );
+  assertTrue( changed.withChecksum() == iButtonId( code ) );
+}
+
+unittest( iButtonId_compare ) {
+  iButtonId a( 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 );
+  iButtonId b( 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 );
+  iButtonId c( b.value() );
+
+  assertTrue( b == c );
+  assertTrue( a != b );
+  assertTrue( a < b );
+  assertTrue( a <= b );
+  assertTrue( b > a );
+  assertTrue( b >= c );
+  assertFalse( b < c );
+
+  // Same value, same hash; values differing in one byte, different hash
+  assertEqual( b.hash(), c.hash() );
+  assertNotEqual( a.hash(), b.hash() );
+  assertNotEqual( iButtonId( 0x01ULL ).hash(), iButtonId( 0x0100000000ULL ).hash() );
+}
+
+unittest_main()
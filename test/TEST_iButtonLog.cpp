@@ -0,0 +1,133 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonLog.h>
+
+// Storage in RAM, counting writes of every byte
+class RamStorage : public iButtonStorage {
+
+  public:
+    uint8_t data[200];
+    uint16_t writes[200];
+    uint16_t size() { return sizeof( data ); }
+    uint8_t read( uint16_t a ) { return data[a]; }
+    void write( uint16_t a, uint8_t b ) {
+      if ( data[a] != b ) writes[a]++;
+      data[a] = b;
+    }
+
+};
+
+// Makes a code with serial number n
+void makeCode( uint8_t* code, uint16_t n ) {
+  for( uint8_t i = 0; i < 8; i++ ) code[i] = 0x00;
+  code[0] = 0x01;
+  code[1] = n & 0xFF;
+  code[2] = n >> 8;
+  iButtonTag::updateChecksum( code );
+}
+
+unittest( iButtonLog_basics ) {
+
+  // Variables
+  RamStorage storage;
+  for( uint16_t i = 0; i < storage.size(); i++ ) {
+    storage.data[i] = 0x5A;                           // Not formatted
+    storage.writes[i] = 0;
+  }
+  iButtonCode code, read;
+  uint32_t time;
+  int8_t status;
+
+  iButtonLog log( storage );
+
+  // Functions begin and clear
+  assertFalse( log.begin() );
+  log.clear();
+  assertTrue( log.begin() );
+  assertEqual( 20, log.capacity() );
+  assertEqual( 0, log.count() );
+
+  // Function append, buffered in RAM
+  makeCode( code, 1 );
+  assertEqual( 1, log.append( code, 1000 ) );
+  makeCode( code, 2 );
+  assertEqual( 1, log.append( code, 1005, -3 ) );
+  assertEqual( 2, log.pending() );
+  assertEqual( 0, log.count() );
+  code[0] = 0x08;                                     // Other family code
+  assertEqual( 0, log.append( code, 1006 ) );
+
+  // Function flush, sync record and 2 records, sync record not counted
+  log.flush();
+  assertEqual( 0, log.pending() );
+  assertEqual( 2, log.count() );
+
+  // Functions rewind and next
+  log.rewind();
+  assertEqual( 1, log.next( read, &time, &status ) );
+  makeCode( code, 1 );
+  assertTrue( iButtonTag::equalCode( code, read ) );
+  assertEqual( 1000, time );
+  assertEqual( 1, status );
+  assertEqual( 1, log.next( read, &time, &status ) );
+  makeCode( code, 2 );
+  assertTrue( iButtonTag::equalCode( code, read ) );
+  assertEqual( 1005, time );
+  assertEqual( -3, status );
+  assertEqual( 0, log.next( read, &time ) );
+
+  // Function begin, head recovered after restart
+  iButtonLog restarted( storage );
+  assertTrue( restarted.begin() );
+  assertEqual( 2, restarted.count() );
+
+  // Many records: storage wraps around, oldest records are overwritten
+  for( uint16_t n = 3; n < 100; n++ ) {
+    makeCode( code, n );
+    assertEqual( 1, restarted.append( code, 1000 + 5 * n ) );
+  }
+  restarted.flush();
+  assertEqual( 18, restarted.count() );  // 20 slots, 2 sync records
+
+  // Wear levelling, all headers written equally often
+  uint16_t least = 0xFFFF, most = 0;
+  for( uint16_t i = 0; i < storage.size(); i += IBUTTON_LOG_RECORD ) {
+    if ( storage.writes[i] < least ) least = storage.writes[i];
+    if ( storage.writes[i] > most ) most = storage.writes[i];
+  }
+  assertTrue( most - least <= 1 );
+
+  // Reading back after restart, times of oldest records derived from deltas
+  iButtonLog again( storage );
+  assertTrue( again.begin() );
+  again.rewind();
+  uint16_t records = 0, last = 0;
+  while ( again.next( read, &time ) ) {
+    uint16_t n = read[1] | ( read[2] << 8 );
+    assertTrue( n > last );
+    assertEqual( 1000 + 5 * (uint32_t) n, time );
+    last = n;
+    records++;
+  }
+  assertEqual( 99, last );
+  assertEqual( again.count(), records );
+
+  // Damaged record is skipped
+  again.rewind();
+  again.next( read, &time );
+  uint16_t first = read[1];
+  for( uint16_t i = 0; i < storage.size(); i += IBUTTON_LOG_RECORD ) {
+    if ( storage.data[i + 1] == first ) storage.data[i + 2] ^= 0x40;
+  }
+  again.rewind();
+  again.next( read, &time );
+  assertEqual( first + 1, read[1] );
+  assertEqual( records - 1, again.count() );
+
+}
+
+unittest_main()
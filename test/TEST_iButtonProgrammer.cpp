@@ -0,0 +1,50 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonProgrammer.h>
+
+// Number of results received
+uint8_t results = 0;
+
+void handleResult( uint16_t, const uint8_t*, int8_t ) {
+  results++;
+}
+
+unittest( iButtonProgrammer_basics ) {
+
+  // Codes to write
+  iButtonCode codes[2];
+  for( uint8_t i = 0; i < 2; i++ ) {
+    for( uint8_t j = 0; j < 8; j++ ) codes[i][j] = 10 * j + i + 1;
+    iButtonTag::updateChecksum( codes[i] );
+  }
+
+  // Simulate iButtonTag on PIN 2
+  iButtonTag ibutton( 2 );
+  iButtonProgrammer programmer( ibutton, codes, 2 );
+  programmer.onResult( handleResult );
+
+  // Function poll
+  for( uint8_t i = 0; i < 10; i++ ) {
+    assertEqual( IBUTTON_BUSY, programmer.poll() );   // No iButton detected
+    delay( 10 );
+  }
+  assertEqual( 0, results );
+
+  // Functions written, failed, type and tagsPerMinute
+  assertEqual( 0, programmer.written() );
+  assertEqual( 0, programmer.failed() );
+  assertEqual( IBUTTON_UNKNOWN, programmer.type() );
+  assertEqual( 0, programmer.tagsPerMinute() );
+
+  // Empty batch is finished right away
+  iButtonProgrammer empty( ibutton, codes, 0, false, IBUTTON_RW1990V1 );
+  assertEqual( 1, empty.poll() );
+  assertEqual( IBUTTON_RW1990V1, empty.type() );
+
+}
+
+unittest_main()
@@ -0,0 +1,158 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonStore.h>
+
+// Storage in RAM, counting reads
+class RamStorage : public iButtonStorage {
+
+  public:
+    uint8_t data[608];                                // Header and 100 slots
+    uint32_t reads = 0;
+    uint16_t size() { return sizeof( data ); }
+    uint8_t read( uint16_t a ) { reads++; return data[a]; }
+    void write( uint16_t a, uint8_t b ) { data[a] = b; }
+
+};
+
+// Makes a code with serial number n
+void makeCode( uint8_t* code, uint16_t n ) {
+  for( uint8_t i = 0; i < 8; i++ ) code[i] = 0x00;
+  code[0] = 0x01;
+  code[1] = n & 0xFF;
+  code[2] = n >> 8;
+  iButtonTag::updateChecksum( code );
+}
+
+unittest( iButtonStore_basics ) {
+
+  // Variables
+  RamStorage storage;
+  for( uint16_t i = 0; i < storage.size(); i++ ) storage.data[i] = 0xFF;
+  iButtonCode code;
+
+  iButtonStore store( storage );
+
+  // Functions begin and clear
+  assertFalse( store.begin() );                       // Not formatted
+  store.clear();
+  assertTrue( store.begin() );
+  assertEqual( 75, store.capacity() );
+  assertEqual( 0, store.count() );
+
+  // Function insert
+  for( uint16_t n = 1; n <= 75; n++ ) {
+    makeCode( code, n );
+    assertEqual( 1, store.insert( code ) );
+  }
+  assertEqual( 75, store.count() );
+  makeCode( code, 10 );
+  assertEqual( 0, store.insert( code ) );             // Already present
+  makeCode( code, 76 );
+  assertEqual( -1, store.insert( code ) );            // Full
+  code[0] = 0x08;
+  assertEqual( -2, store.insert( code ) );            // Other family code
+
+  // Function contains, few reads on average even when full
+  storage.reads = 0;
+  for( uint16_t n = 1; n <= 150; n++ ) {
+    makeCode( code, n );
+    assertEqual( n <= 75, store.contains( code ) );
+  }
+  assertTrue( storage.reads / 150 < 6 * 4 );
+
+  // Function remove, tombstones
+  for( uint16_t n = 1; n <= 75; n += 2 ) {
+    makeCode( code, n );
+    assertEqual( 1, store.remove( code ) );
+  }
+  assertEqual( 0, store.remove( code ) );             // Not present anymore
+  assertEqual( 37, store.count() );
+  uint16_t tombstones = store.tombstones();
+  assertTrue( tombstones > 0 );
+
+  // Function begin, counts restored after restart
+  iButtonStore restarted( storage );
+  assertTrue( restarted.begin() );
+  assertEqual( 37, restarted.count() );
+  assertEqual( tombstones, restarted.tombstones() );
+
+  // Function compact
+  restarted.compact();
+  assertEqual( 0, restarted.tombstones() );
+  for( uint16_t n = 1; n <= 150; n++ ) {
+    makeCode( code, n );
+    assertEqual( n <= 75 && n % 2 == 0, restarted.contains( code ) );
+  }
+
+  // Insert reuses tombstones, compacts when needed
+  for( uint16_t n = 101; n <= 138; n++ ) {
+    makeCode( code, n );
+    assertEqual( 1, restarted.insert( code ) );
+    makeCode( code, n - 100 );
+    if ( n % 2 == 0 ) assertEqual( 1, restarted.remove( code ) );
+  }
+  assertEqual( 56, restarted.count() );
+  for( uint16_t n = 1; n <= 150; n++ ) {
+    makeCode( code, n );
+    bool present = ( n > 100 && n <= 138 ) || ( n <= 75 && n % 2 == 0 && n > 38 );
+    assertEqual( present, restarted.contains( code ) );
+  }
+
+}
+
+unittest( iButtonStore_random ) {
+
+  // Variables
+  RamStorage storage;
+  iButtonCode code;
+  const uint16_t keys = 200;
+  bool present[keys];
+
+  // Random inserts, removes and compacts, every code checked against a
+  // reference after every operation
+  for( uint32_t seed = 1; seed <= 8; seed++ ) {
+    iButtonStore store( storage );
+    store.clear();
+    for( uint16_t k = 0; k < keys; k++ ) present[k] = false;
+    uint16_t count = 0;
+    uint32_t x = seed;
+    for( uint16_t op = 0; op < 4000; op++ ) {
+      x = x * 1103515245 + 12345;
+      uint16_t k = ( x >> 8 ) % keys;
+      uint8_t action = ( x >> 24 ) % 20;
+      makeCode( code, k + 1 );
+      if ( action < 11 ) {
+        int8_t result = store.insert( code );
+        if ( result == 1 ) {
+          assertFalse( present[k] );
+          present[k] = true;
+          count++;
+        } else if ( result == 0 ) {
+          assertTrue( present[k] );
+        } else {
+          assertEqual( -1, result );
+          assertEqual( store.capacity(), count );
+        }
+      } else if ( action < 19 ) {
+        assertEqual( present[k] ? 1 : 0, store.remove( code ) );
+        if ( present[k] ) count--;
+        present[k] = false;
+      } else {
+        store.compact();
+        assertEqual( 0, store.tombstones() );
+      }
+      assertEqual( count, store.count() );
+      for( uint16_t n = 0; n < keys; n++ ) {
+        makeCode( code, n + 1 );
+        assertEqual( present[n], store.contains( code ) );
+      }
+    }
+  }
+
+}
+
+unittest_main()
@@ -40,12 +40,40 @@ unittest( iButtonTag_basics ) {
   assertEqual( 0, ibutton.nextCode( code ) );         // No iButton detected
   assertTrue( ibutton.equalCode( code, codezero ) );
 
+  // Function verifyPresent
+  assertEqual( 0, ibutton.verifyPresent( codecrc ) ); // No iButton detected
+  bool present[1] = { true };
+  iButtonCode known[1];
+  for( uint8_t i = 0; i < 8; i++ ) known[0][i] = codecrc[i];
+  assertEqual( 0, ibutton.verifyPresent( known, 1, present ) );
+  assertFalse( present[0] );
+
   // Function testCode
   assertEqual( -2, ibutton.testCode( code ) );        // Invalid code, all zeros
   assertEqual( -2, ibutton.testCode( codezero ) );    // Invalid code, all zeros
   assertEqual( -1, ibutton.testCode( codecrcfail ) ); // Invalid code, CRC failed
   assertEqual( 1, ibutton.testCode( codecrc ) );      // Valid code
 
+  // Function testCodes
+  iButtonCode codes[3];
+  int8_t results[3];
+  for( uint8_t i = 0; i < 8; i++ ) {
+    codes[0][i] = codecrc[i];
+    codes[1][i] = codezero[i];
+    codes[2][i] = codecrcfail[i];
+  }
+  assertEqual( 1, ibutton.testCodes( codes, 3, results ) );
+  assertEqual( 1, results[0] );                       // Valid code
+  assertEqual( -2, results[1] );                      // Invalid code, all zeros
+  assertEqual( -1, results[2] );                      // Invalid code, CRC failed
+  assertEqual( 1, ibutton.testCodes( codes, 3 ) );    // Without results
+  assertEqual( 0, ibutton.testCodes( codes + 1, 2, results ) );
+
+  // Function crc8
+  assertEqual( OneWire::crc8( codecrc, 7 ), ibutton.crc8( codecrc, 7 ) );
+  assertEqual( OneWire::crc8( codecrc, 8 ), ibutton.crc8( codecrc, 8 ) );
+  assertEqual( 0, ibutton.crc8( codecrc, 0 ) );
+
   // Function equalCode
   assertFalse( ibutton.equalCode( codezero, codecrc ) );
   assertFalse( ibutton.equalCode( codezero, codecrcfail ) );
@@ -82,6 +110,33 @@ unittest( iButtonTag_basics ) {
   ibutton.printCode( codecrcfail, true );
   assertEqual( "47 3D 33 29 1F 15 0B 01", state -> serialPort[0].dataOut );
 
+  state -> serialPort[0].dataOut = "";
+  ibutton.printCode( codecrc, true, Serial );
+  assertEqual( "E8 3D 33 29 1F 15 0B 01", state -> serialPort[0].dataOut );
+
+  // Function formatCode
+  char text[IBUTTON_CODE_TEXT];
+  assertEqual( "01 0B 15 1F 29 33 3D E8", ibutton.formatCode( codecrc, text ) );
+  assertEqual( "E8 3D 33 29 1F 15 0B 01", ibutton.formatCode( codecrc, text, true ) );
+  assertEqual( "00 00 00 00 00 00 00 00", ibutton.formatCode( codezero, text ) );
+
+  // Function parseCode
+  uint8_t parsed[8];
+  assertEqual( 1, ibutton.parseCode( "01 0B 15 1F 29 33 3D E8", parsed ) );
+  assertTrue( ibutton.equalCode( codecrc, parsed ) );
+  assertEqual( 1, ibutton.parseCode( "e8:3d:33:29:1f:15:0b:01", parsed, true ) );
+  assertTrue( ibutton.equalCode( codecrc, parsed ) );
+  assertEqual( 1, ibutton.parseCode( "010B151F29333DE8", parsed ) );
+  assertEqual( -1, ibutton.parseCode( "01-0B-15-1F-29-33-3D-47", parsed ) );
+  assertTrue( ibutton.equalCode( codecrcfail, parsed ) );
+  assertEqual( -2, ibutton.parseCode( "00 00 00 00 00 00 00 00", parsed ) );
+  assertEqual( 0, ibutton.parseCode( "01 0B 15 1F 29 33 3D", parsed ) );
+  assertEqual( 0, ibutton.parseCode( "01 0B 15 1F 29 33 3D E8 ", parsed ) );
+  assertEqual( 0, ibutton.parseCode( "01 0B 15 1F 29 33 3D EG", parsed ) );
+  assertEqual( 0, ibutton.parseCode( "01  0B 15 1F 29 33 3D E8", parsed ) );
+  assertEqual( 0, ibutton.parseCode( "", parsed ) );
+  assertTrue( ibutton.equalCode( codezero, parsed ) );    // Unchanged on failure
+
   // Function detectWritableType
   assertEqual( -1, ibutton.detectWritableType() );
 
@@ -102,6 +157,34 @@ unittest( iButtonTag_basics ) {
   assertEqual(   0, ibutton.writeCode( codecrcfail, IBUTTON_TM01, false ) );
   assertEqual( -11, ibutton.writeCode( codecrcfail, IBUTTON_MAXWRITABLE + 1, false ) );
 
+  // Functions beginWrite, pollWrite and writeProgress
+  assertEqual( IBUTTON_BUSY, ibutton.beginWrite( codecrc ) );
+  int8_t status = IBUTTON_BUSY;
+  for( uint8_t i = 0; i < 10 && status == IBUTTON_BUSY; i++ ) {
+    status = ibutton.pollWrite();
+  }
+  assertEqual(   0, status );                         // No iButton detected
+  assertEqual(   0, ibutton.pollWrite() );            // Status remains
+  assertEqual( 100, ibutton.writeProgress() );
+  assertEqual(  -1, ibutton.beginWrite( codecrcfail ) );
+  assertEqual(  -2, ibutton.beginWrite( codezero ) );
+  assertEqual( -11, ibutton.beginWrite( codecrc, IBUTTON_MAXWRITABLE + 1 ) );
+  assertEqual( -11, ibutton.beginWrite( codecrc, -1 ) );
+
+  // Functions calibrateWriteDelay, setWriteDelay and writeDelay
+  assertEqual(   0, ibutton.calibrateWriteDelay() );  // No iButton detected
+  assertEqual( -11, ibutton.calibrateWriteDelay( IBUTTON_MAXWRITABLE + 1 ) );
+  assertEqual( 10000, ibutton.writeDelay( IBUTTON_RW1990V1 ) );
+  assertEqual( 50000, ibutton.writeDelay( IBUTTON_RW2004 ) );
+  assertEqual(   1, ibutton.setWriteDelay( IBUTTON_TM01, 5000 ) );
+  assertEqual( 5000, ibutton.writeDelay( IBUTTON_TM01 ) );
+  assertEqual( -11, ibutton.setWriteDelay( IBUTTON_UNKNOWN, 5000 ) );
+  assertEqual(   0, ibutton.writeDelay( IBUTTON_UNKNOWN ) );
+
+  // Function clearTypeCache
+  ibutton.clearTypeCache();
+  assertEqual(  -1, ibutton.detectWritableType() );  // No iButton detected
+
   // Function updateChecksum - last because it changes codecrcfail
   ibutton.updateChecksum( codecrcfail );
   assertTrue( ibutton.equalCode( codecrc, codecrcfail ) );
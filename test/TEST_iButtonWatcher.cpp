@@ -0,0 +1,40 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonWatcher.h>
+
+// Number of events received
+uint8_t events = 0;
+
+void handleEvent( const uint8_t*, int8_t ) {
+  events++;
+}
+
+unittest( iButtonWatcher_basics ) {
+
+  // Simulate iButtonTag on PIN 2
+  iButtonTag ibutton( 2 );
+  iButtonWatcher watcher( ibutton );
+  watcher.onArrive( handleEvent );
+  watcher.onDepart( handleEvent );
+  watcher.onInvalid( handleEvent );
+
+  // Function checkPresence
+  assertEqual( 0, ibutton.checkPresence() );          // No iButton detected
+
+  // Function poll
+  for( uint8_t i = 0; i < 10; i++ ) {
+    watcher.poll();
+    delay( 10 );
+  }
+  assertEqual( 0, events );                           // No iButton detected
+
+  // Function isPresent
+  assertFalse( watcher.isPresent() );
+
+}
+
+unittest_main()
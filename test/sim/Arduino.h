@@ -0,0 +1,99 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Host stand-in for the Arduino core, just enough to build the library on
+ * Linux against the simulated 1-Wire bus. Time is virtual: it only advances
+ * when the library waits or uses the bus.
+ */
+
+
+#ifndef Arduino_h
+#define Arduino_h
+
+// Includes
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+// Flash memory is ordinary memory on the host
+#define PROGMEM
+#define pgm_read_byte( p ) ( *(const uint8_t*) ( p ) )
+#define pgm_read_word( p ) ( *(const uint16_t*) ( p ) )
+
+// Number formats for Print
+#define HEX 16
+#define DEC 10
+
+// Interrupts don't exist on the host
+#define noInterrupts()
+#define interrupts()
+
+// Virtual time
+unsigned long millis();
+unsigned long micros();
+void delay( unsigned long );
+void delayMicroseconds( unsigned int );
+inline void yield() {}
+
+// Print, output captured in a string
+class Print {
+
+  public:
+    virtual ~Print() {}
+    virtual size_t write( uint8_t c ) { output += (char) c; return 1; }
+    virtual size_t write( const uint8_t* buffer, size_t size ) {
+      for ( size_t i = 0; i < size; i++ ) write( buffer[i] );
+      return size;
+    }
+    size_t write( const char* s ) { return write( (const uint8_t*) s, strlen( s ) ); }
+
+    size_t print( const char* );
+    size_t print( char );
+    size_t print( unsigned long, int = DEC );
+    size_t print( long, int = DEC );
+    size_t print( unsigned int n, int base = DEC ) { return print( (unsigned long) n, base ); }
+    size_t print( int n, int base = DEC ) { return print( (long) n, base ); }
+    size_t print( unsigned char n, int base = DEC ) { return print( (unsigned long) n, base ); }
+    size_t println() { return print( "\r\n" ); }
+    template <typename T> size_t println( T v ) { return print( v ) + println(); }
+    template <typename T> size_t println( T v, int b ) { return print( v, b ) + println(); }
+
+    std::string output;
+
+};
+
+// Stream, input fed from a string
+class Stream : public Print {
+
+  public:
+    virtual int available() { return (int) input.size(); }
+    virtual int read() {
+      if ( input.empty() ) return -1;
+      int c = (uint8_t) input[0];
+      input.erase( 0, 1 );
+      return c;
+    }
+    virtual int peek() { return input.empty() ? -1 : (uint8_t) input[0]; }
+
+    std::string input;
+
+};
+
+// Serial port, virtual begin so a simulated port can follow baud rate changes
+class HardwareSerial : public Stream {
+
+  public:
+    virtual void begin( unsigned long baud ) { this -> baud = baud; }
+    void end() {}
+    void flush() {}
+
+    unsigned long baud = 0;
+
+};
+extern HardwareSerial Serial;
+
+#endif // Arduino_h
@@ -0,0 +1,53 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Host stand-in for the arduino_ci unit test macros, so tests for the simulated
+ * bus are written the same way as the other tests.
+ */
+
+
+#ifndef ArduinoUnitTests_h
+#define ArduinoUnitTests_h
+
+// Includes
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+
+// Registered tests and number of failed assertions
+struct UnitTest { const char* name; void ( *run )(); };
+inline std::vector<UnitTest>& unitTests() { static std::vector<UnitTest> t; return t; }
+inline int& unitTestFailures() { static int f = 0; return f; }
+
+#define unittest( name ) \
+  static void unittest_##name(); \
+  static int unittest_reg_##name = \
+    ( unitTests().push_back( { #name, unittest_##name } ), 0 ); \
+  static void unittest_##name()
+
+#define assertEqual( expected, actual ) do { \
+    if ( !( ( expected ) == ( actual ) ) ) { \
+      printf( "  FAIL %s:%d: %s == %s\n", __FILE__, __LINE__, #expected, #actual ); \
+      unitTestFailures()++; \
+    } \
+  } while ( 0 )
+#define assertNotEqual( a, b ) assertFalse( ( a ) == ( b ) )
+#define assertTrue( a ) assertEqual( true, (bool) ( a ) )
+#define assertFalse( a ) assertEqual( false, (bool) ( a ) )
+#define assertLess( a, b ) assertTrue( ( a ) < ( b ) )
+#define assertMore( a, b ) assertTrue( ( a ) > ( b ) )
+
+#define unittest_main() \
+  int main() { \
+    for ( const UnitTest& t : unitTests() ) { \
+      int before = unitTestFailures(); \
+      t.run(); \
+      printf( "%s %s\n", unitTestFailures() == before ? "PASS" : "FAIL", t.name ); \
+    } \
+    return unitTestFailures() == 0 ? 0 : 1; \
+  }
+
+#endif // ArduinoUnitTests_h
@@ -0,0 +1,89 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Throughput benchmark of the reader service on Linux against the simulated
+ * 1-Wire bus.
+ *
+ * Every reader has a bus of its own with one iButton on the probe, reads
+ * without waiting and reports every read. The main thread drains the events
+ * for a fixed host time. Results are events per second of host time, and
+ * events dropped per second, as the number of readers grows: the bus is
+ * simulated, so this measures the library and the queues, not 1-Wire timing.
+ *
+ * Output is CSV, one result per line, header printed by the Makefile:
+ *   version,benchmark,metric,value
+ */
+
+
+#include <iButtonService.h>
+#include "iButtonSim.h"
+#include <stdio.h>
+#include <chrono>
+
+#ifndef IBUTTON_VERSION
+#define IBUTTON_VERSION "unknown"
+#endif
+
+// Pin of simulated bus of first reader
+#define PIN_SIM 40
+
+// Host time per measurement, in milliseconds
+#define RUN_MS 500
+
+// Prints one result line
+static void result( const char* benchmark, const char* metric, double value ) {
+  printf( "%s,%s,%s,%.2f\n", IBUTTON_VERSION, benchmark, metric, value );
+}
+
+static void benchReaders( uint8_t readers ) {
+  iButtonSimDevice* tags[IBUTTON_SERVICE_READERS];
+  iButtonTag* tag[IBUTTON_SERVICE_READERS];
+  iButtonService service( 0 );
+  for ( uint8_t i = 0; i < readers; i++ ) {
+    uint8_t code[8] = { 0x01, i, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x00 };
+    iButtonTag::updateChecksum( code );
+    iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM + i );
+    bus.clear();
+    tags[i] = new iButtonSimDevice( code );
+    bus.attach( tags[i] );
+    tag[i] = new iButtonTag( PIN_SIM + i );
+    service.addReader( *tag[i] );
+  }
+  service.reportReads( true );
+
+  uint64_t events = 0;
+  iButtonEvent event;
+  service.start();
+  auto start = std::chrono::steady_clock::now();
+  auto end = start + std::chrono::milliseconds( RUN_MS );
+  while ( std::chrono::steady_clock::now() < end ) {
+    while ( service.poll( event ) ) events++;
+    std::this_thread::yield();        // Queues empty, leave the host to readers
+  }
+  service.stop();
+  while ( service.poll( event ) ) events++;
+  double seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start ).count();
+
+  char name[32];
+  snprintf( name, sizeof( name ), "Service_readers_%u", readers );
+  result( name, "events_per_s", events / seconds );
+  result( name, "dropped_per_s", service.dropped() / seconds );
+
+  for ( uint8_t i = 0; i < readers; i++ ) {
+    iButtonSimBus::onPin( PIN_SIM + i ).clear();
+    delete tag[i];
+    delete tags[i];
+  }
+}
+
+int main() {
+  static const uint8_t counts[] = { 1, 2, 4, 8 };
+  for ( uint8_t c = 0; c < sizeof( counts ); c++ ) {
+    if ( counts[c] <= IBUTTON_SERVICE_READERS ) benchReaders( counts[c] );
+  }
+  return 0;
+}
@@ -0,0 +1,268 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Benchmarks of the library on Linux against the simulated 1-Wire bus.
+ *
+ * Pure functions are timed on the host, in nanoseconds per call. Functions
+ * using the bus are measured in simulated bus time, in microseconds per call,
+ * and in resets and time slots: these don't depend on the host and only
+ * change when the library changes the way it uses the bus.
+ *
+ * Output is CSV, one result per line, header printed by the Makefile:
+ *   version,benchmark,metric,value
+ * Compare the output of two releases with for example `join` or a spreadsheet.
+ */
+
+
+#include <iButtonTag.h>
+#include <iButtonCodeSet.h>
+#include <iButtonEnumerator.h>
+#include <iButtonMemory.h>
+#include <iButtonTagGroup.h>
+#include "iButtonSim.h"
+#include "iButtonSimGroup.h"
+#include <stdio.h>
+#include <chrono>
+
+#ifndef IBUTTON_VERSION
+#define IBUTTON_VERSION "unknown"
+#endif
+
+// Pin of simulated bus
+#define PIN_SIM 3
+
+// Number of codes the pure functions cycle through
+#define CODES 64
+
+// Minimum host time per benchmark of a pure function, in nanoseconds
+#define MIN_NS 200000000LL
+
+static iButtonCode codes[CODES];
+static char texts[CODES][IBUTTON_CODE_TEXT];
+
+// Results end up here, so the compiler can't leave out the calls
+static volatile uint32_t sink;
+
+// Prints one result line
+static void result( const char* benchmark, const char* metric, double value ) {
+  printf( "%s,%s,%s,%.2f\n", IBUTTON_VERSION, benchmark, metric, value );
+}
+
+// Times a pure function on the host: runs it in rounds of CODES calls, doubling
+// the rounds until the minimum time is reached
+template <typename F>
+static void timePure( const char* benchmark, F f ) {
+  uint32_t rounds = 1;
+  for ( ;; ) {
+    uint32_t acc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for ( uint32_t r = 0; r < rounds; r++ ) {
+      for ( uint8_t i = 0; i < CODES; i++ ) acc += f( i );
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink = acc;
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count();
+    if ( ns >= MIN_NS || rounds >= ( 1UL << 30 ) ) {
+      result( benchmark, "ns_per_op", (double) ns / ( (double) rounds * CODES ) );
+      return;
+    }
+    rounds *= 2;
+  }
+}
+
+// Measures a function using the bus: simulated time, resets and slots per call
+template <typename F>
+static void timeBus( const char* benchmark, uint16_t calls, F f ) {
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.resetCounters();
+  uint32_t start = iButtonSimBus::now;
+  for ( uint16_t i = 0; i < calls; i++ ) f( i );
+  uint32_t time = iButtonSimBus::now - start;
+  result( benchmark, "bus_us_per_op", (double) time / calls );
+  result( benchmark, "resets_per_op", (double) bus.resets / calls );
+  result( benchmark, "slots_per_op", (double) bus.slots / calls );
+}
+
+// Fills the table of codes: mixed families, valid checksums
+static void makeCodes() {
+  uint32_t x = 0x12345678;
+  for ( uint8_t i = 0; i < CODES; i++ ) {
+    for ( uint8_t j = 0; j < 7; j++ ) {
+      x = x * 1103515245 + 12345;
+      codes[i][j] = x >> 24;
+    }
+    codes[i][0] = i & 1 ? 0x01 : 0x08;
+    iButtonTag::updateChecksum( codes[i] );
+    iButtonTag::formatCode( codes[i], texts[i] );
+  }
+}
+
+static void benchPure() {
+  timePure( "testCode", []( uint8_t i ) {
+    return (uint32_t) iButtonTag::testCode( codes[i] );
+  } );
+  timePure( "equalCode_same", []( uint8_t i ) {
+    return (uint32_t) iButtonTag::equalCode( codes[i], codes[i] );
+  } );
+  timePure( "equalCode_other", []( uint8_t i ) {
+    return (uint32_t) iButtonTag::equalCode( codes[i], codes[( i + 1 ) % CODES] );
+  } );
+  timePure( "crc8", []( uint8_t i ) {
+    return (uint32_t) iButtonTag::crc8( codes[i], 7 );
+  } );
+  timePure( "updateChecksum", []( uint8_t i ) {
+    iButtonTag::updateChecksum( codes[i] );
+    return (uint32_t) codes[i][7];
+  } );
+  timePure( "formatCode", []( uint8_t i ) {
+    char text[IBUTTON_CODE_TEXT];
+    iButtonTag::formatCode( codes[i], text );
+    return (uint32_t) text[0];
+  } );
+  timePure( "parseCode", []( uint8_t i ) {
+    iButtonCode code;
+    return (uint32_t) iButtonTag::parseCode( texts[i], code );
+  } );
+
+  // Lookups in a set of all codes, half of them present
+  static iButtonCode sorted[CODES / 2];
+  for ( uint8_t i = 0; i < CODES / 2; i++ ) {
+    for ( uint8_t j = 0; j < 8; j++ ) sorted[i][j] = codes[i * 2][j];
+  }
+  iButtonCodeSet::sortCodes( sorted, CODES / 2 );
+  static iButtonCodeSet set( sorted, CODES / 2 );
+  set.buildIndex();
+  timePure( "CodeSet_contains", []( uint8_t i ) {
+    return (uint32_t) set.contains( codes[i] );
+  } );
+}
+
+static void benchBus() {
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+
+  // Function readCode, one iButton on the probe
+  bus.clear();
+  iButtonSimDevice tag( codes[0] );
+  bus.attach( &tag );
+  timeBus( "readCode", 100, [&]( uint16_t ) { ibutton.readCode( code ); } );
+
+  // Function readCode, nothing on the probe
+  bus.clear();
+  timeBus( "readCode_empty", 100, [&]( uint16_t ) { ibutton.readCode( code ); } );
+
+  // Functions readCodes and nextCode, a sweep over all iButtons on the line
+  static const uint8_t sizes[] = { 1, 4, 16 };
+  for ( uint8_t s = 0; s < sizeof( sizes ); s++ ) {
+    bus.clear();
+    iButtonSimDevice* tags[16];
+    for ( uint8_t i = 0; i < sizes[s]; i++ ) {
+      tags[i] = new iButtonSimDevice( codes[i] );
+      bus.attach( tags[i] );
+    }
+    char name[24];
+    snprintf( name, sizeof( name ), "nextCode_sweep_%u", sizes[s] );
+    timeBus( name, 20, [&]( uint16_t ) {
+      if ( ibutton.readCodes() == 0 ) return;
+      while ( ibutton.nextCode( code ) != 0 ) {}
+    } );
+
+    // Class iButtonEnumerator, a scan of a complete cycle: nothing changed, and
+    // one iButton departing or arriving every scan
+    iButtonCode known[16];
+    iButtonEnumerator enumerator( ibutton, known, 16, 1000000 );
+    enumerator.scan();
+    snprintf( name, sizeof( name ), "Enumerator_scan_%u", sizes[s] );
+    timeBus( name, 20, [&]( uint16_t ) { enumerator.scan(); } );
+    snprintf( name, sizeof( name ), "Enumerator_change_%u", sizes[s] );
+    timeBus( name, 20, [&]( uint16_t ) {
+      tags[0] -> touching = !tags[0] -> touching;
+      enumerator.scan();
+    } );
+    bus.clear();
+    for ( uint8_t i = 0; i < sizes[s]; i++ ) delete tags[i];
+  }
+
+  // Functions detectWritableType and writeCode, every writable type
+  static const char* names[] = { "RW1990V1", "RW1990V2", "RW2004", "TM01" };
+  for ( int8_t type = IBUTTON_RW1990V1; type <= IBUTTON_MAXWRITABLE; type++ ) {
+    iButtonSimRW1990 rw1990( codes[0], type );
+    iButtonSimRW2004 rw2004( codes[0] );
+    bus.clear();
+    bus.attach( type == IBUTTON_RW2004 ? (iButtonSimDevice*) &rw2004 : &rw1990 );
+    char name[40];
+    if ( type != IBUTTON_TM01 ) {  // Can't be detected
+      snprintf( name, sizeof( name ), "detectWritableType_%s", names[type - 1] );
+      timeBus( name, 5, [&]( uint16_t ) {
+        ibutton.clearTypeCache();
+        ibutton.detectWritableType();
+      } );
+    }
+    snprintf( name, sizeof( name ), "writeCode_%s", names[type - 1] );
+    timeBus( name, 5, [&]( uint16_t i ) {
+      ibutton.writeCode( codes[1 + ( i & 1 )], type );
+    } );
+  }
+
+  // Memory of a DS1996: bus time per KiB streamed, and written through the
+  // scratchpad
+  uint8_t ds1996[8] = { 0x0C, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x00 };
+  iButtonTag::updateChecksum( ds1996 );
+  iButtonSimMemory nvram( ds1996, 8192 );
+  bus.clear();
+  bus.attach( &nvram );
+  iButtonMemory memory( ibutton, ds1996 );
+  memory.read( 0, 8192, []( uint16_t, const uint8_t* data, uint8_t ) {
+    sink += data[0];
+    return true;
+  } );
+  result( "Memory_read", "bus_us_per_kib", memory.busTimePerKiB() );
+  static uint8_t data[1024];
+  memory.write( 0, data, sizeof( data ) );
+  result( "Memory_write", "bus_us_per_kib", memory.busTimePerKiB() );
+  bus.clear();
+
+  // Class iButtonTagGroup: a code from every probe of a port at once, against
+  // readCode on the probes one after the other
+  static const uint8_t pins[IBUTTON_GROUP_MAX] = { 40, 41, 42, 43, 44, 45, 46, 47 };
+  iButtonSimDevice* tags[IBUTTON_GROUP_MAX];
+  for ( uint8_t i = 0; i < IBUTTON_GROUP_MAX; i++ ) {
+    tags[i] = new iButtonSimDevice( codes[i] );
+    iButtonSimBus::onPin( pins[i] ).attach( tags[i] );
+  }
+  iButtonCode read[IBUTTON_GROUP_MAX];
+  int8_t statuses[IBUTTON_GROUP_MAX];
+  static const uint8_t lines[] = { 1, 8 };
+  for ( uint8_t l = 0; l < sizeof( lines ); l++ ) {
+    iButtonSimGroup wire( pins, lines[l] );
+    iButtonTagGroup group( wire, lines[l] );
+    char name[32];
+    snprintf( name, sizeof( name ), "Group_readCode_%u", lines[l] );
+    uint32_t start = iButtonSimBus::now;
+    for ( uint8_t c = 0; c < 100; c++ ) group.readCode( read, statuses );
+    result( name, "bus_us_per_op", ( iButtonSimBus::now - start ) / 100.0 );
+  }
+  uint32_t start = iButtonSimBus::now;
+  for ( uint8_t c = 0; c < 100; c++ ) {
+    for ( uint8_t i = 0; i < IBUTTON_GROUP_MAX; i++ ) {
+      iButtonTag probe( pins[i] );
+      probe.readCode( read[i] );
+    }
+  }
+  result( "readCode_sequential_8", "bus_us_per_op", ( iButtonSimBus::now - start ) / 100.0 );
+  for ( uint8_t i = 0; i < IBUTTON_GROUP_MAX; i++ ) {
+    iButtonSimBus::onPin( pins[i] ).clear();
+    delete tags[i];
+  }
+}
+
+int main() {
+  makeCodes();
+  benchPure();
+  benchBus();
+  return 0;
+}
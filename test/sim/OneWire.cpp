@@ -0,0 +1,97 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include "OneWire.h"
+
+void OneWire::write( uint8_t v, uint8_t /* power */ ) {
+  for ( uint8_t mask = 0x01; mask; mask <<= 1 ) write_bit( ( v & mask ) ? 1 : 0 );
+}
+
+void OneWire::write_bytes( const uint8_t* buffer, uint16_t count, bool power ) {
+  for ( uint16_t i = 0; i < count; i++ ) write( buffer[i], power );
+}
+
+uint8_t OneWire::read() {
+  uint8_t r = 0;
+  for ( uint8_t mask = 0x01; mask; mask <<= 1 ) if ( read_bit() ) r |= mask;
+  return r;
+}
+
+void OneWire::read_bytes( uint8_t* buffer, uint16_t count ) {
+  for ( uint16_t i = 0; i < count; i++ ) buffer[i] = read();
+}
+
+void OneWire::select( const uint8_t* rom ) {
+  write( 0x55 );
+  for ( uint8_t i = 0; i < 8; i++ ) write( rom[i] );
+}
+
+void OneWire::reset_search() {
+  _lastDiscrepancy = 0;
+  _lastFamilyDiscrepancy = 0;
+  _lastDevice = false;
+  for ( uint8_t i = 0; i < 8; i++ ) _rom[i] = 0;
+}
+
+void OneWire::target_search( uint8_t family ) {
+  reset_search();
+  _rom[0] = family;
+  _lastDiscrepancy = 64;
+}
+
+// Search algorithm of Maxim application note 187, as in OneWire
+bool OneWire::search( uint8_t* newAddr, bool search_mode ) {
+  if ( _lastDevice ) return false;
+  if ( !reset() ) {
+    reset_search();
+    return false;
+  }
+  write( search_mode ? 0xF0 : 0xEC );
+
+  uint8_t lastZero = 0;
+  for ( uint8_t id = 1; id <= 64; id++ ) {
+    uint8_t byte = ( id - 1 ) >> 3;
+    uint8_t mask = 1 << ( ( id - 1 ) & 7 );
+    uint8_t bit = read_bit();
+    uint8_t cmp = read_bit();
+    if ( bit && cmp ) {            // No devices participating
+      reset_search();
+      return false;
+    }
+    uint8_t direction;
+    if ( bit != cmp ) {
+      direction = bit;
+    } else {                       // Discrepancy
+      if ( id < _lastDiscrepancy ) direction = ( _rom[byte] & mask ) ? 1 : 0;
+      else direction = id == _lastDiscrepancy;
+      if ( direction == 0 ) {
+        lastZero = id;
+        if ( lastZero < 9 ) _lastFamilyDiscrepancy = lastZero;
+      }
+    }
+    if ( direction ) _rom[byte] |= mask;
+    else _rom[byte] &= ~mask;
+    write_bit( direction );
+  }
+
+  _lastDiscrepancy = lastZero;
+  if ( _lastDiscrepancy == 0 ) _lastDevice = true;
+  for ( uint8_t i = 0; i < 8; i++ ) newAddr[i] = _rom[i];
+  return true;
+}
+
+uint8_t OneWire::crc8( const uint8_t* data, uint8_t length ) {
+  uint8_t crc = 0;
+  while ( length-- ) {
+    uint8_t b = *data++;
+    for ( uint8_t i = 0; i < 8; i++ ) {
+      uint8_t mix = ( crc ^ b ) & 0x01;
+      crc >>= 1;
+      if ( mix ) crc ^= 0x8C;
+      b >>= 1;
+    }
+  }
+  return crc;
+}
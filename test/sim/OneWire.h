@@ -0,0 +1,56 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Host stand-in for the OneWire library, with the same interface as used by
+ * iButtonTag. All bus operations go to the simulated bus on the pin.
+ */
+
+
+#ifndef OneWire_h
+#define OneWire_h
+
+// Includes
+#include <Arduino.h>
+#include "iButtonSim.h"
+
+// Class definition
+class OneWire {
+
+  public:
+    OneWire() : _bus( 0 ) { reset_search(); }
+    OneWire( uint8_t pin ) { begin( pin ); }
+    void begin( uint8_t pin ) { _bus = &iButtonSimBus::onPin( pin ); reset_search(); }
+
+    // Bus operations
+    uint8_t reset() { return _bus -> reset(); }
+    void write_bit( uint8_t v ) { _bus -> slot( v & 1 ); }
+    uint8_t read_bit() { return _bus -> slot( 1 ); }
+    void write( uint8_t, uint8_t = 0 );
+    void write_bytes( const uint8_t*, uint16_t, bool = 0 );
+    uint8_t read();
+    void read_bytes( uint8_t*, uint16_t );
+    void select( const uint8_t* );
+    void skip() { write( 0xCC ); }
+    void depower() {}
+
+    // Search
+    void reset_search();
+    void target_search( uint8_t );
+    bool search( uint8_t*, bool = true );
+
+    // Checksums
+    static uint8_t crc8( const uint8_t*, uint8_t );
+
+  private:
+    iButtonSimBus* _bus;
+    uint8_t _rom[8];
+    uint8_t _lastDiscrepancy;
+    uint8_t _lastFamilyDiscrepancy;
+    bool _lastDevice;
+
+};
+
+#endif // OneWire_h
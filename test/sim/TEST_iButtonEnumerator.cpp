@@ -0,0 +1,223 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonEnumerator.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 7
+
+// Number of simulated tags
+#define TAGS 8
+
+// Codes of simulated tags: family 0x01, the last two family 0x28
+static uint8_t codes[TAGS][8];
+
+static void makeCodes() {
+  for ( uint8_t t = 0; t < TAGS; t++ ) {
+    codes[t][0] = t < TAGS - 2 ? 0x01 : 0x28;
+    for ( uint8_t i = 1; i < 7; i++ ) codes[t][i] = ( t * 37 + i * 11 ) & 0xFF;
+    iButtonTag::updateChecksum( codes[t] );
+  }
+}
+
+// Events received
+static uint8_t arrived, departed;
+static uint8_t lastDeparted[8];
+
+static void handleArrive( const uint8_t*, int8_t status ) {
+  if ( status == 1 ) arrived++;
+}
+static void handleDepart( const uint8_t* code, int8_t ) {
+  departed++;
+  for ( uint8_t i = 0; i < 8; i++ ) lastDeparted[i] = code[i];
+}
+
+// Scans until a cycle is complete, returns the number of scans
+static uint16_t runCycle( iButtonEnumerator& enumerator ) {
+  uint16_t cycles = enumerator.cycles();
+  uint16_t scans = 0;
+  while ( enumerator.cycles() == cycles && scans < 1000 ) {
+    enumerator.scan();
+    scans++;
+  }
+  return scans;
+}
+
+unittest( iButtonEnumerator_events ) {
+
+  makeCodes();
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice a( codes[0] ), b( codes[1] ), c( codes[6] );
+  bus.attach( &a );
+  bus.attach( &b );
+  bus.attach( &c );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode known[4];
+  iButtonEnumerator enumerator( ibutton, known, 4, 1000000 );
+  enumerator.onArrive( handleArrive );
+  enumerator.onDepart( handleDepart );
+  arrived = departed = 0;
+
+  // All iButtons arrive in a single scan with a large budget
+  assertEqual( 3, enumerator.scan() );
+  assertEqual( 3, arrived );
+  assertEqual( 3, enumerator.count() );
+  assertEqual( 1, enumerator.cycles() );
+  assertTrue( enumerator.isPresent( codes[6] ) );
+
+  // Nothing changed: no events, one search pass per iButton
+  bus.resetCounters();
+  assertEqual( 0, enumerator.scan() );
+  assertEqual( 3, bus.resets );
+  assertEqual( 3 * 200, bus.slots );
+
+  // Departure reported once, dropped in the passes for the others instead of
+  // verified with a search of its own
+  b.touching = false;
+  bus.resetCounters();
+  assertEqual( 1, enumerator.scan() );
+  assertEqual( 2, bus.resets );
+  assertEqual( 2 * 200, bus.slots );
+  assertEqual( 1, departed );
+  assertTrue( iButtonTag::equalCode( lastDeparted, codes[1] ) );
+  assertFalse( enumerator.isPresent( codes[1] ) );
+  assertEqual( 0, enumerator.scan() );
+
+  // Arrival
+  b.touching = true;
+  assertEqual( 1, enumerator.scan() );
+  assertEqual( 4, arrived );
+
+  // Everything gone: all depart after a single reset
+  a.touching = b.touching = c.touching = false;
+  bus.resetCounters();
+  assertEqual( 3, enumerator.scan() );
+  assertEqual( 4, departed );
+  assertEqual( 0, enumerator.count() );
+  assertEqual( 1, bus.resets );
+  assertEqual( 0, bus.slots );
+
+  // Full: iButtons beyond capacity not kept
+  bus.clear();
+  iButtonSimDevice* tags[TAGS];
+  for ( uint8_t t = 0; t < TAGS; t++ ) {
+    tags[t] = new iButtonSimDevice( codes[t] );
+    bus.attach( tags[t] );
+  }
+  assertEqual( 4, enumerator.scan() );
+  assertEqual( 4, enumerator.count() );
+  assertEqual( 0, enumerator.scan() );
+
+  bus.clear();
+  for ( uint8_t t = 0; t < TAGS; t++ ) delete tags[t];
+
+}
+
+unittest( iButtonEnumerator_budget ) {
+
+  makeCodes();
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice* tags[TAGS];
+  for ( uint8_t t = 0; t < TAGS; t++ ) {
+    tags[t] = new iButtonSimDevice( codes[t] );
+    bus.attach( tags[t] );
+  }
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode known[TAGS];
+  iButtonEnumerator enumerator( ibutton, known, TAGS, 20000 );
+  enumerator.onArrive( handleArrive );
+  enumerator.onDepart( handleDepart );
+  arrived = departed = 0;
+
+  // Bus time of a single search for one iButton, the longest step
+  iButtonCode code;
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 1, ibutton.readCodes() );
+  assertEqual( 1, ibutton.nextCode( code ) );
+  uint32_t step = iButtonSimBus::now - start;
+
+  // Cycle spread over scans, each within budget plus one step
+  uint16_t scans = 0;
+  uint32_t longest = 0;
+  while ( enumerator.cycles() == 0 ) {
+    start = iButtonSimBus::now;
+    enumerator.scan();
+    uint32_t time = iButtonSimBus::now - start;
+    if ( time > longest ) longest = time;
+    scans++;
+  }
+  assertTrue( scans > 2 );
+  assertTrue( longest < 20000 + step );
+  assertEqual( TAGS, arrived );
+
+  // Departure while the search is resumed scan by scan: no other iButton
+  // departs, the departed one is verified
+  enumerator.scan();
+  tags[3] -> touching = false;
+  runCycle( enumerator );
+  runCycle( enumerator );
+  assertEqual( 1, departed );
+  assertTrue( iButtonTag::equalCode( lastDeparted, codes[3] ) );
+  assertEqual( TAGS - 1, enumerator.count() );
+
+  // Family targeted: only iButtons of the family, in less bus time
+  bus.resetCounters();
+  runCycle( enumerator );
+  uint32_t allSlots = bus.slots;
+  enumerator.setFamily( 0x28 );
+  bus.resetCounters();
+  runCycle( enumerator );
+  assertTrue( bus.slots < allSlots / 2 );
+
+  bus.clear();
+  for ( uint8_t t = 0; t < TAGS; t++ ) delete tags[t];
+
+}
+
+unittest( iButtonEnumerator_family ) {
+
+  makeCodes();
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice a( codes[0] ), b( codes[6] ), c( codes[7] );
+  bus.attach( &a );
+  bus.attach( &b );
+  bus.attach( &c );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+
+  // Function readCodes with a family: finds that family only, then starts over
+  assertEqual( 1, ibutton.readCodes( 0x28 ) );
+  assertEqual( 1, ibutton.nextCode( code ) );
+  assertEqual( 0x28, code[0] );
+  assertEqual( 1, ibutton.nextCode( code ) );
+  assertEqual( 0x28, code[0] );
+  assertEqual( 0, ibutton.nextCode( code ) );
+  assertEqual( 0x28, code[0] );                       // Unchanged
+  assertEqual( 1, ibutton.nextCode( code ) );
+  assertEqual( 0x28, code[0] );
+
+  // Family not present
+  assertEqual( 1, ibutton.readCodes( 0x0C ) );
+  assertEqual( 0, ibutton.nextCode( code ) );
+
+  // Enumerator with a family
+  iButtonCode known[4];
+  iButtonEnumerator enumerator( ibutton, known, 4, 1000000 );
+  enumerator.setFamily( 0x01 );
+  assertEqual( 1, enumerator.scan() );
+  assertTrue( enumerator.isPresent( codes[0] ) );
+  enumerator.clearFamily();
+  assertEqual( 2, enumerator.scan() );
+
+  bus.clear();
+
+}
+
+unittest_main()
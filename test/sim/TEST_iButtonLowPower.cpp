@@ -0,0 +1,102 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonLowPower.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 5
+
+// Code of simulated tag
+static const uint8_t codeA[8] = { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C };
+
+// Tag touching the probe during a period of virtual time only
+class VisitingTag : public iButtonSimDevice {
+
+  public:
+    VisitingTag( const uint8_t* code ) : iButtonSimDevice( code ) {}
+    uint32_t arrive = 0;
+    uint32_t depart = 0;
+
+  protected:
+    void onTick() override {
+      touching = iButtonSimBus::now >= arrive && iButtonSimBus::now < depart;
+    }
+
+};
+
+unittest( iButtonLowPower_poll ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  VisitingTag tag( codeA );
+  bus.attach( &tag );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonLowPower sleeper( ibutton, PIN_SIM, 250 );
+  iButtonCode code;
+
+  // No interrupts on the host: polling
+  assertEqual( IBUTTON_WAKE_POLL, sleeper.begin() );
+
+  // Tag arrives after 2 seconds, read within one interval
+  bus.resetCounters();
+  uint32_t start = iButtonSimBus::now;
+  tag.arrive = start + 2000000;
+  tag.depart = start + 5000000;
+  assertEqual( 1, sleeper.waitCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertTrue( iButtonSimBus::now >= tag.arrive );
+  assertTrue( iButtonSimBus::now - tag.arrive < 260000 );
+  assertEqual( 1, sleeper.wakes() );
+
+  // Sparse presence checks: one reset per interval, and one READ ROM
+  assertTrue( bus.resets <= 2000 / 250 + 2 );
+  assertTrue( bus.slots == 72 );
+
+  // Wake to code latency is one READ ROM
+  assertTrue( sleeper.latency() >= SIM_RESET_US + 72 * SIM_SLOT_US );
+  assertTrue( sleeper.latency() < 10000 );
+  assertEqual( sleeper.latency(), sleeper.longestLatency() );
+
+  // Tag staying on the probe is not read again, only when it returns
+  tag.arrive = start + 6000000;
+  tag.depart = start + 7000000;
+  assertEqual( 1, sleeper.waitCode( code ) );
+  assertTrue( iButtonSimBus::now >= tag.arrive );
+  assertEqual( 2, sleeper.wakes() );
+
+  // Timeout: no tag arriving, waiting ends after the timeout
+  tag.arrive = start + 60000000;
+  tag.depart = start + 61000000;
+  uint32_t waiting = iButtonSimBus::now;
+  assertEqual( 0, sleeper.waitCode( code, 1000 ) );
+  assertTrue( iButtonSimBus::now - waiting >= 1000000 );
+  assertTrue( iButtonSimBus::now - waiting < 1010000 );
+  assertEqual( 2, sleeper.wakes() );
+
+  // Timeout not reached: code read as without timeout
+  tag.arrive = iButtonSimBus::now + 500000;
+  assertEqual( 1, sleeper.waitCode( code, 1000 ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 3, sleeper.wakes() );
+
+  // Tag arriving with bad contact: invalid codes for longer than the first 5
+  // reads, still read while it stays, without waking again
+  tag.arrive = iButtonSimBus::now + 500000;
+  tag.depart = tag.arrive + 2000000;
+  tag.glitches = 20;
+  tag.reads = 0;
+  assertEqual( 1, sleeper.waitCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 21, tag.reads );
+  assertTrue( iButtonSimBus::now < tag.depart );
+  assertEqual( 4, sleeper.wakes() );
+
+  bus.clear();
+
+}
+
+unittest_main()
@@ -0,0 +1,209 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonMemory.h>
+#include <iButtonUartBus.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 9
+
+// Codes of simulated tags: DS1996, DS1982 and DS1990A
+static const uint8_t codeNvram[8] = { 0x0C, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x00 };
+static const uint8_t codeEprom[8] = { 0x09, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x00 };
+static const uint8_t codePlain[8] = { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 };
+
+// Data handed to the handler
+static uint16_t chunks, bytes, stopAfter;
+static bool ordered;
+
+static bool handleData( uint16_t address, const uint8_t* data, uint8_t length ) {
+  if ( address != bytes || length > IBUTTON_MEMORY_PAGE ) ordered = false;
+  for ( uint8_t i = 0; i < length; i++ ) {
+    if ( data[i] != (uint8_t) ( ( address + i ) * 7 ) ) ordered = false;
+  }
+  chunks++;
+  bytes += length;
+  return chunks != stopAfter;
+}
+
+static void fill( iButtonSimMemory& tag ) {
+  for ( uint16_t i = 0; i < tag.memory.size(); i++ ) tag.memory[i] = (uint8_t) ( i * 7 );
+}
+
+unittest( iButtonMemory_read ) {
+
+  uint8_t code[8];
+  memcpy( code, codeNvram, 8 );
+  iButtonTag::updateChecksum( code );
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimMemory tag( code, 8192 );
+  fill( tag );
+  bus.attach( &tag );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonMemory memory( ibutton, code );
+  assertEqual( IBUTTON_MEMORY_NVRAM, memory.type() );
+  assertEqual( 8192, memory.size() );
+
+  // Whole memory streamed page by page in one continuous read
+  chunks = bytes = 0;
+  stopAfter = 0;
+  ordered = true;
+  bus.resetCounters();
+  assertEqual( 1, memory.read( 0, 8192, handleData ) );
+  assertEqual( 256, chunks );
+  assertEqual( 8192, bytes );
+  assertTrue( ordered );
+  assertEqual( 1, bus.resets );
+  assertEqual( 8 + 64 + 24 + 8192 * 8, bus.slots );
+
+  // Bus time per KiB: 8192 time slots, plus a share of selecting
+  assertEqual( 8192, memory.busBytes() );
+  assertTrue( memory.busTimePerKiB() >= 8192UL * SIM_SLOT_US );
+  assertTrue( memory.busTimePerKiB() < 8192UL * SIM_SLOT_US * 101 / 100 );
+
+  // Stopped by the handler
+  chunks = bytes = 0;
+  stopAfter = 2;
+  assertEqual( 1, memory.read( 0, 8192, handleData ) );
+  assertEqual( 2, chunks );
+  assertEqual( 64, memory.busBytes() );
+
+  // Into a buffer, not aligned to pages
+  uint8_t buffer[70];
+  assertEqual( 1, memory.read( 5, buffer, 70 ) );
+  bool same = true;
+  for ( uint8_t i = 0; i < 70; i++ ) same = same && buffer[i] == (uint8_t) ( ( i + 5 ) * 7 );
+  assertTrue( same );
+
+  // Beyond end of memory, family without memory, nothing present
+  assertEqual( -2, memory.read( 8190, buffer, 3 ) );
+  iButtonMemory plain( ibutton, codePlain );
+  assertEqual( IBUTTON_MEMORY_NONE, plain.type() );
+  assertEqual( -2, plain.read( 0, buffer, 1 ) );
+  tag.touching = false;
+  assertEqual( 0, memory.read( 0, buffer, 8 ) );
+
+  bus.clear();
+
+}
+
+unittest( iButtonMemory_write ) {
+
+  uint8_t code[8];
+  memcpy( code, codeNvram, 8 );
+  code[0] = 0x08;                                     // DS1992
+  iButtonTag::updateChecksum( code );
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimMemory tag( code, 128 );
+  bus.attach( &tag );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonMemory memory( ibutton, code );
+  assertEqual( 128, memory.size() );
+
+  // Across a page boundary: two pages through the scratchpad
+  uint8_t data[40];
+  for ( uint8_t i = 0; i < 40; i++ ) data[i] = 100 + i;
+  assertEqual( 1, memory.write( 20, data, 40 ) );
+  assertEqual( 2, tag.copies );
+  assertEqual( 40, memory.busBytes() );
+  assertEqual( 0xFF, tag.memory[19] );
+  assertEqual( 100, tag.memory[20] );
+  assertEqual( 139, tag.memory[59] );
+  assertEqual( 0xFF, tag.memory[60] );
+
+  // Read back
+  uint8_t buffer[40];
+  assertEqual( 1, memory.read( 20, buffer, 40 ) );
+  assertEqual( 0, memcmp( buffer, data, 40 ) );
+
+  // Beyond end of memory, nothing present
+  assertEqual( -2, memory.write( 100, data, 40 ) );
+  tag.touching = false;
+  assertEqual( 0, memory.write( 0, data, 1 ) );
+
+  bus.clear();
+
+}
+
+unittest( iButtonMemory_eprom ) {
+
+  uint8_t code[8];
+  memcpy( code, codeEprom, 8 );
+  iButtonTag::updateChecksum( code );
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimMemory tag( code, 128, true );
+  fill( tag );
+  bus.attach( &tag );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonMemory memory( ibutton, code );
+  assertEqual( IBUTTON_MEMORY_EPROM, memory.type() );
+
+  // Pages checked with CRC8, first one partial
+  uint8_t buffer[128];
+  assertEqual( 1, memory.read( 10, buffer, 100 ) );
+  bool same = true;
+  for ( uint8_t i = 0; i < 100; i++ ) same = same && buffer[i] == (uint8_t) ( ( i + 10 ) * 7 );
+  assertTrue( same );
+
+  // CRC8 failure: page read again
+  tag.corrupt = 1;
+  bus.resetCounters();
+  assertEqual( 1, memory.read( 0, buffer, 128 ) );
+  assertEqual( 2, bus.resets );
+  tag.corrupt = 10;
+  assertEqual( -1, memory.read( 0, buffer, 128 ) );
+  tag.corrupt = 0;
+
+  // Read only
+  assertEqual( -5, memory.write( 0, buffer, 1 ) );
+
+  bus.clear();
+
+}
+
+unittest( iButtonMemory_overdrive ) {
+
+  uint8_t code[8];
+  memcpy( code, codeNvram, 8 );
+  iButtonTag::updateChecksum( code );
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimMemory tag( code, 8192 );
+  tag.overdriveCapable = true;
+  fill( tag );
+  bus.attach( &tag );
+  iButtonSimUart uart( PIN_SIM );                     // Backend with overdrive
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+  iButtonMemory memory( ibutton, code );
+  uint8_t buffer[1024];
+  assertEqual( 1, memory.read( 0, buffer, 1024 ) );
+  uint32_t standard = memory.busTimePerKiB();
+
+  // Selected at overdrive speed: bus time per KiB about 8 times less
+  assertEqual( IBUTTON_SPEED_AUTO, ibutton.setSpeed( IBUTTON_SPEED_AUTO ) );
+  chunks = bytes = 0;
+  stopAfter = 0;
+  ordered = true;
+  assertEqual( 1, memory.read( 0, 8192, handleData ) );
+  assertTrue( ordered );
+  assertTrue( tag.overdrive );
+  assertTrue( memory.busTimePerKiB() < standard / 6 );
+
+  // Written at overdrive speed too
+  uint8_t data[4] = { 1, 2, 3, 4 };
+  assertEqual( 1, memory.write( 8000, data, 4 ) );
+  assertEqual( 3, tag.memory[8002] );
+
+  bus.clear();
+
+}
+
+unittest_main()
@@ -0,0 +1,211 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonTag.h>
+#include <iButtonUartBus.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 6
+
+// Codes of simulated tags
+static const uint8_t codeA[8] = { 0x0C, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0xB4 };
+static const uint8_t codeB[8] = { 0x0C, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0xA2 };
+static const uint8_t codeC[8] = { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 };
+
+unittest( iButtonOverdrive_setSpeed ) {
+
+  // Backend on a pin of the simulator has no direct pin access: standard only
+  iButtonTag pinTag( PIN_SIM );
+  assertEqual( IBUTTON_SPEED_STANDARD, pinTag.setSpeed( IBUTTON_SPEED_AUTO ) );
+  assertEqual( IBUTTON_SPEED_STANDARD, pinTag.speed() );
+
+  iButtonSimUart uart( PIN_SIM );
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+  assertEqual( IBUTTON_SPEED_STANDARD, ibutton.speed() );
+  assertEqual( IBUTTON_SPEED_AUTO, ibutton.setSpeed( IBUTTON_SPEED_AUTO ) );
+  assertEqual( IBUTTON_SPEED_OVERDRIVE, ibutton.setSpeed( IBUTTON_SPEED_OVERDRIVE ) );
+  assertEqual( IBUTTON_SPEED_STANDARD, ibutton.setSpeed( 7 ) );
+
+}
+
+unittest( iButtonOverdrive_readCode ) {
+
+  // Codes must be valid
+  assertEqual( 1, iButtonTag::testCode( codeA ) );
+  assertEqual( 1, iButtonTag::testCode( codeB ) );
+  assertEqual( 1, iButtonTag::testCode( codeC ) );
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice fast( codeA );
+  fast.overdriveCapable = true;
+  iButtonSimDevice slow( codeC );
+  bus.attach( &fast );
+  iButtonSimUart uart( PIN_SIM );
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+  iButtonCode code;
+
+  // Standard speed unless set
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertFalse( fast.overdrive );
+  assertEqual( -1, ibutton.overdriveCapable( codeA ) );
+
+  // First read detects capability and switches the iButton to overdrive speed
+  ibutton.setSpeed( IBUTTON_SPEED_AUTO );
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertTrue( fast.overdrive );
+  assertEqual( 1, ibutton.overdriveCapable( codeA ) );
+
+  // Next reads at overdrive speed only: 1 reset and 72 slots
+  bus.resetCounters();
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  uint32_t fastTime = iButtonSimBus::now - start;
+  assertEqual( 1, bus.resets );
+  assertEqual( 72, bus.slots );
+  assertTrue( fastTime < ( SIM_UART_RESET_US + 72 * SIM_UART_SLOT_US ) / 4 );
+
+  // Other iButton without overdrive: falls back to standard speed
+  bus.clear();
+  bus.attach( &slow );
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeC ) );
+  assertEqual( 0, ibutton.overdriveCapable( codeC ) );
+
+  // Known to lack overdrive: no detection on next reads
+  bus.resetCounters();
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertEqual( 1, bus.resets );
+  assertEqual( 72, bus.slots );
+
+  // Capable iButton back on the probe: capability known, switched right away
+  bus.clear();
+  bus.attach( &fast );
+  fast.overdrive = false;
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertTrue( fast.overdrive );
+  bus.resetCounters();
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertEqual( 1, bus.resets );
+
+  // Other functions at standard speed, returning the iButton to it
+  assertEqual( 1, ibutton.checkPresence() );
+  assertFalse( fast.overdrive );
+  assertEqual( 1, ibutton.verifyPresent( codeA ) );
+
+  // Removed: no presence at either speed
+  assertEqual( 1, ibutton.readCode( code ) );
+  fast.touching = false;
+  assertEqual( 0, ibutton.readCode( code ) );
+  fast.touching = true;
+  assertEqual( 1, ibutton.readCode( code ) );
+
+  bus.clear();
+
+}
+
+unittest( iButtonOverdrive_nextCode ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice a( codeA );
+  iButtonSimDevice b( codeB );
+  iButtonSimDevice c( codeC );
+  a.overdriveCapable = true;
+  b.overdriveCapable = true;
+  bus.attach( &a );
+  bus.attach( &b );
+  iButtonSimUart uart( PIN_SIM );
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+  iButtonCode code;
+
+  // Search at standard speed
+  ibutton.setSpeed( IBUTTON_SPEED_AUTO );
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 1, ibutton.readCodes() );
+  uint8_t found = 0;
+  while ( ibutton.nextCode( code ) == 1 ) found++;
+  assertEqual( 2, found );
+  uint32_t slowTime = iButtonSimBus::now - start;
+  assertFalse( a.overdrive );
+
+  // Search at overdrive speed, finds capable iButtons only
+  ibutton.setSpeed( IBUTTON_SPEED_OVERDRIVE );
+  start = iButtonSimBus::now;
+  assertEqual( 1, ibutton.readCodes() );
+  found = 0;
+  while ( ibutton.nextCode( code ) == 1 ) found++;
+  assertEqual( 2, found );
+  assertTrue( iButtonSimBus::now - start < slowTime / 2 );
+  assertTrue( a.overdrive );
+  assertEqual( 1, ibutton.overdriveCapable( codeA ) );
+  assertEqual( 1, ibutton.overdriveCapable( codeB ) );
+
+  // No capable iButtons: falls back to standard speed
+  bus.clear();
+  bus.attach( &c );
+  assertEqual( 1, ibutton.readCodes() );
+  assertEqual( 1, ibutton.nextCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeC ) );
+  assertEqual( 0, ibutton.nextCode( code ) );
+  assertEqual( -1, ibutton.overdriveCapable( codeC ) );
+
+  bus.clear();
+
+}
+
+unittest( iButtonOverdrive_selectCode ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice a( codeA );
+  iButtonSimDevice c( codeC );
+  a.overdriveCapable = true;
+  bus.attach( &a );
+  bus.attach( &c );
+  iButtonSimUart uart( PIN_SIM );
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+
+  // Standard speed
+  assertEqual( 1, ibutton.selectCode( codeA ) );
+  assertFalse( a.overdrive );
+
+  // Capability unknown: detected with OVERDRIVE MATCH ROM
+  ibutton.setSpeed( IBUTTON_SPEED_AUTO );
+  assertEqual( 2, ibutton.selectCode( codeA ) );
+  assertTrue( a.overdrive );
+  assertEqual( 1, ibutton.overdriveCapable( codeA ) );
+  assertEqual( 1, ibutton.selectCode( codeC ) );
+  assertEqual( 0, ibutton.overdriveCapable( codeC ) );
+  assertFalse( a.overdrive );
+
+  // Capability known
+  bus.resetCounters();
+  assertEqual( 2, ibutton.selectCode( codeA ) );
+  assertEqual( 1, bus.resets );
+  bus.resetCounters();
+  assertEqual( 2, ibutton.selectCode( codeA ) );
+  assertEqual( 1, bus.resets );
+  assertEqual( 72, bus.slots );
+
+  // Not present
+  a.touching = false;
+  c.touching = false;
+  assertEqual( 0, ibutton.selectCode( codeA ) );
+  assertEqual( 0, ibutton.selectCode( codeC ) );
+
+  bus.clear();
+
+}
+
+unittest_main()
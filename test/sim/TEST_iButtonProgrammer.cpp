@@ -0,0 +1,143 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonProgrammer.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 2
+
+// Codes to write and code of blank tags
+static const iButtonCode batch[3] = {
+  { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C },
+  { 0x01, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x9A },
+  { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 }
+};
+static const uint8_t blank[8] = { 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x2F };
+
+// Results received
+uint8_t results = 0;
+uint16_t lastIndex;
+int8_t lastStatus;
+
+void handleResult( uint16_t index, const uint8_t*, int8_t status ) {
+  results++;
+  lastIndex = index;
+  lastStatus = status;
+}
+
+// Polls for some time, like while tags are swapped
+void runIdle( iButtonProgrammer& programmer, uint16_t ms ) {
+  for ( uint16_t i = 0; i < ms; i++ ) {
+    programmer.poll();
+    delay( 1 );
+  }
+}
+
+// Longest bus time of a single poll, in microseconds
+uint32_t longestPoll = 0;
+
+// Polls until the next result, or at most 10 seconds
+int8_t runTag( iButtonProgrammer& programmer ) {
+  uint8_t before = results;
+  int8_t status = IBUTTON_BUSY;
+  uint32_t start = millis();
+  while ( results == before && millis() - start < 10000 ) {
+    uint32_t poll = iButtonSimBus::now;
+    status = programmer.poll();
+    poll = iButtonSimBus::now - poll;
+    if ( poll > longestPoll ) longestPoll = poll;
+    delay( 1 );
+  }
+  return status;
+}
+
+unittest( iButtonProgrammer_batch ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+  iButtonProgrammer programmer( ibutton, batch, 3 );
+  programmer.onResult( handleResult );
+
+  // Nothing on the probe
+  runIdle( programmer, 100 );
+  assertEqual( 0, results );
+
+  // First tag: type detected once for the batch
+  iButtonSimRW1990 tag0( blank, IBUTTON_RW1990V1 );
+  bus.attach( &tag0 );
+  assertEqual( IBUTTON_BUSY, runTag( programmer ) );
+  assertEqual( 1, lastStatus );
+  assertEqual( 0, lastIndex );
+  assertEqual( IBUTTON_RW1990V1, programmer.type() );
+  assertTrue( iButtonTag::equalCode( tag0.rom, batch[0] ) );
+
+  // Tag left on the probe is not written again
+  runIdle( programmer, 1000 );
+  assertEqual( 1, results );
+  bus.detach( &tag0 );
+  runIdle( programmer, 100 );
+
+  // Tag of other type fails the type check, code is kept for next tag
+  iButtonSimDevice plain( blank );
+  bus.attach( &plain );
+  assertEqual( IBUTTON_BUSY, runTag( programmer ) );
+  assertEqual( -13, lastStatus );
+  assertEqual( 1, lastIndex );
+  bus.detach( &plain );
+  runIdle( programmer, 100 );
+
+  // Next tags
+  iButtonSimRW1990 tag1( blank, IBUTTON_RW1990V1 );
+  bus.attach( &tag1 );
+  assertEqual( IBUTTON_BUSY, runTag( programmer ) );
+  assertEqual( 1, lastStatus );
+  assertEqual( 1, lastIndex );
+  assertTrue( iButtonTag::equalCode( tag1.rom, batch[1] ) );
+  bus.detach( &tag1 );
+  runIdle( programmer, 100 );
+
+  iButtonSimRW1990 tag2( blank, IBUTTON_RW1990V1 );
+  bus.attach( &tag2 );
+  assertEqual( 1, runTag( programmer ) );             // Batch finished
+  assertEqual( 1, lastStatus );
+  assertEqual( 2, lastIndex );
+  assertTrue( iButtonTag::equalCode( tag2.rom, batch[2] ) );
+  bus.clear();
+
+  // Counters and throughput
+  assertEqual( 3, programmer.written() );
+  assertEqual( 1, programmer.failed() );
+  assertTrue( programmer.tagsPerMinute() > 0 );
+  assertEqual( 1, programmer.poll() );
+
+}
+
+unittest( iButtonProgrammer_detect ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+  iButtonProgrammer programmer( ibutton, batch, 3 );
+  programmer.onResult( handleResult );
+  results = 0;
+
+  // Type detected without blocking: no poll waits for a programming delay.
+  // Type RW1990V2 has the same value as IBUTTON_BUSY.
+  iButtonSimRW1990 tag( blank, IBUTTON_RW1990V2 );
+  bus.attach( &tag );
+  longestPoll = 0;
+  assertEqual( IBUTTON_BUSY, runTag( programmer ) );
+  assertEqual( 1, lastStatus );
+  assertEqual( IBUTTON_RW1990V2, programmer.type() );
+  assertTrue( iButtonTag::equalCode( tag.rom, batch[0] ) );
+  assertTrue( longestPoll < 10000 );
+  bus.clear();
+
+}
+
+unittest_main()
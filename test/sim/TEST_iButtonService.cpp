@@ -0,0 +1,195 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonService.h>
+#include "iButtonSim.h"
+#include <chrono>
+
+// Pins of simulated buses, one per reader
+#define PIN_SIM 20
+
+// Codes of simulated tags
+static const uint8_t codeA[8] = { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C };
+static const uint8_t codeB[8] = { 0x01, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x9A };
+static const uint8_t codeC[8] = { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 };
+
+// Polls events until one of the type arrives, at most 2 seconds of host time
+static bool waitFor( iButtonService& service, uint8_t type, iButtonEvent& event ) {
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds( 2 );
+  while ( std::chrono::steady_clock::now() < end ) {
+    if ( !service.poll( event ) ) {
+      std::this_thread::yield();
+      continue;
+    }
+    if ( event.type == type ) return true;
+  }
+  return false;
+}
+
+unittest( iButtonService_queue ) {
+
+  iButtonQueue<uint32_t, 4> queue;
+  uint32_t item;
+
+  // First in, first out, across the end of the buffer
+  for ( uint32_t i = 0; i < 10; i++ ) {
+    assertTrue( queue.push( i ) );
+    assertTrue( queue.push( i + 100 ) );
+    assertEqual( 2, queue.size() );
+    assertTrue( queue.pop( item ) );
+    assertEqual( i, item );
+    assertTrue( queue.pop( item ) );
+    assertEqual( i + 100, item );
+  }
+  assertFalse( queue.pop( item ) );
+
+  // Full: items dropped and counted
+  for ( uint32_t i = 0; i < 6; i++ ) queue.push( i );
+  assertEqual( 4, queue.size() );
+  assertEqual( 2, queue.dropped() );
+  assertTrue( queue.pop( item ) );
+  assertEqual( 0, item );
+
+  // Producer and consumer thread: nothing lost, nothing reordered
+  iButtonQueue<uint32_t, 64> shared;
+  const uint32_t count = 200000;
+  std::thread producer( [&]() {
+    for ( uint32_t i = 0; i < count; i++ ) {
+      while ( !shared.push( i ) ) std::this_thread::yield();
+    }
+  } );
+  uint32_t expected = 0;
+  bool ordered = true;
+  while ( expected < count ) {
+    if ( shared.pop( item ) ) {
+      if ( item != expected ) ordered = false;
+      expected++;
+    }
+  }
+  producer.join();
+  assertTrue( ordered );
+  assertEqual( 0, shared.size() );
+
+}
+
+unittest( iButtonService_events ) {
+
+  iButtonSimBus& bus0 = iButtonSimBus::onPin( PIN_SIM );
+  iButtonSimBus& bus1 = iButtonSimBus::onPin( PIN_SIM + 1 );
+  bus0.clear();
+  bus1.clear();
+  iButtonSimDevice a( codeA ), b( codeB );
+  b.touching = false;
+  bus0.attach( &a );
+  bus1.attach( &b );
+  iButtonTag reader0( PIN_SIM ), reader1( PIN_SIM + 1 );
+  iButtonService service( 1 );
+  iButtonEvent event;
+
+  // Setup: readers only added while stopped, only arrive and depart reported
+  assertFalse( service.start() );
+  assertEqual( 0, service.addReader( reader0 ) );
+  assertEqual( 1, service.addReader( reader1 ) );
+  assertTrue( service.start() );
+  assertTrue( service.running() );
+  assertFalse( service.start() );
+  assertEqual( -1, service.addReader( reader0 ) );
+
+  // Arrival on the first reader
+  assertTrue( waitFor( service, IBUTTON_EVENT_ARRIVE, event ) );
+  assertEqual( 0, event.reader );
+  assertTrue( iButtonTag::equalCode( event.code, codeA ) );
+
+  // Arrival on the second reader, departure from the first
+  b.touching = true;
+  assertTrue( waitFor( service, IBUTTON_EVENT_ARRIVE, event ) );
+  assertEqual( 1, event.reader );
+  assertTrue( iButtonTag::equalCode( event.code, codeB ) );
+  a.touching = false;
+  assertTrue( waitFor( service, IBUTTON_EVENT_DEPART, event ) );
+  assertEqual( 0, event.reader );
+  assertTrue( iButtonTag::equalCode( event.code, codeA ) );
+
+  // Stopped: queued events still available, then none
+  service.stop();
+  assertFalse( service.running() );
+  while ( service.poll( event ) ) {}
+  assertFalse( service.poll( event ) );
+  assertEqual( 0, service.dropped() );
+
+  // Every read reported, queue full while nobody polls
+  service.reportReads( true );
+  assertTrue( service.start() );
+  assertTrue( waitFor( service, IBUTTON_EVENT_READ, event ) );
+  assertEqual( 1, event.reader );
+  assertEqual( 1, event.status );
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds( 2 );
+  while ( service.dropped() == 0 && std::chrono::steady_clock::now() < end ) {
+    std::this_thread::yield();
+  }
+  assertTrue( service.dropped() > 0 );
+
+  // Arrivals and departures while reads are dropped: none lost, strictly
+  // alternating, even with more of them than their queue holds
+  for ( uint8_t i = 0; i < 2 * IBUTTON_SERVICE_CHANGES + 1; i++ ) {
+    a.touching = i % 2 == 0;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+  }
+  uint8_t last = IBUTTON_EVENT_DEPART;
+  uint8_t changes = 0;
+  end = std::chrono::steady_clock::now() + std::chrono::seconds( 2 );
+  while ( std::chrono::steady_clock::now() < end ) {
+    if ( !service.poll( event ) ) {
+      if ( last == IBUTTON_EVENT_ARRIVE ) break;       // a touching at the end
+      std::this_thread::yield();
+      continue;
+    }
+    if ( event.reader != 0 ) continue;
+    if ( event.type == IBUTTON_EVENT_ARRIVE || event.type == IBUTTON_EVENT_DEPART ) {
+      assertTrue( event.type != last );
+      last = event.type;
+      changes++;
+    }
+  }
+  assertEqual( IBUTTON_EVENT_ARRIVE, last );
+  assertTrue( changes >= IBUTTON_SERVICE_CHANGES );
+  service.stop();
+
+  bus0.clear();
+  bus1.clear();
+
+}
+
+unittest( iButtonService_write ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimRW1990 tag( codeA, IBUTTON_RW1990V2 );
+  bus.attach( &tag );
+  iButtonTag reader( PIN_SIM );
+  iButtonService service( 1 );
+  service.reportReads( false );
+  iButtonEvent event;
+
+  // Write done by the reader thread, result and new code reported
+  assertFalse( service.requestWrite( 0, codeC ) );
+  assertEqual( 0, service.addReader( reader ) );
+  assertTrue( service.start() );
+  assertTrue( waitFor( service, IBUTTON_EVENT_ARRIVE, event ) );
+  assertTrue( service.requestWrite( 0, codeC, IBUTTON_RW1990V2 ) );
+  assertTrue( waitFor( service, IBUTTON_EVENT_WRITE, event ) );
+  assertEqual( 1, event.status );
+  assertTrue( iButtonTag::equalCode( event.code, codeC ) );
+  assertTrue( waitFor( service, IBUTTON_EVENT_ARRIVE, event ) );
+  assertTrue( iButtonTag::equalCode( event.code, codeC ) );
+  service.stop();
+  assertTrue( iButtonTag::equalCode( tag.rom, codeC ) );
+
+  bus.clear();
+
+}
+
+unittest_main()
@@ -0,0 +1,583 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonTag.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 2
+
+// Codes of simulated tags
+static const uint8_t codeA[8] = { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C };
+static const uint8_t codeB[8] = { 0x01, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x9A };
+static const uint8_t codeC[8] = { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 };
+
+// Tag answering with one of two codes in turn, every reset
+class iButtonSimFlipping : public iButtonSimDevice {
+  public:
+    iButtonSimFlipping( const uint8_t* a, const uint8_t* b ) : iButtonSimDevice( a ) {
+      memcpy( _other, b, 8 );
+    }
+  protected:
+    bool onReset() {
+      uint8_t swap[8];
+      memcpy( swap, rom, 8 );
+      memcpy( rom, _other, 8 );
+      memcpy( _other, swap, 8 );
+      return iButtonSimDevice::onReset();
+    }
+  private:
+    uint8_t _other[8];
+};
+
+// Removes all tags from the probe, taking the time a person would need, while
+// the probe is watched: the departure is noticed
+void removeTags( iButtonSimBus& bus, iButtonTag& ibutton ) {
+  bus.clear();
+  ibutton.checkPresence();
+  delay( 500 );
+}
+
+unittest( iButtonSim_read ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice tag( codeA );
+  bus.attach( &tag );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+
+  // Function readCode, 1 reset and 8 + 64 slots
+  bus.resetCounters();
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 1, bus.resets );
+  assertEqual( 72, bus.slots );
+  uint32_t busTime = SIM_RESET_US + 72 * SIM_SLOT_US;  // Plus reading clock
+  assertTrue( iButtonSimBus::now - start - busTime <= 5 );
+
+  assertEqual( 1, ibutton.readCode( code, true ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+
+  // Tag removed from probe
+  tag.touching = false;
+  assertEqual( 0, ibutton.readCode( code ) );
+
+  // Two tags collide on READ ROM
+  tag.touching = true;
+  iButtonSimDevice other( codeB );
+  bus.attach( &other );
+  assertEqual( -1, ibutton.readCode( code ) );
+
+  bus.clear();
+
+}
+
+unittest( iButtonSim_readCodeStable ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice tag( codeA );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+  uint8_t attempts;
+
+  // Nothing on the probe: a single reset
+  bus.resetCounters();
+  assertEqual( 0, ibutton.readCodeStable( code, 2, 8, 100, &attempts ) );
+  assertEqual( 1, attempts );
+  assertEqual( 1, bus.resets );
+
+  // Presented cleanly: as many reads as must agree
+  bus.attach( &tag );
+  bus.resetCounters();
+  assertEqual( 1, ibutton.readCodeStable( code, 3, 8, 100, &attempts ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 3, attempts );
+  assertEqual( 3, bus.resets );
+  assertEqual( 1, ibutton.readCodeStable( code, 0, 8, 100, &attempts ) );
+  assertEqual( 1, attempts );
+
+  // Sliding: invalid reads skipped
+  tag.glitches = 3;
+  assertEqual( 1, ibutton.readCodeStable( code, 2, 8, 100, &attempts ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 5, attempts );
+
+  // Invalid reads only, or not enough agreeing reads
+  tag.glitches = 10;
+  assertEqual( -2, ibutton.readCodeStable( code, 2, 4, 100, &attempts ) );
+  assertEqual( 4, attempts );
+  tag.glitches = 3;
+  assertEqual( -3, ibutton.readCodeStable( code, 2, 4, 100, &attempts ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+
+  // Candidate replaced by a differing code
+  tag.glitches = 0;
+  memcpy( tag.rom, codeB, 8 );
+  assertEqual( 1, ibutton.readCodeStable( code, 2, 8, 100, &attempts ) );
+  assertTrue( iButtonTag::equalCode( code, codeB ) );
+
+  // Flipping between two valid codes: any code read often enough settles, not
+  // only reads in a row
+  bus.clear();
+  iButtonSimFlipping flipping( codeA, codeB );
+  bus.attach( &flipping );
+  assertEqual( 1, ibutton.readCodeStable( code, 2, 8, 100, &attempts ) );
+  assertTrue( iButtonTag::equalCode( code, codeB ) );
+  assertEqual( 3, attempts );
+  assertEqual( -3, ibutton.readCodeStable( code, 3, 4, 100, &attempts ) );
+  assertEqual( 4, attempts );
+  assertTrue( iButtonTag::equalCode( code, codeB ) );  // Read most, latest
+
+  // Reads A, B, A with agree 2: reads are tallied, not counted in a row, so
+  // code A settles on the third read although no two reads in a row agree
+  bus.clear();
+  iButtonSimFlipping tally( codeB, codeA );  // First reset flips to code A
+  bus.attach( &tally );
+  assertEqual( 1, ibutton.readCodeStable( code, 2, 8, 100, &attempts ) );
+  assertEqual( 3, attempts );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  bus.clear();
+  bus.attach( &tag );
+
+  // Timeout ends reading early
+  tag.glitches = 100;
+  assertEqual( -2, ibutton.readCodeStable( code, 2, 200, 20, &attempts ) );
+  assertTrue( attempts < 200 );
+  tag.glitches = 0;
+
+  // DS1990 answering READ ROM 0x0F only: found after switching command
+  memcpy( tag.rom, codeA, 8 );
+  tag.legacy = true;
+  assertEqual( -1, ibutton.readCode( code ) );
+  assertEqual( 1, ibutton.readCodeStable( code, 2, 8, 100, &attempts ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 4, attempts );
+
+  bus.clear();
+
+}
+
+unittest( iButtonSim_search ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice a( codeA ), b( codeB ), c( codeC );
+  bus.attach( &a );
+  bus.attach( &b );
+  bus.attach( &c );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+
+  // Functions readCodes and nextCode find every tag once
+  assertEqual( 1, ibutton.readCodes() );
+  uint8_t found = 0, mask = 0;
+  while ( ibutton.nextCode( code ) == 1 ) {
+    found++;
+    if ( iButtonTag::equalCode( code, codeA ) ) mask |= 1;
+    if ( iButtonTag::equalCode( code, codeB ) ) mask |= 2;
+    if ( iButtonTag::equalCode( code, codeC ) ) mask |= 4;
+  }
+  assertEqual( 3, found );
+  assertEqual( 7, mask );
+
+  bus.clear();
+  assertEqual( 0, ibutton.readCodes() );
+
+}
+
+unittest( iButtonSim_verifyPresent ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice a( codeA ), b( codeB ), c( codeC );
+  bus.attach( &a );
+  bus.attach( &b );
+  bus.attach( &c );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code, absent = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  iButtonTag::updateChecksum( absent );
+
+  // Enumerating all tags, 1 + 3 resets and 3 * ( 8 + 3 * 64 ) slots
+  bus.resetCounters();
+  ibutton.readCodes();
+  while ( ibutton.nextCode( code ) == 1 );
+  assertEqual( 4, bus.resets );
+  assertEqual( 600, bus.slots );
+
+  // Function verifyPresent, single present code: READ ROM reads the AND of all
+  // three codes, then a search pass along the code
+  bus.resetCounters();
+  assertEqual( 1, ibutton.verifyPresent( codeB ) );
+  assertEqual( 2, bus.resets );
+  assertEqual( 72 + 200, bus.slots );
+
+  // More than one device seen: no READ ROM, 1 reset and 8 + 3 * 64 slots
+  bus.resetCounters();
+  assertEqual( 1, ibutton.verifyPresent( codeB ) );
+  assertEqual( 1, bus.resets );
+  assertEqual( 200, bus.slots );
+
+  // Function verifyPresent, absent code stops at first bit no tag has
+  bus.resetCounters();
+  assertEqual( 0, ibutton.verifyPresent( absent ) );
+  assertEqual( 1, bus.resets );
+  assertTrue( bus.slots < 8 + 3 * 16 );
+
+  // Function verifyPresent, multiple codes: one pass per code present, absent
+  // codes dropped along the way instead of a search each
+  iButtonCode known[8];
+  bool present[8];
+  for ( uint8_t k = 0; k < 8; k++ ) {
+    for ( uint8_t i = 0; i < 8; i++ ) known[k][i] = absent[i];
+    known[k][1] = k;
+    iButtonTag::updateChecksum( known[k] );
+  }
+  for ( uint8_t i = 0; i < 8; i++ ) {
+    known[2][i] = codeA[i];
+    known[5][i] = codeC[i];
+  }
+  b.touching = false;
+  bus.resetCounters();
+  assertEqual( 2, ibutton.verifyPresent( known, 8, present ) );
+  for ( uint8_t k = 0; k < 8; k++ ) assertEqual( k == 2 || k == 5, present[k] );
+  assertEqual( 2, bus.resets );
+  assertEqual( 2 * 200, bus.slots );
+  c.touching = false;
+  assertEqual( 1, ibutton.verifyPresent( known, 8 ) );
+
+  // A complete pass with a single device: READ ROM again, 1 reset and 8 + 64
+  // slots for all codes
+  bus.resetCounters();
+  assertEqual( 1, ibutton.verifyPresent( known, 8, present ) );
+  assertTrue( present[2] );
+  assertEqual( 1, bus.resets );
+  assertEqual( 72, bus.slots );
+  bus.resetCounters();
+  assertEqual( 0, ibutton.verifyPresent( codeB ) );
+  assertEqual( 1, bus.resets );
+  assertEqual( 72, bus.slots );
+
+  // Two devices reading as the AND of their codes, equal to a known code that
+  // isn't there: it's verified with a search, as another known code is pending
+  iButtonTag fresh( PIN_SIM );
+  bus.clear();
+  b.touching = c.touching = true;
+  iButtonCode both[2];
+  for ( uint8_t i = 0; i < 8; i++ ) {
+    both[0][i] = codeB[i] & codeC[i];
+    both[1][i] = codeB[i];
+  }
+  bus.attach( &b );
+  bus.attach( &c );
+  assertEqual( 1, fresh.verifyPresent( both, 2, present ) );
+  assertFalse( present[0] );
+  assertTrue( present[1] );
+
+  bus.clear();
+  assertEqual( 0, ibutton.verifyPresent( codeA ) );
+  assertEqual( 0, ibutton.verifyPresent( known, 8 ) );
+
+}
+
+unittest( iButtonSim_stats ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice tag( codeA );
+  bus.attach( &tag );
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+
+  // Function readCode: 1 reset, 1 byte written, 8 read, about 6 milliseconds
+  assertEqual( 1, ibutton.readCode( code ) );
+  const iButtonStats& stats = ibutton.stats();
+  assertEqual( 1, stats.resets );
+  assertEqual( 0, stats.noPresence );
+  assertEqual( 1, stats.bytesWritten );
+  assertEqual( 8, stats.bytesRead );
+  assertEqual( 1, stats.readCode.calls );
+  assertTrue( stats.readCode.longest >= SIM_RESET_US + 72 * SIM_SLOT_US );
+  assertEqual( 1, stats.readCode.buckets[5] );         // 4096 - 8192 us
+
+  // Invalid codes
+  tag.glitches = 1;
+  assertEqual( -2, ibutton.readCode( code ) );
+  iButtonSimDevice other( codeB );
+  bus.attach( &other );
+  assertEqual( -1, ibutton.readCode( code ) );
+  assertEqual( 1, stats.zeroCodes );
+  assertEqual( 1, stats.checksumFailures );
+  bus.clear();
+  assertEqual( 0, ibutton.readCode( code ) );
+  assertEqual( 1, stats.noPresence );
+  assertEqual( 4, stats.readCode.calls );
+
+  // Function writeCode: flag, 64 code bits and flag each followed by a delay
+  iButtonSimRW1990 rw( codeA, IBUTTON_RW1990V1 );
+  bus.attach( &rw );
+  ibutton.resetStats();
+  assertEqual( 0, stats.resets );
+  assertEqual( 1, ibutton.writeCode( codeB, IBUTTON_RW1990V1, false ) );
+  assertEqual( 66, stats.bitsWritten );
+  assertEqual( 66 * 10000UL, stats.delayMicros );
+  assertEqual( 1, stats.writeCode.calls );
+  assertEqual( 1, stats.writeCode.buckets[IBUTTON_STATS_BUCKETS - 1] );
+
+  // Function printStats
+  Serial.output = "";
+  ibutton.printStats();
+  assertTrue( Serial.output.find( "writeCode: 1 calls" ) != std::string::npos );
+  assertTrue( Serial.output.find( "programming delays: 660000 us" ) != std::string::npos );
+
+  bus.clear();
+
+}
+
+unittest( iButtonSim_detect ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+
+  // No iButton
+  assertEqual( -1, ibutton.detectWritableType() );
+
+  // Not writable
+  iButtonSimDevice plain( codeA );
+  bus.attach( &plain );
+  assertEqual( IBUTTON_UNKNOWN, ibutton.detectWritableType() );
+  removeTags( bus, ibutton );
+
+  // Writable types, TM01 is non-detectable
+  iButtonSimRW1990 v1( codeA, IBUTTON_RW1990V1 );
+  bus.attach( &v1 );
+  assertEqual( IBUTTON_RW1990V1, ibutton.detectWritableType() );
+  removeTags( bus, ibutton );
+
+  iButtonSimRW1990 v2( codeA, IBUTTON_RW1990V2 );
+  bus.attach( &v2 );
+  assertEqual( IBUTTON_RW1990V2, ibutton.detectWritableType() );
+  assertEqual( 0, v2.flag );                          // Writing disabled again
+  removeTags( bus, ibutton );
+
+  iButtonSimRW2004 rw2004( codeA );
+  bus.attach( &rw2004 );
+  assertEqual( IBUTTON_RW2004, ibutton.detectWritableType() );
+  removeTags( bus, ibutton );
+
+  iButtonSimRW1990 tm01( codeA, IBUTTON_TM01 );
+  bus.attach( &tm01 );
+  assertEqual( IBUTTON_UNKNOWN, ibutton.detectWritableType() );
+  removeTags( bus, ibutton );
+
+}
+
+unittest( iButtonSim_typeCache ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+
+  // First detection probes RW1990V1 first, then RW1990V2
+  iButtonSimRW1990 tag( codeA, IBUTTON_RW1990V2 );
+  bus.attach( &tag );
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( IBUTTON_RW1990V2, ibutton.detectWritableType() );
+  uint32_t probing = iButtonSimBus::now - start;
+  assertTrue( probing > 4 * 10000UL );
+
+  // Detection again only reads the code
+  start = iButtonSimBus::now;
+  assertEqual( IBUTTON_RW1990V2, ibutton.detectWritableType() );
+  assertTrue( iButtonSimBus::now - start < 10000UL );
+
+  // Writing moves the cached type to the new code
+  assertEqual( 1, ibutton.writeCode( codeB ) );
+  start = iButtonSimBus::now;
+  assertEqual( IBUTTON_RW1990V2, ibutton.detectWritableType() );
+  assertTrue( iButtonSimBus::now - start < 10000UL );
+
+  // Writing the same tag again later, without resets in between: no probing
+  delay( 500 );
+  tag.flagReads = 0;
+  assertEqual( 1, ibutton.writeCode( codeA ) );
+  assertEqual( 0, tag.flagReads );
+  delay( 500 );
+  assertEqual( 1, ibutton.writeCode( codeB ) );
+  assertEqual( 0, tag.flagReads );
+
+  // Departure clears the cache, a plain tag with the same code isn't writable
+  bus.detach( &tag );
+  assertEqual( 0, ibutton.readCode( code ) );
+  iButtonSimDevice plain( codeB );
+  bus.attach( &plain );
+  assertEqual( IBUTTON_UNKNOWN, ibutton.detectWritableType() );
+  assertEqual( -12, ibutton.writeCode( codeA ) );     // Cached, not probed
+  removeTags( bus, ibutton );
+
+  // Most detected type is probed first
+  bus.attach( &tag );
+  start = iButtonSimBus::now;
+  assertEqual( IBUTTON_RW1990V2, ibutton.detectWritableType() );
+  assertTrue( iButtonSimBus::now - start < probing - 10000UL );
+
+  // Function clearTypeCache
+  ibutton.clearTypeCache();
+  start = iButtonSimBus::now;
+  assertEqual( IBUTTON_RW1990V2, ibutton.detectWritableType() );
+  assertTrue( iButtonSimBus::now - start > 3 * 10000UL );
+  bus.clear();
+
+}
+
+unittest( iButtonSim_write ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+
+  // Every writable type, with detection and with supplied type
+  for ( int8_t type = IBUTTON_RW1990V1; type <= IBUTTON_MAXWRITABLE; type++ ) {
+    for ( uint8_t detect = 0; detect < 2; detect++ ) {
+      if ( detect && type == IBUTTON_TM01 ) continue;
+      iButtonSimRW1990 rw1990( codeA, type );
+      iButtonSimRW2004 rw2004( codeA );
+      iButtonSimDevice* tag = &rw1990;
+      if ( type == IBUTTON_RW2004 ) tag = &rw2004;
+      bus.attach( tag );
+      assertEqual( 1, ibutton.writeCode( codeB, detect ? IBUTTON_UNKNOWN : type ) );
+      assertTrue( iButtonTag::equalCode( tag -> rom, codeB ) );
+      removeTags( bus, ibutton );
+    }
+  }
+
+  // Not detectable, supplied type incorrect
+  iButtonSimRW1990 tm01( codeA, IBUTTON_TM01 );
+  bus.attach( &tm01 );
+  assertEqual( -12, ibutton.writeCode( codeB ) );
+  assertEqual( -13, ibutton.writeCode( codeB, IBUTTON_RW1990V2 ) );
+  assertTrue( iButtonTag::equalCode( tm01.rom, codeA ) );
+  removeTags( bus, ibutton );
+
+  // Not written because programming takes longer than expected
+  iButtonSimRW1990 slow( codeA, IBUTTON_RW1990V1 );
+  slow.programUs = 20000;
+  bus.attach( &slow );
+  assertEqual( -21, ibutton.writeCode( codeB ) );
+  assertEqual( 64, slow.missed );
+  removeTags( bus, ibutton );
+
+  iButtonSimRW2004 slow2004( codeA );
+  slow2004.programUs = 60000;
+  bus.attach( &slow2004 );
+  assertEqual( -22, ibutton.writeCode( codeB ) );
+  removeTags( bus, ibutton );
+
+}
+
+unittest( iButtonSim_calibrate ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+  iButtonCode code;
+
+  // Default timing profile
+  assertEqual( 10000, ibutton.writeDelay( IBUTTON_RW1990V1 ) );
+  assertEqual( 50000, ibutton.writeDelay( IBUTTON_RW2004 ) );
+  assertEqual( 0, ibutton.writeDelay( IBUTTON_UNKNOWN ) );
+  assertEqual( -11, ibutton.setWriteDelay( IBUTTON_MAXWRITABLE + 1, 1000 ) );
+
+  // No iButton
+  assertEqual( 0, ibutton.calibrateWriteDelay() );
+
+  // Fast RW1990V1: shortest delay that works plus 50% margin, original kept
+  iButtonSimRW1990 fast( codeA, IBUTTON_RW1990V1 );
+  fast.programUs = 2000;
+  bus.attach( &fast );
+  assertEqual( 1, ibutton.calibrateWriteDelay() );
+  uint32_t wait = ibutton.writeDelay( IBUTTON_RW1990V1 );
+  assertTrue( wait >= 2000 * 3 / 2 );
+  assertTrue( wait < 2100 * 3 / 2 );
+  assertTrue( iButtonTag::equalCode( fast.rom, codeA ) );
+  assertEqual( 10000, ibutton.writeDelay( IBUTTON_RW1990V2 ) ); // Other types
+
+  // Writing with calibrated delay is reliable and much faster
+  fast.missed = 0;
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 1, ibutton.writeCode( codeB ) );
+  assertTrue( iButtonTag::equalCode( fast.rom, codeB ) );
+  assertEqual( 0, fast.missed );
+  assertTrue( iButtonSimBus::now - start < 66 * 10000UL / 2 );
+  bus.clear();
+
+  // Slow tag: calibrated delay is never above the safe default
+  iButtonSimRW1990 slow( codeA, IBUTTON_RW1990V2 );
+  bus.attach( &slow );
+  assertEqual( 1, ibutton.calibrateWriteDelay( IBUTTON_RW1990V2, 50 ) );
+  assertEqual( 10000, ibutton.writeDelay( IBUTTON_RW1990V2 ) );
+  assertTrue( iButtonTag::equalCode( slow.rom, codeA ) );
+  bus.clear();
+
+  // RW2004 program pulse
+  iButtonSimRW2004 rw2004( codeA );
+  bus.attach( &rw2004 );
+  assertEqual( 1, ibutton.calibrateWriteDelay( IBUTTON_RW2004, 20 ) );
+  wait = ibutton.writeDelay( IBUTTON_RW2004 );
+  assertTrue( wait >= 12000 );
+  assertTrue( wait < 13000 );
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  bus.clear();
+
+}
+
+unittest( iButtonSim_beginWrite ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+  iButtonSimRW1990 tag( codeA, IBUTTON_RW1990V2 );
+  bus.attach( &tag );
+
+  // Each poll returns without waiting: at most one step of bus operations, the
+  // longest being the final check with readCode
+  uint32_t start = micros();
+  assertEqual( IBUTTON_BUSY, ibutton.beginWrite( codeC ) );
+  uint32_t polls = 0, longest = 0;
+  uint8_t progress = 0;
+  int8_t status;
+  do {
+    uint32_t before = micros();
+    status = ibutton.pollWrite();
+    if ( micros() - before > longest ) longest = micros() - before;
+    assertTrue( ibutton.writeProgress() >= progress );
+    progress = ibutton.writeProgress();
+    polls++;
+    delayMicroseconds( 100 );                          // Application work
+  } while ( status == IBUTTON_BUSY );
+  assertEqual( 1, status );
+  assertEqual( 100, ibutton.writeProgress() );
+  assertTrue( iButtonTag::equalCode( tag.rom, codeC ) );
+  assertEqual( 1, ibutton.pollWrite() );              // Status remains
+  assertTrue( polls > 1000 );
+  assertTrue( longest < SIM_RESET_US + 72 * SIM_SLOT_US + 10 );
+  assertTrue( micros() - start < 800000UL );
+
+  // Argument errors are returned immediately
+  assertEqual( -11, ibutton.beginWrite( codeC, IBUTTON_MAXWRITABLE + 1 ) );
+  iButtonCode bad = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+  assertEqual( -1, ibutton.beginWrite( bad ) );
+
+  bus.clear();
+
+}
+
+unittest_main()
@@ -0,0 +1,123 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonTagGroup.h>
+#include "iButtonSim.h"
+#include "iButtonSimGroup.h"
+
+// Pins of simulated buses, one per probe
+static const uint8_t pins[IBUTTON_GROUP_MAX] = { 30, 31, 32, 33, 34, 35, 36, 37 };
+
+// Codes of simulated tags, one per probe
+static uint8_t codes[IBUTTON_GROUP_MAX][8];
+
+static void makeCodes() {
+  for ( uint8_t t = 0; t < IBUTTON_GROUP_MAX; t++ ) {
+    codes[t][0] = 0x01;
+    for ( uint8_t i = 1; i < 7; i++ ) codes[t][i] = ( t * 37 + i * 11 ) & 0xFF;
+    iButtonTag::updateChecksum( codes[t] );
+  }
+  codes[7][7] ^= 0xFF;                                // Checksum fails
+}
+
+unittest( iButtonTagGroup_parallel ) {
+
+  makeCodes();
+  iButtonSimDevice* tags[IBUTTON_GROUP_MAX];
+  for ( uint8_t t = 0; t < IBUTTON_GROUP_MAX; t++ ) {
+    tags[t] = new iButtonSimDevice( codes[t] );
+    iButtonSimBus::onPin( pins[t] ).clear();
+    if ( t != 5 ) iButtonSimBus::onPin( pins[t] ).attach( tags[t] );  // Probe 5 empty
+    iButtonSimBus::onPin( pins[t] ).resetCounters();
+  }
+  tags[6] -> glitches = 1;                            // Sliding, reads zeros
+
+  iButtonSimGroup wire( pins, IBUTTON_GROUP_MAX );
+  iButtonTagGroup group( wire, IBUTTON_GROUP_MAX );
+  assertEqual( IBUTTON_GROUP_MAX, group.count() );
+  iButtonCode read[IBUTTON_GROUP_MAX];
+  int8_t status[IBUTTON_GROUP_MAX];
+  memset( read, 0xAA, sizeof( read ) );
+
+  // All probes in one reset and one set of time slots, codes checked
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 5, group.readCode( read, status ) );
+  uint32_t groupTime = iButtonSimBus::now - start;
+  for ( uint8_t t = 0; t < 5; t++ ) {
+    assertEqual( 1, status[t] );
+    assertTrue( iButtonTag::equalCode( read[t], codes[t] ) );
+  }
+  assertEqual( 0, status[5] );
+  assertEqual( 0xAA, read[5][0] );                    // Unchanged
+  assertEqual( -2, status[6] );
+  assertEqual( -1, status[7] );
+  for ( uint8_t t = 0; t < IBUTTON_GROUP_MAX; t++ ) {
+    assertEqual( 1, iButtonSimBus::onPin( pins[t] ).resets );
+    assertEqual( 72, iButtonSimBus::onPin( pins[t] ).slots );
+  }
+  assertEqual( SIM_RESET_US + 72 * SIM_SLOT_US, groupTime );
+
+  // As long as reading a single probe
+  iButtonTag single( pins[0] );
+  iButtonCode code;
+  start = iButtonSimBus::now;
+  assertEqual( 1, single.readCode( code ) );
+  assertTrue( groupTime <= iButtonSimBus::now - start );
+
+  // DS1990 compatible READ ROM
+  tags[0] -> legacy = true;
+  assertEqual( 6, group.readCode( read, status, true ) );
+  assertEqual( 1, status[0] );
+  tags[0] -> legacy = false;
+
+  // Nothing present: a single reset
+  for ( uint8_t t = 0; t < IBUTTON_GROUP_MAX; t++ ) tags[t] -> touching = false;
+  iButtonSimBus::onPin( pins[0] ).resetCounters();
+  assertEqual( 0, group.readCode( read, status ) );
+  assertEqual( 0, status[0] );
+  assertEqual( 1, iButtonSimBus::onPin( pins[0] ).resets );
+  assertEqual( 0, iButtonSimBus::onPin( pins[0] ).slots );
+
+  for ( uint8_t t = 0; t < IBUTTON_GROUP_MAX; t++ ) {
+    iButtonSimBus::onPin( pins[t] ).clear();
+    delete tags[t];
+  }
+
+}
+
+unittest( iButtonTagGroup_pins ) {
+
+  makeCodes();
+  iButtonSimDevice* tags[3];
+  for ( uint8_t t = 0; t < 3; t++ ) {
+    tags[t] = new iButtonSimDevice( codes[t] );
+    iButtonSimBus::onPin( pins[t] ).clear();
+    iButtonSimBus::onPin( pins[t] ).attach( tags[t] );
+  }
+
+  // Pins of the simulator are not on a port: one pin after the other
+  iButtonTagGroup group( pins, 3 );
+  iButtonPinGroupBus wire( pins, 3 );
+  assertFalse( wire.parallel() );
+  assertEqual( 3, group.count() );
+  iButtonCode read[3];
+  int8_t status[3];
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 3, group.readCode( read, status ) );
+  for ( uint8_t t = 0; t < 3; t++ ) {
+    assertEqual( 1, status[t] );
+    assertTrue( iButtonTag::equalCode( read[t], codes[t] ) );
+  }
+  assertTrue( iButtonSimBus::now - start >= 3 * ( SIM_RESET_US + 72 * SIM_SLOT_US ) );
+
+  for ( uint8_t t = 0; t < 3; t++ ) {
+    iButtonSimBus::onPin( pins[t] ).clear();
+    delete tags[t];
+  }
+
+}
+
+unittest_main()
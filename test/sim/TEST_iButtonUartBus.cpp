@@ -0,0 +1,132 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonTag.h>
+#include <iButtonUartBus.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 4
+
+// Codes of simulated tags
+static const uint8_t codeA[8] = { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C };
+static const uint8_t codeB[8] = { 0x01, 0x1A, 0x3C, 0x09, 0x12, 0x00, 0x00, 0x9A };
+static const uint8_t codeC[8] = { 0x01, 0xB2, 0x44, 0x71, 0x0E, 0x00, 0x00, 0x71 };
+
+// Removes all tags from the probe, taking the time a person would need
+void removeTags( iButtonSimBus& bus ) {
+  bus.clear();
+  delay( 500 );
+}
+
+unittest( iButtonUartBus_read ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice tag( codeA );
+  bus.attach( &tag );
+  iButtonSimUart uart( PIN_SIM );
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+  iButtonCode code;
+
+  // Function readCode, 1 reset and 8 + 64 slots, one frame each
+  bus.resetCounters();
+  uint32_t start = iButtonSimBus::now;
+  assertEqual( 1, ibutton.readCode( code ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 1, bus.resets );
+  assertEqual( 72, bus.slots );
+  assertEqual( 2, uart.baudChanges );
+  uint32_t busTime = SIM_UART_RESET_US + 72 * SIM_UART_SLOT_US;
+  assertTrue( iButtonSimBus::now - start - busTime <= 100 );
+
+  // Baud rate switches for every reset only
+  assertEqual( 1, ibutton.readCode( code, true ) );
+  assertTrue( iButtonTag::equalCode( code, codeA ) );
+  assertEqual( 4, uart.baudChanges );
+
+  // Tag removed from probe
+  tag.touching = false;
+  assertEqual( 0, ibutton.readCode( code ) );
+
+  // Stale byte in the receive buffer, noise on the line: not taken as echo
+  uart.input += (char) 0x00;
+  assertEqual( 0, ibutton.checkPresence() );
+
+  // Two tags collide on READ ROM
+  tag.touching = true;
+  iButtonSimDevice other( codeB );
+  bus.attach( &other );
+  assertEqual( -1, ibutton.readCode( code ) );
+
+  // Serial port not connected to the data line: no echo, no presence
+  uart.connected = false;
+  assertEqual( 0, ibutton.readCode( code ) );
+  assertEqual( 0, ibutton.checkPresence() );
+
+  bus.clear();
+
+}
+
+unittest( iButtonUartBus_search ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimDevice tagA( codeA ), tagB( codeB ), tagC( codeC );
+  bus.attach( &tagA );
+  bus.attach( &tagB );
+  bus.attach( &tagC );
+  iButtonSimUart uart( PIN_SIM );
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+  iButtonCode code;
+
+  // Functions readCodes and nextCode, search of iButtonBus finds all codes
+  assertEqual( 1, ibutton.readCodes() );
+  uint8_t found = 0;
+  while ( ibutton.nextCode( code ) == 1 ) {
+    if ( iButtonTag::equalCode( code, codeA ) ) found |= 1;
+    if ( iButtonTag::equalCode( code, codeB ) ) found |= 2;
+    if ( iButtonTag::equalCode( code, codeC ) ) found |= 4;
+  }
+  assertEqual( 7, found );
+
+  // Function verifyPresent
+  assertEqual( 1, ibutton.verifyPresent( codeB ) );
+  bus.detach( &tagB );
+  assertEqual( 0, ibutton.verifyPresent( codeB ) );
+
+  bus.clear();
+
+}
+
+unittest( iButtonUartBus_write ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonSimUart uart( PIN_SIM );
+  iButtonUartBus wire( uart );
+  iButtonTag ibutton( wire );
+
+  // Every writable type, with detection and with supplied type
+  for ( int8_t type = IBUTTON_RW1990V1; type <= IBUTTON_MAXWRITABLE; type++ ) {
+    for ( uint8_t detect = 0; detect < 2; detect++ ) {
+      if ( detect && type == IBUTTON_TM01 ) continue;
+      iButtonSimRW1990 rw1990( codeA, type );
+      iButtonSimRW2004 rw2004( codeA );
+      iButtonSimDevice* tag = &rw1990;
+      if ( type == IBUTTON_RW2004 ) tag = &rw2004;
+      bus.attach( tag );
+      assertEqual( 1, ibutton.writeCode( codeB, detect ? IBUTTON_UNKNOWN : type ) );
+      assertTrue( iButtonTag::equalCode( tag -> rom, codeB ) );
+      removeTags( bus );
+    }
+  }
+
+}
+
+unittest_main()
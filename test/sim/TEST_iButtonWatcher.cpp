@@ -0,0 +1,126 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include <ArduinoUnitTests.h>
+#include <iButtonWatcher.h>
+#include "iButtonSim.h"
+
+// Pin of simulated bus
+#define PIN_SIM 2
+
+// Code of simulated tag
+static const uint8_t codeA[8] = { 0x01, 0x5F, 0x94, 0xC5, 0x01, 0x00, 0x00, 0x8C };
+
+// Events received
+static uint8_t arrived, departed, invalid;
+static int8_t lastStatus;
+
+static void handleArrive( const uint8_t* code, int8_t status ) {
+  if ( iButtonTag::equalCode( code, codeA ) ) arrived++;
+  lastStatus = status;
+}
+static void handleDepart( const uint8_t*, int8_t ) { departed++; }
+static void handleInvalid( const uint8_t*, int8_t status ) {
+  invalid++;
+  lastStatus = status;
+}
+
+// Tag sliding on the probe: every other READ ROM answered with all zeros
+class iButtonSimSliding : public iButtonSimDevice {
+  public:
+    iButtonSimSliding( const uint8_t* code ) : iButtonSimDevice( code ) {}
+  protected:
+    bool onReset() {
+      glitches = reads % 2 == 0 ? 1 : 0;
+      return iButtonSimDevice::onReset();
+    }
+};
+
+// Polls the watcher for some time
+static void run( iButtonWatcher& watcher, uint16_t ms ) {
+  uint32_t end = millis() + ms;
+  while ( (int32_t) ( millis() - end ) < 0 ) {
+    watcher.poll();
+    delayMicroseconds( 500 );
+  }
+}
+
+unittest( iButtonWatcher_events ) {
+
+  iButtonSimBus& bus = iButtonSimBus::onPin( PIN_SIM );
+  bus.clear();
+  iButtonTag ibutton( PIN_SIM );
+  iButtonWatcher watcher( ibutton, 3, 10 );
+  watcher.onArrive( handleArrive );
+  watcher.onDepart( handleDepart );
+  watcher.onInvalid( handleInvalid );
+  arrived = departed = invalid = 0;
+
+  // Nothing on the probe: reset-only checks, no slots
+  bus.resetCounters();
+  run( watcher, 100 );
+  assertEqual( 0, bus.slots );
+  assertTrue( bus.resets >= 9 );
+  assertFalse( watcher.isPresent() );
+
+  // Tag sliding onto the probe, exactly one arrival after consensus
+  iButtonSimDevice tag( codeA );
+  tag.glitches = 2;
+  bus.attach( &tag );
+  run( watcher, 200 );
+  assertEqual( 1, arrived );
+  assertEqual( 0, invalid );
+  assertEqual( 1, lastStatus );
+  assertEqual( 5, tag.reads );                        // 2 glitches + 3 agreeing
+  assertTrue( watcher.isPresent() );
+  assertTrue( iButtonTag::equalCode( watcher.code(), codeA ) );
+
+  // Tag stays on the probe: reset-only checks, no more reads
+  run( watcher, 200 );
+  assertEqual( 5, tag.reads );
+  assertEqual( 1, arrived );
+
+  // Short loss of contact is ignored
+  tag.touching = false;
+  run( watcher, 15 );
+  tag.touching = true;
+  run( watcher, 100 );
+  assertEqual( 0, departed );
+  assertEqual( 1, arrived );
+
+  // Tag taken off the probe, exactly one departure
+  bus.detach( &tag );
+  run( watcher, 100 );
+  assertEqual( 1, departed );
+  assertFalse( watcher.isPresent() );
+
+  // Tag giving invalid codes only, exactly one invalid event
+  tag.reads = 0;
+  tag.glitches = 100;
+  bus.attach( &tag );
+  run( watcher, 300 );
+  assertEqual( 1, invalid );
+  assertEqual( -2, lastStatus );
+  assertEqual( 3, tag.reads );
+  assertEqual( 1, arrived );
+  bus.detach( &tag );
+  run( watcher, 100 );
+  assertEqual( 1, departed );                         // Never arrived
+
+  // Invalid and valid reads alternating, more invalid ones than the window in
+  // total: the valid reads still agree, one arrival
+  iButtonSimSliding sliding( codeA );
+  bus.attach( &sliding );
+  run( watcher, 300 );
+  assertEqual( 2, arrived );
+  assertEqual( 1, invalid );
+  assertEqual( 6, sliding.reads );                    // 3 glitches + 3 agreeing
+  bus.detach( &sliding );
+  run( watcher, 100 );
+  assertEqual( 2, departed );
+
+}
+
+unittest_main()
@@ -0,0 +1,530 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+#include "iButtonSim.h"
+#include <stdio.h>
+#include <algorithm>
+
+// Type constants, same values as in library
+#define IBUTTON_RW1990V1 1
+#define IBUTTON_RW1990V2 2
+
+
+// ARDUINO CORE STAND-IN
+
+HardwareSerial Serial;
+
+// Reading the time takes time too, so busy-waiting loops on micros() or millis()
+// come to an end
+unsigned long millis() { iButtonSimBus::advance( 1 ); return iButtonSimBus::now / 1000; }
+unsigned long micros() { iButtonSimBus::advance( 1 ); return iButtonSimBus::now; }
+void delay( unsigned long ms ) { iButtonSimBus::advance( ms * 1000 ); }
+void delayMicroseconds( unsigned int us ) { iButtonSimBus::advance( us ); }
+
+size_t Print::print( const char* s ) { return write( s ); }
+size_t Print::print( char c ) { return write( (uint8_t) c ); }
+size_t Print::print( unsigned long n, int base ) {
+  char buffer[24];
+  snprintf( buffer, sizeof( buffer ), base == HEX ? "%lX" : "%lu", n );
+  return write( buffer );
+}
+size_t Print::print( long n, int base ) {
+  if ( base == HEX ) return print( (unsigned long) n, base );
+  char buffer[24];
+  snprintf( buffer, sizeof( buffer ), "%ld", n );
+  return write( buffer );
+}
+
+
+// HELPERS
+
+static uint8_t crc8( const uint8_t* data, uint8_t length ) {
+  uint8_t crc = 0;
+  while ( length-- ) {
+    uint8_t b = *data++;
+    for ( uint8_t i = 0; i < 8; i++ ) {
+      uint8_t mix = ( crc ^ b ) & 0x01;
+      crc >>= 1;
+      if ( mix ) crc ^= 0x8C;
+      b >>= 1;
+    }
+  }
+  return crc;
+}
+
+
+// BUS
+
+thread_local uint32_t iButtonSimBus::now = 0;
+
+iButtonSimBus& iButtonSimBus::onPin( uint8_t pin ) {
+  static iButtonSimBus buses[256];
+  return buses[pin];
+}
+
+void iButtonSimBus::attach( iButtonSimDevice* device ) {
+  _devices.push_back( device );
+}
+
+void iButtonSimBus::detach( iButtonSimDevice* device ) {
+  _devices.erase( std::remove( _devices.begin(), _devices.end(), device ),
+                  _devices.end() );
+}
+
+uint8_t iButtonSimBus::reset( bool overdrive ) {
+  resets++;
+  uint8_t presence = 0;
+  for ( iButtonSimDevice* d : _devices ) if ( d -> reset( overdrive ) ) presence = 1;
+  advance( overdrive ? SIM_OD_RESET_US : SIM_RESET_US );
+  return presence;
+}
+
+uint8_t iButtonSimBus::slot( uint8_t bit, bool overdrive ) {
+  slots++;
+  // Wired-AND: the line is low when master or any device pulls it low
+  uint8_t line = bit;
+  for ( iButtonSimDevice* d : _devices ) line &= d -> drive( overdrive );
+  for ( iButtonSimDevice* d : _devices ) d -> sample( line, overdrive );
+  advance( overdrive ? SIM_OD_SLOT_US : SIM_SLOT_US );
+  return line;
+}
+
+
+// PLAIN DEVICE
+
+iButtonSimDevice::iButtonSimDevice( const uint8_t* code ) {
+  memcpy( rom, code, 8 );
+  idle();
+}
+
+bool iButtonSimDevice::onReset() {
+  if ( !touching ) return false;
+  _layer = SIM_ROM;
+  receiveByte();
+  return true;
+}
+
+bool iButtonSimDevice::reset( bool fast ) {
+  onTick();
+  if ( fast != overdrive ) {
+    // Standard speed reset pulse is long enough for any device
+    if ( fast ) return false;
+    overdrive = false;
+  }
+  return onReset();
+}
+
+uint8_t iButtonSimDevice::drive( bool fast ) {
+  onTick();
+  if ( !touching || fast != overdrive ) return 1;
+  switch ( _mode ) {
+    case MODE_SEND:
+      return ( _tx[_txBit >> 3] >> ( _txBit & 7 ) ) & 1;
+    case MODE_SEARCH:
+      if ( _searchSlot == 0 ) return romBit( _romBit );
+      if ( _searchSlot == 1 ) return romBit( _romBit ) ^ 1;
+      return 1;
+    default:
+      return 1;
+  }
+}
+
+void iButtonSimDevice::sample( uint8_t line, bool fast ) {
+  if ( !touching || fast != overdrive ) return;
+  switch ( _mode ) {
+    case MODE_BYTE:
+      _shift |= line << _count;
+      if ( ++_count == 8 ) {
+        _mode = MODE_IDLE;
+        onByte( _shift );
+      }
+      break;
+    case MODE_BIT:
+      _mode = MODE_IDLE;
+      onBit( line );
+      break;
+    case MODE_SEND:
+      if ( ++_txBit == _tx.size() * 8 ) {
+        _mode = MODE_IDLE;
+        onSent();
+      }
+      break;
+    case MODE_SEARCH:
+      if ( _searchSlot++ < 2 ) break;
+      _searchSlot = 0;
+      // Master writes direction, devices with other bit value drop out
+      if ( line != romBit( _romBit ) ) {
+        idle();
+      } else if ( ++_romBit == 64 ) {
+        _layer = SIM_FUNCTION;
+        receiveByte();
+      }
+      break;
+    case MODE_MATCH:
+      if ( line != romBit( _romBit ) ) {
+        idle();
+      } else if ( ++_romBit == 64 ) {
+        _layer = SIM_FUNCTION;
+        receiveByte();
+      }
+      break;
+  }
+}
+
+void iButtonSimDevice::onByte( uint8_t b ) {
+  if ( _layer == SIM_FUNCTION ) {
+    onFunction( b );
+    return;
+  }
+  switch ( b ) {
+    case 0x33: // READ ROM
+    case 0x0F: // READ ROM, DS1990 compatible
+      if ( legacy && b == 0x33 ) {
+        onCommand( b );
+        break;
+      }
+      reads++;
+      if ( glitches > 0 ) {
+        static const uint8_t zeros[8] = { 0 };
+        glitches--;
+        send( zeros, 8 );
+      } else {
+        send( rom, 8 );
+      }
+      break;
+    case 0xF0: // SEARCH ROM
+      _mode = MODE_SEARCH;
+      _romBit = 0;
+      _searchSlot = 0;
+      break;
+    case 0x55: // MATCH ROM
+      _mode = MODE_MATCH;
+      _romBit = 0;
+      break;
+    case 0xCC: // SKIP ROM
+      _layer = SIM_FUNCTION;
+      receiveByte();
+      break;
+    case 0x3C: // OVERDRIVE SKIP ROM
+      if ( !overdriveCapable ) {
+        onCommand( b );
+        break;
+      }
+      overdrive = true;
+      _layer = SIM_FUNCTION;
+      receiveByte();
+      break;
+    case 0x69: // OVERDRIVE MATCH ROM, code at overdrive speed
+      if ( !overdriveCapable ) {
+        onCommand( b );
+        break;
+      }
+      overdrive = true;
+      _mode = MODE_MATCH;
+      _romBit = 0;
+      break;
+    default:
+      onCommand( b );
+  }
+}
+
+void iButtonSimDevice::send( const uint8_t* data, uint16_t length ) {
+  _tx.assign( data, data + length );
+  _txBit = 0;
+  _mode = MODE_SEND;
+}
+
+
+// WRITABLE RW1990V1, RW1990V2, TM01
+
+iButtonSimRW1990::iButtonSimRW1990( const uint8_t* code, int8_t type )
+  : iButtonSimDevice( code ) {
+  _type = type;
+  _pending = false;
+  flag = type == IBUTTON_RW1990V1 ? 1 : 0; // Writing disabled
+}
+
+bool iButtonSimRW1990::enabled() const {
+  return _type == IBUTTON_RW1990V1 ? flag == 0 : flag == 1;
+}
+
+void iButtonSimRW1990::onTick() {
+  // Bit is programmed if the line stayed high long enough after it
+  if ( !_pending ) return;
+  _pending = false;
+  if ( iButtonSimBus::now - _pendingTime < programUs ) {
+    missed++;
+    return;
+  }
+  uint8_t i = _index - 1;
+  if ( _pendingBit ) rom[i >> 3] |= 1 << ( i & 7 );
+  else rom[i >> 3] &= ~( 1 << ( i & 7 ) );
+}
+
+void iButtonSimRW1990::onCommand( uint8_t command ) {
+  uint8_t enable = _type == IBUTTON_RW1990V1 ? 0xD1
+                 : _type == IBUTTON_RW1990V2 ? 0x1D : 0xC1;
+  uint8_t read = _type == IBUTTON_RW1990V1 ? 0xB5
+               : _type == IBUTTON_RW1990V2 ? 0x1E : 0x00;
+  _layer = SIM_CUSTOM;
+  _command = command;
+  if ( command == enable ) {
+    receiveBit();
+  } else if ( command == read && read != 0x00 ) {
+    flagReads++;
+    sendByte( flag ? 0xFE : 0xFF );
+  } else if ( command == 0xD5 ) {
+    _index = 0;
+    receiveBit();
+  } else {
+    idle();
+  }
+}
+
+void iButtonSimRW1990::onBit( uint8_t b ) {
+  if ( _command != 0xD5 ) { // Write flag
+    flag = b;
+    idle();
+    return;
+  }
+  _index++;
+  if ( enabled() ) {
+    _pending = true;
+    _pendingBit = _type == IBUTTON_RW1990V1 ? b ^ 1 : b;
+    _pendingTime = iButtonSimBus::now + SIM_SLOT_US;
+  }
+  if ( _index < 64 ) receiveBit();
+  else idle();
+}
+
+
+// WRITABLE RW2004
+
+// Stages of RW2004 commands
+#define STAGE_ADDRESS 0
+#define STAGE_DATA    2
+#define STAGE_CRC     3
+#define STAGE_PULSE   4
+#define STAGE_PROGRAM 5
+#define STAGE_CONFIRM 6
+#define STAGE_STATUS  7
+
+iButtonSimRW2004::iButtonSimRW2004( const uint8_t* code )
+  : iButtonSimDevice( code ) {
+  _stage = STAGE_ADDRESS;
+}
+
+void iButtonSimRW2004::onTick() {
+  // Programmed byte is sent when the master reads after the program pulse
+  if ( _stage != STAGE_PROGRAM ) return;
+  _stage = STAGE_CONFIRM;
+  if ( iButtonSimBus::now - _pulseTime < programUs ) missed++;
+  else if ( _address < 8 ) rom[_address] = _data;
+  sendByte( _address < 8 ? rom[_address] : 0xFF );
+}
+
+void iButtonSimRW2004::onCommand( uint8_t command ) {
+  if ( command != 0xAA && command != 0x3C ) {
+    idle();
+    return;
+  }
+  _layer = SIM_CUSTOM;
+  _command = command;
+  _stage = STAGE_ADDRESS;
+  _seq[0] = command;
+  _length = 1;
+  receiveByte();
+}
+
+void iButtonSimRW2004::onByte( uint8_t b ) {
+  if ( _layer != SIM_CUSTOM ) {
+    iButtonSimDevice::onByte( b );
+    return;
+  }
+  if ( _stage < STAGE_DATA ) {               // Address bytes
+    _seq[_length++] = b;
+    if ( ++_stage < STAGE_DATA ) {
+      receiveByte();
+      return;
+    }
+    _address = _seq[1];
+    if ( _command == 0xAA ) {                // CRC8, then status byte
+      uint8_t response[2] = { crc8( _seq, 3 ), 0x00 };
+      _stage = STAGE_STATUS;
+      send( response, 2 );
+    } else {
+      receiveByte();
+    }
+    return;
+  }
+  // Data byte, respond with CRC8
+  _data = b;
+  _seq[_length++] = b;
+  uint8_t crc = crc8( _seq, _length );
+  _seq[0] = _address + 1;
+  _length = 1;
+  _stage = STAGE_CRC;
+  sendByte( crc );
+}
+
+void iButtonSimRW2004::onBit( uint8_t ) {
+  // Program pulse, the programmed byte is decided on the next read
+  _pulseTime = iButtonSimBus::now + SIM_SLOT_US;
+  _stage = STAGE_PROGRAM;
+  sendByte( 0xFF );
+}
+
+void iButtonSimRW2004::onSent() {
+  switch ( _stage ) {
+    case STAGE_CRC:
+      _stage = STAGE_PULSE;
+      receiveBit();
+      break;
+    case STAGE_CONFIRM:
+      _address++;
+      _stage = STAGE_DATA;
+      receiveByte();
+      break;
+    default:
+      idle();
+  }
+}
+
+
+// MEMORY
+
+iButtonSimMemory::iButtonSimMemory( const uint8_t* code, uint16_t size, bool eprom )
+  : iButtonSimDevice( code ), memory( size, 0xFF ) {
+  _eprom = eprom;
+  memset( scratchpad, 0xFF, sizeof( scratchpad ) );
+  target[0] = target[1] = 0;
+  ending = 0;
+}
+
+void iButtonSimMemory::onFunction( uint8_t command ) {
+  bool known = _eprom ? command == 0xF0 || command == 0xC3
+                      : command == 0x0F || command == 0xAA || command == 0x55 ||
+                        command == 0xF0;
+  if ( !known ) {
+    idle();
+    return;
+  }
+  _layer = SIM_CUSTOM;
+  _command = command;
+  _stage = 0;
+  if ( command == 0xAA ) {                   // READ SCRATCHPAD
+    std::vector<uint8_t> response = { target[0], target[1], ending };
+    response.insert( response.end(), scratchpad + ( target[0] & 0x1F ), scratchpad + 32 );
+    send( response.data(), response.size() );
+    return;
+  }
+  receiveByte();
+}
+
+void iButtonSimMemory::onByte( uint8_t b ) {
+  if ( _layer != SIM_CUSTOM ) {
+    iButtonSimDevice::onByte( b );
+    return;
+  }
+  if ( _command == 0x55 ) {                  // COPY SCRATCHPAD, authorization
+    _received[_stage++] = b;
+    if ( _stage < 3 ) {
+      receiveByte();
+      return;
+    }
+    if ( _received[0] == target[0] && _received[1] == target[1] &&
+         _received[2] == ending ) {
+      uint16_t page = ( target[0] | target[1] << 8 ) & ~0x1F;
+      for ( uint8_t i = target[0] & 0x1F; i <= ( ending & 0x1F ); i++ ) {
+        if ( page + i < memory.size() ) memory[page + i] = scratchpad[i];
+      }
+      ending |= 0x80;
+      copies++;
+    }
+    idle();
+    return;
+  }
+  if ( _stage < 2 ) {                        // Address bytes
+    _received[_stage++] = b;
+    if ( _stage < 2 ) {
+      receiveByte();
+    } else if ( _command == 0x0F ) {         // WRITE SCRATCHPAD, data follows
+      target[0] = _received[0];
+      target[1] = _received[1];
+      ending = target[0] & 0x1F;
+      receiveByte();
+    } else {
+      sendMemory( _received[0] | _received[1] << 8 );
+    }
+    return;
+  }
+  // WRITE SCRATCHPAD, data byte: written up to end of scratchpad
+  uint8_t offset = ( target[0] & 0x1F ) + ( _stage++ - 2 );
+  if ( offset < 32 ) {
+    scratchpad[offset] = b;
+    ending = offset;
+  }
+  receiveByte();
+}
+
+void iButtonSimMemory::sendMemory( uint16_t address ) {
+  std::vector<uint8_t> response;
+  if ( _eprom ) {                            // CRC8 of command and address
+    uint8_t sent[3] = { _command, _received[0], _received[1] };
+    response.push_back( crc8( sent, 3 ) );
+  }
+  for ( uint16_t i = address; i < memory.size(); i++ ) {
+    response.push_back( memory[i] );
+    if ( _command == 0xC3 && ( ( i + 1 ) & 0x1F ) == 0 ) {
+      // CRC8 of data from start of this read or page up to end of page
+      uint16_t first = i - ( i & 0x1F ) > address ? i - ( i & 0x1F ) : address;
+      uint8_t crc = crc8( &memory[first], i + 1 - first );
+      if ( corrupt > 0 ) {
+        corrupt--;
+        crc ^= 0x01;
+      }
+      response.push_back( crc );
+    }
+  }
+  send( response.data(), response.size() );
+}
+
+
+// SERIAL PORT ON DATA LINE
+
+iButtonSimUart::iButtonSimUart( uint8_t pin ) : _bus( iButtonSimBus::onPin( pin ) ) {
+}
+
+void iButtonSimUart::begin( unsigned long baud ) {
+  if ( baud != this -> baud ) baudChanges++;
+  HardwareSerial::begin( baud );
+}
+
+size_t iButtonSimUart::write( uint8_t c ) {
+  if ( !connected ) return 1;
+  if ( baud == 115200 && c == 0xE0 ) {
+    // Start bit and 5 bits low: reset pulse at overdrive speed, the frame
+    // ends within the time of the reset
+    uint8_t presence = _bus.reset( true );
+    input += (char) ( presence ? 0x80 : c );
+  } else if ( baud == 1000000 ) {
+    uint8_t line = _bus.slot( c == 0xFF ? 1 : 0, true );
+    iButtonSimBus::advance( SIM_UART_OD_US - SIM_OD_SLOT_US );
+    input += (char) ( c == 0xFF && line == 0 ? 0xFE : c );
+  } else if ( baud == 9600 ) {
+    // Low for start bit and low bits of frame: reset pulse when long enough,
+    // devices asserting presence pull the high bits low
+    uint8_t presence = c == 0xF0 ? _bus.reset() : 0;
+    iButtonSimBus::advance( SIM_UART_RESET_US - SIM_RESET_US );
+    input += (char) ( presence ? 0xE0 : c );
+  } else {
+    // Frame 0xFF is a write-1 or read slot, anything else keeps the line low
+    // long enough for a write-0 slot
+    uint8_t line = _bus.slot( c == 0xFF ? 1 : 0 );
+    iButtonSimBus::advance( SIM_UART_SLOT_US - SIM_SLOT_US );
+    input += (char) ( c == 0xFF && line == 0 ? 0xFE : c );
+  }
+  return 1;
+}
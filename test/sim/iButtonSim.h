@@ -0,0 +1,281 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Simulated 1-Wire bus with iButton devices, for testing the library on Linux
+ * without hardware.
+ *
+ * The bus works on the level of time slots: every reset and every time slot is
+ * offered to all attached devices, which drive the data line like real devices
+ * do (wired-AND). Time is virtual and advances with every bus operation and
+ * every delay, so bus time of library functions can be measured exactly.
+ */
+
+
+#ifndef iButtonSim_h
+#define iButtonSim_h
+
+// Includes
+#include <Arduino.h>
+#include <vector>
+#include <atomic>
+
+// Timing of bus operations at standard speed, in microseconds
+#define SIM_RESET_US 960 // Reset pulse plus presence detect
+#define SIM_SLOT_US   70 // One time slot, read or write
+
+// Timing of bus operations at overdrive speed, in microseconds
+#define SIM_OD_RESET_US 122
+#define SIM_OD_SLOT_US   10
+
+// Length of one UART frame of 10 bits, in microseconds
+#define SIM_UART_RESET_US 1042 // At 9600 baud
+#define SIM_UART_SLOT_US    87 // At 115200 baud
+#define SIM_UART_OD_US      10 // At 1000000 baud
+
+// Device state: layer of the protocol the device is in
+#define SIM_IDLE     0   // Waiting for reset
+#define SIM_ROM      1   // Receiving ROM command
+#define SIM_FUNCTION 2   // Selected, receiving function command
+#define SIM_CUSTOM   3   // In device specific command
+
+class iButtonSimDevice;
+
+// Class definition, simulated bus
+class iButtonSimBus {
+
+  public:
+    // Bus on a pin, created on first use
+    static iButtonSimBus& onPin( uint8_t );
+
+    // Devices
+    void attach( iButtonSimDevice* );
+    void detach( iButtonSimDevice* );
+    void clear() { _devices.clear(); }
+
+    // Bus operations, as driven by the master at standard or overdrive speed
+    uint8_t reset( bool = false );
+    uint8_t slot( uint8_t, bool = false );
+
+    // Statistics
+    void resetCounters() { resets = 0; slots = 0; }
+    uint32_t resets = 0;
+    uint32_t slots = 0;
+
+    // Virtual time, in microseconds, of every thread of its own: a thread using
+    // a bus has a time line for it
+    static thread_local uint32_t now;
+    static void advance( uint32_t us ) { now += us; }
+
+  private:
+    std::vector<iButtonSimDevice*> _devices;
+
+};
+
+// Class definition, plain iButton like DS1990A: ROM commands only
+class iButtonSimDevice {
+
+  public:
+    iButtonSimDevice( const uint8_t* );
+    virtual ~iButtonSimDevice() {}
+
+    // Bus events, ignored by a device at the other speed. A reset at standard
+    // speed returns the device to standard speed.
+    bool reset( bool );
+    uint8_t drive( bool );
+    void sample( uint8_t, bool );
+
+    // Identification code, changes when written
+    uint8_t rom[8];
+
+    // Tag touches the probe, a detached tag doesn't respond at all. Atomic, so
+    // a test can move tags while a reader thread uses the bus.
+    std::atomic<bool> touching{ true };
+
+    // Supports overdrive speed, and is at overdrive speed
+    bool overdriveCapable = false;
+    bool overdrive = false;
+
+    // Number of READ ROM commands served
+    uint32_t reads = 0;
+
+    // Number of next READ ROM commands answered with all zeros, like a tag
+    // sliding on the probe
+    uint8_t glitches = 0;
+
+    // Answers READ ROM 0x0F only, like a DS1990
+    bool legacy = false;
+
+  protected:
+    // Called before every bus event, for time dependent behaviour
+    virtual void onTick() {}
+
+    // Protocol handling, called on reset, when a byte or bit is received or
+    // when all queued bits are sent
+    virtual bool onReset();
+    virtual void onByte( uint8_t );
+    virtual void onBit( uint8_t ) {}
+    virtual void onSent() { idle(); }
+    virtual void onCommand( uint8_t ) { idle(); } // Unknown ROM command
+    virtual void onFunction( uint8_t ) { idle(); }
+
+    // Actions for protocol handling
+    void idle() { _layer = SIM_IDLE; _mode = MODE_IDLE; }
+    void receiveByte() { _mode = MODE_BYTE; _count = 0; _shift = 0; }
+    void receiveBit() { _mode = MODE_BIT; }
+    void send( const uint8_t*, uint16_t );
+    void sendByte( uint8_t b ) { send( &b, 1 ); }
+
+    uint8_t _layer;
+
+  private:
+    // Slot handling modes
+    enum { MODE_IDLE, MODE_BYTE, MODE_BIT, MODE_SEND, MODE_SEARCH, MODE_MATCH };
+    uint8_t _mode;
+
+    // Receiving
+    uint8_t _count;
+    uint8_t _shift;
+
+    // Sending
+    std::vector<uint8_t> _tx;
+    size_t _txBit;
+
+    // SEARCH ROM and MATCH ROM
+    uint8_t _romBit;
+    uint8_t _searchSlot;
+
+    uint8_t romBit( uint8_t i ) const { return ( rom[i >> 3] >> ( i & 7 ) ) & 1; }
+
+};
+
+// Class definition, (re)writable tag with flag and 0xD5 write command: types
+// RW1990V1, RW1990V2 and TM01
+class iButtonSimRW1990 : public iButtonSimDevice {
+
+  public:
+    // Type constant of library, IBUTTON_RW1990V1, IBUTTON_RW1990V2 or
+    // IBUTTON_TM01
+    iButtonSimRW1990( const uint8_t*, int8_t );
+
+    // Minimum time the data line stays high after a bit to program it
+    uint32_t programUs = 8000;
+
+    // Number of bits not programmed because time was too short
+    uint32_t missed = 0;
+
+    // Write flag as last set
+    uint8_t flag;
+
+    // Number of read flag commands answered, as used to probe the type
+    uint32_t flagReads = 0;
+
+  protected:
+    void onTick() override;
+    void onCommand( uint8_t ) override;
+    void onBit( uint8_t ) override;
+
+  private:
+    int8_t _type;
+    uint8_t _command;
+    uint8_t _index;
+    bool _pending;
+    uint8_t _pendingBit;
+    uint32_t _pendingTime;
+
+    bool enabled() const;
+
+};
+
+// Class definition, (re)writable tag type RW2004
+class iButtonSimRW2004 : public iButtonSimDevice {
+
+  public:
+    iButtonSimRW2004( const uint8_t* );
+
+    // Minimum time between program pulse and reading programmed byte
+    uint32_t programUs = 10000;
+
+    // Number of bytes not programmed because time was too short
+    uint32_t missed = 0;
+
+  protected:
+    void onTick() override;
+    void onCommand( uint8_t ) override;
+    void onByte( uint8_t ) override;
+    void onBit( uint8_t ) override;
+    void onSent() override;
+
+  private:
+    uint8_t _command;
+    uint8_t _stage;
+    uint8_t _address;
+    uint8_t _data;
+    uint8_t _seq[4];
+    uint8_t _length;
+    uint32_t _pulseTime;
+
+};
+
+// Class definition, memory iButton: NVRAM with scratchpad like DS1992, DS1993
+// and DS1996, or add-only EPROM like DS1982 (read only)
+class iButtonSimMemory : public iButtonSimDevice {
+
+  public:
+    iButtonSimMemory( const uint8_t*, uint16_t, bool = false );
+
+    // Memory contents
+    std::vector<uint8_t> memory;
+
+    // Scratchpad, target address and ending offset with flags
+    uint8_t scratchpad[32];
+    uint8_t target[2];
+    uint8_t ending;
+
+    // Number of next EPROM pages sent with a wrong CRC8, like a tag sliding
+    // on the probe
+    uint8_t corrupt = 0;
+
+    // Number of copies from scratchpad to memory
+    uint32_t copies = 0;
+
+  protected:
+    void onFunction( uint8_t ) override;
+    void onByte( uint8_t ) override;
+
+  private:
+    bool _eprom;
+    uint8_t _command;
+    uint8_t _stage;
+    uint8_t _received[3];
+
+    void sendMemory( uint16_t );
+
+};
+
+// Class definition, serial port with TX and RX both on the data line of a
+// simulated bus: every frame sent is a reset or time slot, and comes back as
+// echo with the bits devices pulled low
+class iButtonSimUart : public HardwareSerial {
+
+  public:
+    iButtonSimUart( uint8_t );
+
+    size_t write( uint8_t ) override;
+    using Print::write;
+
+    // Serial port not connected to the data line, no echoes
+    bool connected = true;
+
+    // Number of baud rate changes
+    uint32_t baudChanges = 0;
+    void begin( unsigned long ) override;
+
+  private:
+    iButtonSimBus& _bus;
+
+};
+
+#endif // iButtonSim_h
@@ -0,0 +1,59 @@
+// SA van der Wulp    | April 14, 2025
+// Copyright (c) 2025 | MIT License
+// https://vdwulp.github.io/iButtonTag
+
+
+/*
+ * Simulated group backend for iButtonTagGroup: the simulated buses on several
+ * pins driven at the same time, like the pins of one port. Every reset and
+ * time slot goes to all buses, and virtual time advances once.
+ */
+
+
+#ifndef iButtonSimGroup_h
+#define iButtonSimGroup_h
+
+// Includes
+#include <iButtonTagGroup.h>
+#include "iButtonSim.h"
+
+// Class definition
+class iButtonSimGroup : public iButtonGroupBus {
+
+  public:
+    iButtonSimGroup( const uint8_t* pins, uint8_t count ) {
+      for ( uint8_t i = 0; i < count; i++ ) _buses.push_back( &iButtonSimBus::onPin( pins[i] ) );
+    }
+
+    uint8_t reset() override {
+      uint32_t start = iButtonSimBus::now;
+      uint8_t presence = 0;
+      for ( size_t i = 0; i < _buses.size(); i++ ) {
+        if ( _buses[i] -> reset() ) presence |= 1 << i;
+      }
+      iButtonSimBus::now = start + SIM_RESET_US;
+      return presence;
+    }
+
+    void writeBit( uint8_t b ) override {
+      uint32_t start = iButtonSimBus::now;
+      for ( iButtonSimBus* bus : _buses ) bus -> slot( b & 1 );
+      iButtonSimBus::now = start + SIM_SLOT_US;
+    }
+
+    uint8_t readBits() override {
+      uint32_t start = iButtonSimBus::now;
+      uint8_t bits = 0;
+      for ( size_t i = 0; i < _buses.size(); i++ ) {
+        if ( _buses[i] -> slot( 1 ) ) bits |= 1 << i;
+      }
+      iButtonSimBus::now = start + SIM_SLOT_US;
+      return bits;
+    }
+
+  private:
+    std::vector<iButtonSimBus*> _buses;
+
+};
+
+#endif // iButtonSimGroup_h